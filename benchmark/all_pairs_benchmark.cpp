@@ -0,0 +1,61 @@
+#include "gdwg/all_pairs.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+namespace {
+	// Dense-ish random graph: every node has 32 out-edges with pseudo-random weights
+	auto make_dense(int nodes) -> gdwg::csr_graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto state = 17;
+		auto next = [&state] {
+			state = (state * 1103515245 + 12345) & 0x7fffffff;
+			return state;
+		};
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < 32; ++d) {
+				g.insert_edge(i, next() % nodes, next() % 100 + 1);
+			}
+		}
+		return gdwg::csr_graph<int, int>(g);
+	}
+
+	auto const& shared_dense() {
+		static auto const g = make_dense(1024);
+		return g;
+	}
+} // namespace
+
+// Arg is the tile side; 1024 means a single tile, i.e. the unblocked algorithm
+static void floyd_warshall_block(benchmark::State& state) {
+	auto const& g = shared_dense();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(
+		   gdwg::all_pairs_shortest_paths(g, {.block = static_cast<std::size_t>(state.range(0))}));
+	}
+}
+BENCHMARK(floyd_warshall_block)->Arg(16)->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+// Arg(0) is the sequential baseline; compare the others against it for speedup
+static void floyd_warshall_threads(benchmark::State& state) {
+	auto const& g = shared_dense();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::all_pairs_shortest_paths(g, {.pool = &pool}));
+	}
+}
+BENCHMARK(floyd_warshall_threads)
+   ->Arg(0)
+   ->Arg(1)
+   ->Arg(3)
+   ->Arg(7)
+   ->Arg(15)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
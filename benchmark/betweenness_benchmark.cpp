@@ -0,0 +1,62 @@
+#include "gdwg/betweenness.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+namespace {
+	// Random graph with 6 out-edges per node and weights in [1, 10]
+	auto make_random(int nodes) -> gdwg::csr_graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto state = 29U;
+		auto next = [&state] {
+			state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+			return static_cast<int>(state);
+		};
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < 6; ++d) {
+				g.insert_edge(i, next() % nodes, next() % 10 + 1);
+			}
+		}
+		return gdwg::csr_graph<int, int>(g);
+	}
+
+	auto const& shared_random() {
+		static auto const g = make_random(2000);
+		return g;
+	}
+} // namespace
+
+// Exact mode; Arg(0) is the sequential baseline, compare the others against it for speedup
+static void betweenness_threads(benchmark::State& state) {
+	auto const& g = shared_random();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::betweenness_centrality(g, {.pool = &pool}));
+	}
+}
+BENCHMARK(betweenness_threads)->Arg(0)->Arg(1)->Arg(3)->Arg(7)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void betweenness_unweighted(benchmark::State& state) {
+	auto const& g = shared_random();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::betweenness_centrality(g, {.weighted = false}));
+	}
+}
+BENCHMARK(betweenness_unweighted)->Unit(benchmark::kMillisecond);
+
+// Cost falls with the number of sampled sources
+static void betweenness_sampled(benchmark::State& state) {
+	auto const& g = shared_random();
+	auto const samples = static_cast<std::size_t>(state.range(0));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::betweenness_centrality(g, {.samples = samples, .seed = 1}));
+	}
+}
+BENCHMARK(betweenness_sampled)->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
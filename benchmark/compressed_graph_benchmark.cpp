@@ -0,0 +1,76 @@
+#include "gdwg/compressed_graph.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+	constexpr auto nodes = 100000;
+
+	// 100000 nodes with 16 out-edges each, three quarters of them to nearby ids as in a crawl
+	auto const& shared_csr() {
+		static auto const csr = [] {
+			auto g = gdwg::graph<int, float>{};
+			auto state = 43U;
+			auto next = [&state] {
+				state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+				return static_cast<int>(state);
+			};
+			auto values = std::vector<int>();
+			auto edges = std::vector<gdwg::graph<int, float>::value_type>();
+			for (auto i = 0; i < nodes; ++i) {
+				values.push_back(i);
+				for (auto d = 0; d < 16; ++d) {
+					auto const dst = d % 4 == 0 ? next() % nodes : (i + next() % 200) % nodes;
+					edges.push_back({i, dst, static_cast<float>(next() % 1000) / 10});
+				}
+			}
+			g.insert_nodes(values.begin(), values.end());
+			g.insert_edges(edges.begin(), edges.end());
+			return gdwg::csr_graph<int, float>(g);
+		}();
+		return csr;
+	}
+} // namespace
+
+// Baseline: summing every target and weight of the CSR snapshot
+static void scan_csr(benchmark::State& state) {
+	auto const& csr = shared_csr();
+	for (auto _ : state) {
+		auto sum = 0.0;
+		for (auto id = gdwg::node_id{0}; id < csr.node_count(); ++id) {
+			auto const weights = csr.weights(id);
+			auto i = std::size_t{0};
+			for (auto const dst : csr.targets(id)) {
+				sum += dst + static_cast<double>(weights[i++]);
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	auto const bytes = csr.edge_count() * (sizeof(gdwg::node_id) + sizeof(float)) + csr.offsets().size_bytes();
+	state.counters["bytes_per_edge"] = static_cast<double>(bytes) / static_cast<double>(csr.edge_count());
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(csr.edge_count()));
+}
+BENCHMARK(scan_csr)->Unit(benchmark::kMillisecond);
+
+// The same scan decoding rows; argument is weight_bits
+static void scan_compressed(benchmark::State& state) {
+	auto const compressed = gdwg::compressed_graph<int, float>(
+	   shared_csr(),
+	   {.weight_bits = static_cast<unsigned>(state.range(0))});
+	for (auto _ : state) {
+		auto sum = 0.0;
+		for (auto id = gdwg::node_id{0}; id < compressed.node_count(); ++id) {
+			compressed.for_each_edge(id, [&sum](gdwg::node_id dst, float weight) {
+				sum += dst + static_cast<double>(weight);
+			});
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.counters["bytes_per_edge"] = compressed.bytes_per_edge();
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(compressed.edge_count()));
+}
+BENCHMARK(scan_compressed)->Arg(0)->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#include "gdwg/durable_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <filesystem>
+
+namespace {
+	constexpr auto nodes = 20000;
+	constexpr auto edges_per_node = 4;
+
+	auto directory() {
+		return std::filesystem::temp_directory_path() / "gdwg_durable_benchmark";
+	}
+
+	template<typename Graph>
+	auto ingest(Graph& g) -> void {
+		auto state = 43U;
+		auto next = [&state] {
+			state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+			return static_cast<int>(state);
+		};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < edges_per_node; ++d) {
+				g.insert_edge(i, next() % nodes, next() % 10 + 1);
+			}
+		}
+	}
+} // namespace
+
+// Baseline: the same inserts with no log
+static void ingest_in_memory(benchmark::State& state) {
+	for (auto _ : state) {
+		auto g = gdwg::graph<int, int>{};
+		ingest(g);
+		benchmark::DoNotOptimize(g.empty());
+	}
+	state.SetItemsProcessed(state.iterations() * nodes * (edges_per_node + 1));
+}
+BENCHMARK(ingest_in_memory)->Unit(benchmark::kMillisecond);
+
+// Arguments are records per group and whether each group is fsynced
+static void ingest_with_wal(benchmark::State& state) {
+	auto const options = gdwg::durability_options{.group_records = static_cast<std::size_t>(state.range(0)),
+	                                              .sync = state.range(1) != 0,
+	                                              .checkpoint_bytes = 0};
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::filesystem::remove_all(directory());
+		state.ResumeTiming();
+
+		auto g = gdwg::durable_graph<int, int>(directory(), options);
+		ingest(g);
+		g.commit();
+		benchmark::DoNotOptimize(g.wal_bytes());
+	}
+	state.SetItemsProcessed(state.iterations() * nodes * (edges_per_node + 1));
+	std::filesystem::remove_all(directory());
+}
+BENCHMARK(ingest_with_wal)
+   ->Args({1, 0})
+   ->Args({256, 0})
+   ->Args({64, 1})
+   ->Args({1024, 1})
+   ->Unit(benchmark::kMillisecond);
+
+// Recovery from a log alone, then from a checkpoint with an empty log
+static void recover(benchmark::State& state) {
+	std::filesystem::remove_all(directory());
+	{
+		auto g = gdwg::durable_graph<int, int>(directory(), {.sync = false, .checkpoint_bytes = 0});
+		ingest(g);
+		if (state.range(0) != 0) {
+			g.checkpoint();
+		}
+	}
+	for (auto _ : state) {
+		auto const g = gdwg::durable_graph<int, int>(directory());
+		benchmark::DoNotOptimize(g.get().empty());
+	}
+	std::filesystem::remove_all(directory());
+}
+BENCHMARK(recover)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
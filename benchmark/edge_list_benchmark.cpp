@@ -0,0 +1,71 @@
+#include "gdwg/edge_list.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace {
+	// 100000 nodes with 8 out-edges each, written as "src dst weight" lines
+	auto const& shared_file() {
+		static auto const path = [] {
+			auto file = (std::filesystem::temp_directory_path() / "gdwg_edge_list_benchmark.txt").string();
+			auto os = std::ofstream(file, std::ios::binary);
+			auto state = 43U;
+			auto next = [&state] {
+				state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+				return static_cast<int>(state);
+			};
+			for (auto i = 0; i < 100000; ++i) {
+				for (auto d = 0; d < 8; ++d) {
+					os << i << ' ' << next() % 100000 << ' ' << next() % 10 + 1 << '\n';
+				}
+			}
+			return file;
+		}();
+		return path;
+	}
+} // namespace
+
+// The loop every caller writes by hand: read a line, insert_node twice, insert_edge
+static void load_one_by_one(benchmark::State& state) {
+	auto const& path = shared_file();
+	for (auto _ : state) {
+		auto g = gdwg::graph<int, int>{};
+		auto is = std::ifstream(path);
+		auto src = 0;
+		auto dst = 0;
+		auto weight = 0;
+		while (is >> src >> dst >> weight) {
+			g.insert_node(src);
+			g.insert_node(dst);
+			g.insert_edge(src, dst, weight);
+		}
+		benchmark::DoNotOptimize(g.empty());
+	}
+	state.SetBytesProcessed(state.iterations()
+	                        * static_cast<std::int64_t>(std::filesystem::file_size(path)));
+}
+BENCHMARK(load_one_by_one)->Unit(benchmark::kMillisecond);
+
+// Argument is the number of parsing threads; 0 parses on the calling thread
+static void load_edge_list(benchmark::State& state) {
+	auto const& path = shared_file();
+	auto pool = std::optional<gdwg::thread_pool>();
+	if (state.range(0) > 0) {
+		pool.emplace(static_cast<std::size_t>(state.range(0)));
+	}
+	auto const options = gdwg::edge_list_options{.pool = pool ? &*pool : nullptr,
+	                                             .chunk_bytes = std::size_t{1} << 20U};
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::load_edge_list<int, int>(path, options).edges);
+	}
+	state.SetBytesProcessed(state.iterations()
+	                        * static_cast<std::int64_t>(std::filesystem::file_size(path)));
+}
+BENCHMARK(load_edge_list)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond);
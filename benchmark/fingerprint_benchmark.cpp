@@ -0,0 +1,113 @@
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace {
+	constexpr auto nodes = 50000;
+
+	// Two graphs of 50000 nodes and 400000 edges; the second has one more edge, sorting last
+	auto const& shared_pair() {
+		static auto const pair = [] {
+			auto a = gdwg::graph<int, int>{};
+			auto state = 43U;
+			auto next = [&state] {
+				state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+				return static_cast<int>(state);
+			};
+			auto values = std::vector<int>();
+			auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+			for (auto i = 0; i < nodes; ++i) {
+				values.push_back(i);
+				for (auto d = 0; d < 8; ++d) {
+					edges.push_back({i, next() % nodes, next() % 10});
+				}
+			}
+			a.insert_nodes(values.begin(), values.end());
+			a.insert_edges(edges.begin(), edges.end());
+
+			auto b = a;
+			b.insert_edge(nodes - 1, nodes - 1, 100);
+			return std::pair(std::move(a), std::move(b));
+		}();
+		return pair;
+	}
+} // namespace
+
+// What operator== cost before: a walk over the nodes and edges up to the first difference
+static void compare_by_walk(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	auto const same = [](auto const& lhs, auto const& rhs) {
+		return lhs.from == rhs.from and lhs.to == rhs.to and lhs.weight == rhs.weight;
+	};
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.nodes() == b.nodes()
+		                         and std::equal(a.begin(), a.end(), b.begin(), b.end(), same));
+	}
+}
+BENCHMARK(compare_by_walk)->Unit(benchmark::kMillisecond);
+
+static void compare_unequal(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a == b);
+	}
+}
+BENCHMARK(compare_unequal)->Unit(benchmark::kNanosecond);
+
+// Equal graphs still need the full comparison
+static void compare_equal(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a == a);
+	}
+}
+BENCHMARK(compare_equal)->Unit(benchmark::kMillisecond);
+
+// A cache key computed by hashing every node and edge
+static void cache_key_by_walk(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		auto key = std::uint64_t{0};
+		for (auto const& n : a.nodes()) {
+			key = key * 31 + std::hash<int>{}(n);
+		}
+		for (auto const& [from, to, weight] : a) {
+			key = ((key * 31 + std::hash<int>{}(from)) * 31 + std::hash<int>{}(to)) * 31
+			      + std::hash<int>{}(weight);
+		}
+		benchmark::DoNotOptimize(key);
+	}
+}
+BENCHMARK(cache_key_by_walk)->Unit(benchmark::kMillisecond);
+
+static void cache_key_by_fingerprint(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(std::hash<gdwg::graph_fingerprint>{}(a.fingerprint()));
+	}
+}
+BENCHMARK(cache_key_by_fingerprint)->Unit(benchmark::kNanosecond);
+
+// The upkeep: a bulk build, which now hashes each node and edge once
+static void build_with_fingerprint(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	auto values = a.nodes();
+	auto edges = std::vector<gdwg::graph<int, int>::value_type>(a.begin(), a.end());
+	for (auto _ : state) {
+		auto g = gdwg::graph<int, int>{};
+		g.insert_nodes(values.begin(), values.end());
+		g.insert_edges(edges.begin(), edges.end());
+		benchmark::DoNotOptimize(g.fingerprint());
+		state.PauseTiming();
+		{
+			auto discard = std::move(g);
+		}
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(build_with_fingerprint)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,120 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/graph_algebra.hpp"
+
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <vector>
+
+namespace {
+	constexpr auto nodes = 50000;
+
+	// Two graphs of 8 edges per node over node ranges that overlap by half
+	auto make_graph(int first, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		auto state = seed;
+		auto next = [&state] {
+			state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+			return static_cast<int>(state);
+		};
+		auto values = std::vector<int>();
+		auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+		for (auto i = first; i < first + nodes; ++i) {
+			values.push_back(i);
+			for (auto d = 0; d < 8; ++d) {
+				edges.push_back({i, first + next() % nodes, next() % 4});
+			}
+		}
+		g.insert_nodes(values.begin(), values.end());
+		g.insert_edges(edges.begin(), edges.end());
+		return g;
+	}
+
+	auto const& shared_pair() {
+		static auto const pair = std::pair(make_graph(0, 43), make_graph(nodes / 2, 43));
+		return pair;
+	}
+
+	template<typename F>
+	void timed_discard(benchmark::State& state, F f) {
+		for (auto _ : state) {
+			auto g = f();
+			benchmark::DoNotOptimize(g.empty());
+			state.PauseTiming();
+			{
+				auto discard = std::move(g);
+			}
+			state.ResumeTiming();
+		}
+	}
+} // namespace
+
+// What combining graphs costs today: a copy, then insert_node and insert_edge per element
+static void union_by_inserts(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	timed_discard(state, [&] {
+		auto g = a;
+		for (auto const& n : b.nodes()) {
+			g.insert_node(n);
+		}
+		for (auto const& [from, to, weight] : b) {
+			g.insert_edge(from, to, weight);
+		}
+		return g;
+	});
+}
+BENCHMARK(union_by_inserts)->Unit(benchmark::kMillisecond);
+
+static void graph_union(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	timed_discard(state, [&] { return gdwg::graph_union(a, b); });
+}
+BENCHMARK(graph_union)->Unit(benchmark::kMillisecond);
+
+// The copy of a is made outside the timing, as when the caller owns a
+static void graph_union_in_place(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		state.PauseTiming();
+		auto g = a;
+		state.ResumeTiming();
+		g = gdwg::graph_union(std::move(g), b);
+		benchmark::DoNotOptimize(g.empty());
+		state.PauseTiming();
+		{
+			auto discard = std::move(g);
+		}
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(graph_union_in_place)->Unit(benchmark::kMillisecond);
+
+static void intersection_by_lookups(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	timed_discard(state, [&] {
+		auto g = gdwg::graph<int, int>{};
+		for (auto const& n : a.nodes()) {
+			if (b.is_node(n)) {
+				g.insert_node(n);
+			}
+		}
+		for (auto const& [from, to, weight] : a) {
+			if (b.is_node(from) and b.is_node(to) and b.find(from, to, weight) != b.end()) {
+				g.insert_edge(from, to, weight);
+			}
+		}
+		return g;
+	});
+}
+BENCHMARK(intersection_by_lookups)->Unit(benchmark::kMillisecond);
+
+static void graph_intersection(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	timed_discard(state, [&] { return gdwg::graph_intersection(a, b); });
+}
+BENCHMARK(graph_intersection)->Unit(benchmark::kMillisecond);
+
+static void graph_difference(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	timed_discard(state, [&] { return gdwg::graph_difference(a, b); });
+}
+BENCHMARK(graph_difference)->Unit(benchmark::kMillisecond);
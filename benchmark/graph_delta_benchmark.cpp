@@ -0,0 +1,89 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/graph_delta.hpp"
+
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+	constexpr auto nodes = 50000;
+
+	// Two graphs of 50000 nodes and 400000 edges that differ in 100 edges
+	auto const& shared_pair() {
+		static auto const pair = [] {
+			auto a = gdwg::graph<int, int>{};
+			auto state = 43U;
+			auto next = [&state] {
+				state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+				return static_cast<int>(state);
+			};
+			auto values = std::vector<int>();
+			auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+			for (auto i = 0; i < nodes; ++i) {
+				values.push_back(i);
+				for (auto d = 0; d < 8; ++d) {
+					edges.push_back({i, next() % nodes, next() % 10});
+				}
+			}
+			a.insert_nodes(values.begin(), values.end());
+			a.insert_edges(edges.begin(), edges.end());
+
+			auto b = a;
+			for (auto i = 0; i < 100; ++i) {
+				b.insert_edge(next() % nodes, next() % nodes, 10 + i);
+			}
+			return std::pair(std::move(a), std::move(b));
+		}();
+		return pair;
+	}
+} // namespace
+
+// What synchronising costs today: a full copy
+static void sync_by_copy(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		auto replica = b;
+		benchmark::DoNotOptimize(replica.empty());
+		state.PauseTiming();
+		{
+			auto discard = std::move(replica);
+		}
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(sync_by_copy)->Unit(benchmark::kMillisecond);
+
+static void diff(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::diff(a, b).size());
+	}
+}
+BENCHMARK(diff)->Unit(benchmark::kMillisecond);
+
+// Serialising, reading back and patching a replica, given the delta
+static void ship_and_patch(benchmark::State& state) {
+	auto const& [a, b] = shared_pair();
+	auto const delta = gdwg::diff(a, b);
+	auto bytes = std::size_t{0};
+	for (auto _ : state) {
+		state.PauseTiming();
+		auto replica = a;
+		state.ResumeTiming();
+
+		auto os = std::ostringstream();
+		gdwg::write_delta(os, delta);
+		auto is = std::istringstream(os.str());
+		gdwg::patch(replica, gdwg::read_delta<int, int>(is));
+		bytes = os.str().size();
+
+		state.PauseTiming();
+		{
+			auto discard = std::move(replica);
+		}
+		state.ResumeTiming();
+	}
+	state.counters["delta_bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(ship_and_patch)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,93 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+	struct edge_list {
+		std::vector<int> src;
+		std::vector<int> dst;
+		std::vector<int> weight;
+	};
+
+	// 100000 nodes with 8 out-edges each and weights in [1, 10]
+	auto const& shared_edges() {
+		static auto const edges = [] {
+			auto list = edge_list{};
+			auto state = 43U;
+			auto next = [&state] {
+				state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+				return static_cast<int>(state);
+			};
+			for (auto i = 0; i < 100000; ++i) {
+				for (auto d = 0; d < 8; ++d) {
+					list.src.push_back(i);
+					list.dst.push_back(next() % 100000);
+					list.weight.push_back(next() % 10 + 1);
+				}
+			}
+			return list;
+		}();
+		return edges;
+	}
+
+	auto build_graph() -> gdwg::graph<int, int> {
+		auto const& edges = shared_edges();
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 100000; ++i) {
+			g.insert_node(i);
+		}
+		for (auto e = std::size_t{0}; e < edges.src.size(); ++e) {
+			g.insert_edge(edges.src[e], edges.dst[e], edges.weight[e]);
+		}
+		return g;
+	}
+
+	auto const& shared_file() {
+		static auto const path = [] {
+			auto file = (std::filesystem::temp_directory_path() / "gdwg_mapped_benchmark.bin").string();
+			gdwg::save_binary(build_graph(), file);
+			return file;
+		}();
+		return path;
+	}
+} // namespace
+
+// What a restart costs without the binary format
+static void rebuild_from_edges(benchmark::State& state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(build_graph());
+	}
+}
+BENCHMARK(rebuild_from_edges)->Unit(benchmark::kMillisecond);
+
+// Opening only checks the header; rows are faulted in as they are touched
+static void open_mapped(benchmark::State& state) {
+	auto const& path = shared_file();
+	for (auto _ : state) {
+		auto const mapped = gdwg::mapped_graph<int, int>(path);
+		benchmark::DoNotOptimize(mapped.targets(gdwg::node_id{12345}).size());
+	}
+}
+BENCHMARK(open_mapped)->Unit(benchmark::kMicrosecond);
+
+// Opening and then touching every row and weight
+static void open_mapped_and_scan(benchmark::State& state) {
+	auto const& path = shared_file();
+	for (auto _ : state) {
+		auto const mapped = gdwg::mapped_graph<int, int>(path);
+		auto sum = 0L;
+		for (auto id = gdwg::node_id{0}; id < mapped.node_count(); ++id) {
+			for (auto const w : mapped.weights(id)) {
+				sum += w;
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(open_mapped_and_scan)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "gdwg/paged_graph.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+	constexpr auto nodes = 50000;
+
+	// 50000 nodes with 8 out-edges each, saved once
+	auto const& shared_file() {
+		static auto const path = [] {
+			auto file = (std::filesystem::temp_directory_path() / "gdwg_paged_benchmark.bin").string();
+			auto g = gdwg::graph<int, int>{};
+			auto state = 43U;
+			auto next = [&state] {
+				state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+				return static_cast<int>(state);
+			};
+			auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+			for (auto i = 0; i < nodes; ++i) {
+				g.insert_node(i);
+				for (auto d = 0; d < 8; ++d) {
+					edges.push_back({i, next() % nodes, next() % 10 + 1});
+				}
+			}
+			g.insert_edges(edges.begin(), edges.end());
+			gdwg::save_binary(g, file);
+			return file;
+		}();
+		return path;
+	}
+} // namespace
+
+// Argument is the number of 64 KiB segments cached
+static void paged_scan(benchmark::State& state) {
+	auto const paged = gdwg::paged_graph<int, int>(
+	   shared_file(),
+	   {.segment_bytes = std::size_t{1} << 16U, .cache_segments = static_cast<std::size_t>(state.range(0))});
+	for (auto _ : state) {
+		auto sum = 0L;
+		for (auto const& e : paged) {
+			sum += e.weight;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.counters["mapped_per_scan"] =
+	   static_cast<double>(paged.io_stats().bytes_mapped) / static_cast<double>(state.iterations());
+}
+BENCHMARK(paged_scan)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// Random connections() lookups; argument is the number of 64 KiB segments cached
+static void paged_lookup(benchmark::State& state) {
+	auto const paged = gdwg::paged_graph<int, int>(
+	   shared_file(),
+	   {.segment_bytes = std::size_t{1} << 16U, .cache_segments = static_cast<std::size_t>(state.range(0))});
+	auto key = 1U;
+	for (auto _ : state) {
+		key = (key * 1103515245U + 12345U) & 0x7fffffffU;
+		benchmark::DoNotOptimize(paged.connections(static_cast<int>(key % nodes)));
+	}
+	auto const& stats = paged.io_stats();
+	state.counters["hit_rate"] =
+	   static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses);
+}
+BENCHMARK(paged_lookup)->Arg(8)->Arg(64)->Arg(1024);
+
+// The same lookups with the whole file mapped, for comparison
+static void mapped_lookup(benchmark::State& state) {
+	auto const mapped = gdwg::mapped_graph<int, int>(shared_file());
+	auto key = 1U;
+	for (auto _ : state) {
+		key = (key * 1103515245U + 12345U) & 0x7fffffffU;
+		auto const id = mapped.find(static_cast<int>(key % nodes));
+		auto dsts = std::vector<int>();
+		for (auto const t : mapped.targets(id)) {
+			dsts.push_back(mapped.node(t));
+		}
+		benchmark::DoNotOptimize(dsts);
+	}
+}
+BENCHMARK(mapped_lookup);
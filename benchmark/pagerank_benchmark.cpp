@@ -0,0 +1,53 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+namespace {
+	// Random graph with 8 out-edges per node and weights in [1, 10]
+	auto make_random(int nodes) -> gdwg::csr_graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto state = 17U;
+		auto next = [&state] {
+			state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+			return static_cast<int>(state);
+		};
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < 8; ++d) {
+				g.insert_edge(i, next() % nodes, next() % 10 + 1);
+			}
+		}
+		return gdwg::csr_graph<int, int>(g, gdwg::adjacency::in_and_out);
+	}
+
+	auto const& shared_random() {
+		static auto const g = make_random(50000);
+		return g;
+	}
+} // namespace
+
+// Arg(0) is the sequential baseline; compare the others against it for speedup
+static void pagerank_threads(benchmark::State& state) {
+	auto const& g = shared_random();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::pagerank(g, {.pool = &pool, .max_iterations = 20}));
+	}
+}
+BENCHMARK(pagerank_threads)->Arg(0)->Arg(1)->Arg(3)->Arg(7)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Unweighted iterations skip the per-edge multiply
+static void pagerank_unweighted(benchmark::State& state) {
+	auto const& g = shared_random();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::pagerank(g, {.max_iterations = 20, .weighted = false}));
+	}
+}
+BENCHMARK(pagerank_unweighted)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+	auto make_graph(int nodes, int degree) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 1; d <= degree; ++d) {
+				g.insert_edge(i, (i * 31 + d * 17) % nodes, d * 0.5);
+			}
+		}
+		return g;
+	}
+
+	auto const& shared_graph() {
+		static auto const g = make_graph(20000, 8);
+		return g;
+	}
+
+	// Stand-in for a per-edge scoring job
+	auto score(int src, int dst, double weight) -> double {
+		auto x = weight;
+		for (auto i = 0; i < 64; ++i) {
+			x = std::sin(x + src) * std::cos(x - dst);
+		}
+		return x;
+	}
+} // namespace
+
+static void sequential_for_each_edge(benchmark::State& state) {
+	auto const& g = shared_graph();
+	for (auto _ : state) {
+		auto total = 0.0;
+		for (auto const& [from, to, weight] : g) {
+			total += score(from, to, weight);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+}
+BENCHMARK(sequential_for_each_edge)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void parallel_for_each_edge(benchmark::State& state) {
+	auto const& g = shared_graph();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		auto total = std::atomic<std::int64_t>{0};
+		g.parallel_for_each_edge(
+		   [&](int src, int dst, double weight) {
+			   total += static_cast<std::int64_t>(score(src, dst, weight) * 1000);
+		   },
+		   pool);
+		benchmark::DoNotOptimize(total.load());
+	}
+}
+BENCHMARK(parallel_for_each_edge)
+   ->Arg(0)
+   ->Arg(1)
+   ->Arg(3)
+   ->Arg(7)
+   ->Arg(15)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+static void parallel_for_each_node(benchmark::State& state) {
+	auto const& g = shared_graph();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		auto total = std::atomic<std::int64_t>{0};
+		g.parallel_for_each_node(
+		   [&](int n) { total += static_cast<std::int64_t>(score(n, n, 1.0) * 1000); },
+		   pool);
+		benchmark::DoNotOptimize(total.load());
+	}
+}
+BENCHMARK(parallel_for_each_node)->Arg(0)->Arg(3)->Arg(7)->Unit(benchmark::kMillisecond)->UseRealTime();
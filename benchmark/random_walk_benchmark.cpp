@@ -0,0 +1,66 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/random_walk.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <span>
+
+namespace {
+	// Random graph with 16 out-edges per node and weights in [1, 10]
+	auto make_random(int nodes) -> gdwg::csr_graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto state = 37U;
+		auto next = [&state] {
+			state = (state * 1103515245U + 12345U) & 0x7fffffffU;
+			return static_cast<int>(state);
+		};
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < 16; ++d) {
+				g.insert_edge(i, next() % nodes, next() % 10 + 1);
+			}
+		}
+		return gdwg::csr_graph<int, int>(g);
+	}
+
+	auto const& shared_walker() {
+		static auto const walker = gdwg::random_walker<int, int>(make_random(20000));
+		return walker;
+	}
+
+	auto run(benchmark::State& state, gdwg::walk_options const& options) -> void {
+		auto const& walker = shared_walker();
+		auto steps = std::size_t{0};
+		for (auto _ : state) {
+			walker.generate(options, [&](std::span<gdwg::node_id const> walk) { steps += walk.size(); });
+		}
+		state.counters["steps/s"] =
+		   benchmark::Counter(static_cast<double>(steps), benchmark::Counter::kIsRate);
+	}
+} // namespace
+
+static void alias_table_build(benchmark::State& state) {
+	static auto const g = make_random(20000);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::random_walker<int, int>(g));
+	}
+}
+BENCHMARK(alias_table_build)->Unit(benchmark::kMillisecond);
+
+// Arg(0) is the sequential baseline; compare the others against it for speedup
+static void weighted_walks(benchmark::State& state) {
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	run(state, {.pool = &pool, .length = 40, .walks_per_node = 1});
+}
+BENCHMARK(weighted_walks)->Arg(0)->Arg(1)->Arg(3)->Arg(7)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Rejection costs a binary search per candidate and some redraws
+static void node2vec_walks(benchmark::State& state) {
+	run(state, {.length = 40, .walks_per_node = 1, .p = 0.5, .q = 2.0});
+}
+BENCHMARK(node2vec_walks)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,94 @@
+#include "gdwg/bfs.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/reachability.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Sparse random graph with mostly forward edges and the odd backward one, so there are a few
+	// non-trivial components and a deep condensation
+	auto make_sparse(int nodes) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto state = 17;
+		auto next = [&state] {
+			state = (state * 1103515245 + 12345) & 0x7fffffff;
+			return state;
+		};
+		for (auto i = 0; i + 1 < nodes; ++i) {
+			for (auto d = 0; d < 3; ++d) {
+				g.insert_edge(i, i + 1 + next() % std::min(nodes - i - 1, 2000), 1);
+			}
+			if (next() % 50 == 0) {
+				g.insert_edge(i, next() % (i + 1), 1);
+			}
+		}
+		return g;
+	}
+
+	auto const& shared_sparse() {
+		static auto const g = make_sparse(20000);
+		return g;
+	}
+
+	auto queries(std::size_t count) -> std::vector<std::pair<int, int>> {
+		auto state = 29;
+		auto result = std::vector<std::pair<int, int>>();
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			state = (state * 1103515245 + 12345) & 0x7fffffff;
+			auto const src = state % 20000;
+			state = (state * 1103515245 + 12345) & 0x7fffffff;
+			result.emplace_back(src, state % 20000);
+		}
+		return result;
+	}
+} // namespace
+
+// Arg is the label budget in KiB
+static void reachability_build(benchmark::State& state) {
+	auto const& g = shared_sparse();
+	auto const budget = static_cast<std::size_t>(state.range(0)) << 10U;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::reachability_index<int>(g, {.label_budget = budget}));
+	}
+}
+BENCHMARK(reachability_build)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+// Arg is the label budget in KiB; 65536 covers every component, so no query searches
+static void reachability_query(benchmark::State& state) {
+	auto const index = gdwg::reachability_index<int>(
+	   shared_sparse(),
+	   {.label_budget = static_cast<std::size_t>(state.range(0)) << 10U});
+	auto const pairs = queries(1000);
+	for (auto _ : state) {
+		for (auto const& [src, dst] : pairs) {
+			benchmark::DoNotOptimize(index.is_reachable(src, dst));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pairs.size()));
+	state.counters["bytes"] = static_cast<double>(index.memory_bytes());
+}
+BENCHMARK(reachability_query)->Arg(0)->Arg(256)->Arg(4096)->Arg(65536)->Unit(benchmark::kMicrosecond);
+
+// Baseline: one BFS per query
+static void reachability_bfs(benchmark::State& state) {
+	auto const csr = gdwg::csr_graph<int, int>(shared_sparse());
+	auto const pairs = queries(10);
+	for (auto _ : state) {
+		for (auto const& [src, dst] : pairs) {
+			auto const result = gdwg::bfs(csr, src);
+			benchmark::DoNotOptimize(result.distance_to(dst) != gdwg::bfs_result<int>::unreachable);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pairs.size()));
+}
+BENCHMARK(reachability_bfs)->Unit(benchmark::kMicrosecond);
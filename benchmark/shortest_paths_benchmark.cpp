@@ -0,0 +1,118 @@
+#include "gdwg/contraction_hierarchy.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/delta_stepping.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_paths.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+namespace {
+	// Road-like grid: each cell links to its four neighbours with pseudo-random weights
+	auto make_grid(int side) -> gdwg::csr_graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < side * side; ++i) {
+			g.insert_node(i);
+		}
+
+		auto weight = 17;
+		auto next_weight = [&weight] {
+			weight = (weight * 1103515245 + 12345) & 0x7fffffff;
+			return weight % 100 + 1;
+		};
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				auto const id = r * side + c;
+				if (c + 1 < side) {
+					g.insert_edge(id, id + 1, next_weight());
+					g.insert_edge(id + 1, id, next_weight());
+				}
+				if (r + 1 < side) {
+					g.insert_edge(id, id + side, next_weight());
+					g.insert_edge(id + side, id, next_weight());
+				}
+			}
+		}
+		return gdwg::csr_graph<int, int>(g);
+	}
+
+	auto const& shared_grid() {
+		static auto const g = make_grid(300);
+		return g;
+	}
+
+	// Grids are the hardest case for contraction since their separators are large
+	auto const& routing_grid() {
+		static auto const g = make_grid(100);
+		return g;
+	}
+} // namespace
+
+static void dijkstra_binary_heap(benchmark::State& state) {
+	auto const& g = shared_grid();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::shortest_paths(g, 0));
+	}
+}
+BENCHMARK(dijkstra_binary_heap)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void dijkstra_radix_heap(benchmark::State& state) {
+	auto const& g = shared_grid();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::shortest_paths(g, 0, {.heap = gdwg::heap_kind::radix}));
+	}
+}
+BENCHMARK(dijkstra_radix_heap)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Arg(0) is the sequential baseline; compare the others against it for speedup
+static void delta_stepping(benchmark::State& state) {
+	auto const& g = shared_grid();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::delta_stepping(g, 0, {.pool = &pool, .delta = 50}));
+	}
+}
+BENCHMARK(delta_stepping)
+   ->Arg(0)
+   ->Arg(1)
+   ->Arg(3)
+   ->Arg(7)
+   ->Arg(15)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+static void contraction_hierarchy_preprocessing(benchmark::State& state) {
+	auto const& g = routing_grid();
+	auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::contraction_hierarchy<int, int>(g, {.pool = &pool}));
+	}
+}
+BENCHMARK(contraction_hierarchy_preprocessing)
+   ->Arg(0)
+   ->Arg(3)
+   ->Arg(7)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+// Corner to corner, the worst case for a one-directional search
+static void dijkstra_point_to_point(benchmark::State& state) {
+	auto const& g = routing_grid();
+	auto const dst = static_cast<int>(g.node_count()) - 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(gdwg::shortest_path(g, 0, dst));
+	}
+}
+BENCHMARK(dijkstra_point_to_point)->Unit(benchmark::kMicrosecond);
+
+static void contraction_hierarchy_query(benchmark::State& state) {
+	auto const& g = routing_grid();
+	static auto const ch = gdwg::contraction_hierarchy<int, int>(g);
+	auto query = gdwg::contraction_hierarchy<int, int>::query(ch);
+	auto const dst = static_cast<int>(g.node_count()) - 1;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(query.path(0, dst));
+	}
+}
+BENCHMARK(contraction_hierarchy_query)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,231 @@
+#ifndef GDWG_ALL_PAIRS_HPP
+#define GDWG_ALL_PAIRS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct all_pairs_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Side of the square tiles the matrix is processed in
+		std::size_t block = 64;
+	};
+
+	namespace detail {
+		/* Integers leave headroom so that unreachable + unreachable can't overflow; anything at
+		 * or above half of it is treated as unreachable */
+		template<typename E>
+		constexpr auto all_pairs_infinity() -> E {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return std::numeric_limits<E>::infinity();
+			}
+			else {
+				return std::numeric_limits<E>::max() / 2;
+			}
+		}
+
+		template<typename E>
+		constexpr auto all_pairs_unreachable(E value) -> bool {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return value == std::numeric_limits<E>::infinity();
+			}
+			else {
+				return value >= all_pairs_infinity<E>() / 2;
+			}
+		}
+	} // namespace detail
+
+	template<typename N, typename E>
+	struct distance_matrix {
+		static constexpr auto unreachable = detail::all_pairs_infinity<E>();
+
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		// Row-major node_count x node_count distances, unreachable where there's no path
+		std::vector<E> distances;
+
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return nodes->size();
+		}
+
+		[[nodiscard]] auto row(node_id src) const -> std::span<E const> {
+			return std::span<E const>(distances).subspan(src * node_count(), node_count());
+		}
+
+		[[nodiscard]] auto distance(node_id src, node_id dst) const -> std::optional<E> {
+			auto const d = distances[src * node_count() + dst];
+			return d == unreachable ? std::nullopt : std::optional<E>(d);
+		}
+
+		[[nodiscard]] auto distance(N const& src, N const& dst) const -> std::optional<E> {
+			auto const s = detail::find_node(*nodes, src);
+			auto const d = detail::find_node(*nodes, dst);
+			if (s == no_node or d == no_node) {
+				throw std::runtime_error("Cannot call gdwg::distance_matrix<N, E>::distance on a node "
+				                         "that doesn't exist in the graph");
+			}
+			return distance(s, d);
+		}
+	};
+
+	namespace detail {
+		/* out[j] = min(out[j], through + via[j]). The AVX2 paths cover the common 32-bit and
+		 * floating point weights; everything else, and the tail, is left to the compiler. */
+		template<typename E>
+		auto relax_row(E* __restrict out, E const* __restrict via, E through, std::size_t count)
+		   -> void {
+			auto j = std::size_t{0};
+#if defined(__AVX2__)
+			if constexpr (std::is_integral_v<E> and std::is_signed_v<E> and sizeof(E) == 4) {
+				auto const t = _mm256_set1_epi32(static_cast<std::int32_t>(through));
+				for (; j + 8 <= count; j += 8) {
+					auto const sum =
+					   _mm256_add_epi32(t, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(via + j)));
+					auto* const dst = reinterpret_cast<__m256i*>(out + j);
+					_mm256_storeu_si256(dst, _mm256_min_epi32(_mm256_loadu_si256(dst), sum));
+				}
+			}
+			else if constexpr (std::is_integral_v<E> and std::is_unsigned_v<E> and sizeof(E) == 4) {
+				auto const t = _mm256_set1_epi32(static_cast<std::int32_t>(through));
+				for (; j + 8 <= count; j += 8) {
+					auto const sum =
+					   _mm256_add_epi32(t, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(via + j)));
+					auto* const dst = reinterpret_cast<__m256i*>(out + j);
+					_mm256_storeu_si256(dst, _mm256_min_epu32(_mm256_loadu_si256(dst), sum));
+				}
+			}
+			else if constexpr (std::is_same_v<E, float>) {
+				auto const t = _mm256_set1_ps(through);
+				for (; j + 8 <= count; j += 8) {
+					auto const sum = _mm256_add_ps(t, _mm256_loadu_ps(via + j));
+					_mm256_storeu_ps(out + j, _mm256_min_ps(_mm256_loadu_ps(out + j), sum));
+				}
+			}
+			else if constexpr (std::is_same_v<E, double>) {
+				auto const t = _mm256_set1_pd(through);
+				for (; j + 4 <= count; j += 4) {
+					auto const sum = _mm256_add_pd(t, _mm256_loadu_pd(via + j));
+					_mm256_storeu_pd(out + j, _mm256_min_pd(_mm256_loadu_pd(out + j), sum));
+				}
+			}
+#endif
+			for (; j < count; ++j) {
+				auto const sum = static_cast<E>(through + via[j]);
+				out[j] = sum < out[j] ? sum : out[j];
+			}
+		}
+	} // namespace detail
+
+	/* Floyd-Warshall over a dense matrix, for graphs small enough to hold node_count^2 weights.
+	 * Parallel edges collapse to their minimum weight. The matrix is processed in tiles: each
+	 * round finishes the diagonal tile of the next block of pivots, then the tiles in its row and
+	 * column, then every other tile, with the last two steps spread over the pool. Negative
+	 * weights are fine; a negative cycle throws. Integer path weights must stay within a quarter
+	 * of E's range. */
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	auto all_pairs_shortest_paths(csr_graph<N, E> const& g, all_pairs_options const& options = {})
+	   -> distance_matrix<N, E> {
+		auto const n = g.node_count();
+		auto const infinity = detail::all_pairs_infinity<E>();
+		auto result = distance_matrix<N, E>{g.node_table(), std::vector<E>(n * n, infinity)};
+		auto* const d = result.distances.data();
+
+		for (auto u = node_id{0}; u < n; ++u) {
+			d[u * n + u] = E{};
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				auto& cell = d[u * n + targets[e]];
+				cell = std::min(cell, weights[e]);
+			}
+		}
+
+		auto const block = std::max(options.block, std::size_t{1});
+		auto const blocks = (n + block - 1) / block;
+
+		// Relax tile (ib, jb) through the pivots of block kb, in pivot order
+		auto const update = [&](std::size_t ib, std::size_t jb, std::size_t kb) {
+			auto const i_last = std::min(n, (ib + 1) * block);
+			auto const j_first = jb * block;
+			auto const j_count = std::min(n, j_first + block) - j_first;
+			auto const k_last = std::min(n, (kb + 1) * block);
+
+			for (auto k = kb * block; k < k_last; ++k) {
+				auto const* const via = d + k * n + j_first;
+				for (auto i = ib * block; i < i_last; ++i) {
+					// Row k can only improve through a negative cycle, caught below
+					auto const through = d[i * n + k];
+					if (i == k or detail::all_pairs_unreachable(through)) {
+						continue;
+					}
+					detail::relax_row(d + i * n + j_first, via, through, j_count);
+				}
+			}
+		};
+
+		for (auto kb = std::size_t{0}; kb < blocks; ++kb) {
+			update(kb, kb, kb);
+
+			detail::for_range(options.pool, 0, blocks, 1, [&](std::size_t t) {
+				if (t != kb) {
+					update(kb, t, kb);
+					update(t, kb, kb);
+				}
+			});
+
+			detail::for_range(options.pool, 0, blocks * blocks, 1, [&](std::size_t t) {
+				auto const ib = t / blocks;
+				auto const jb = t % blocks;
+				if (ib != kb and jb != kb) {
+					update(ib, jb, kb);
+				}
+			});
+
+			if constexpr (std::is_signed_v<E>) {
+				for (auto i = std::size_t{0}; i < n; ++i) {
+					if (d[i * n + i] < E{}) {
+						throw std::runtime_error("Cannot call gdwg::all_pairs_shortest_paths on a graph "
+						                         "with a negative cycle");
+					}
+				}
+			}
+		}
+
+		if constexpr (not std::numeric_limits<E>::has_infinity) {
+			for (auto& cell : result.distances) {
+				if (detail::all_pairs_unreachable(cell)) {
+					cell = infinity;
+				}
+			}
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	auto all_pairs_shortest_paths(graph<N, E> const& g, all_pairs_options const& options = {})
+	   -> distance_matrix<N, E> {
+		return all_pairs_shortest_paths(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_ALL_PAIRS_HPP
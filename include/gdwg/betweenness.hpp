@@ -0,0 +1,289 @@
+#ifndef GDWG_BETWEENNESS_HPP
+#define GDWG_BETWEENNESS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/heap.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct betweenness_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Number of sources to sample; 0, or at least the node count, runs every source exactly
+		std::size_t samples = 0;
+
+		// Seed for picking the sampled sources, so approximations are repeatable
+		std::uint64_t seed = 0;
+
+		// Use edge weights as path lengths. Ignored unless E is arithmetic; otherwise, and when
+		// false, every edge has length 1.
+		bool weighted = true;
+
+		// Divide by (n - 1)(n - 2), the number of ordered pairs a node can lie between
+		bool normalized = false;
+	};
+
+	template<typename N>
+	struct betweenness_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		// Indexed by node id. Sampled runs are scaled up to estimate the exact value.
+		std::vector<double> centrality;
+
+		// Sources the searches started from, ascending
+		std::vector<node_id> sources;
+
+		[[nodiscard]] auto exact() const noexcept -> bool {
+			return sources.size() == centrality.size();
+		}
+
+		[[nodiscard]] auto centrality_of(N const& value) const -> double {
+			auto const id = detail::find_node(*nodes, value);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::betweenness_result<N>::centrality_of on a "
+				                         "node that doesn't exist in the graph");
+			}
+			return centrality[id];
+		}
+	};
+
+	namespace detail {
+		// Accumulators per thread; more than one each lets idle threads steal a piece
+		inline constexpr auto betweenness_pieces_per_thread = std::size_t{2};
+
+		/* Per-search state, reset only where the last search reached */
+		template<typename D>
+		struct brandes_scratch {
+			std::vector<D> distance;
+			std::vector<double> paths;
+			std::vector<double> dependency;
+			std::vector<bool> reached;
+			std::vector<bool> done;
+
+			// Nodes in the order they were settled, so by non-decreasing distance
+			std::vector<node_id> order;
+
+			explicit brandes_scratch(std::size_t n)
+			: distance(n)
+			, paths(n, 0.0)
+			, dependency(n, 0.0)
+			, reached(n, false)
+			, done(n, false) {
+				order.reserve(n);
+			}
+
+			auto reset() -> void {
+				for (auto const v : order) {
+					paths[v] = 0.0;
+					dependency[v] = 0.0;
+					reached[v] = false;
+					done[v] = false;
+				}
+				order.clear();
+			}
+		};
+
+		/* Brandes' algorithm from one source: count shortest paths while settling nodes, then
+		 * walk them back from the farthest, each node collecting the dependency of the nodes its
+		 * tight out-edges lead to. Parallel edges count once and self loops not at all; out-edges
+		 * are sorted by destination then weight, so the first edge of a run is the lightest. The
+		 * back pass re-derives tight edges from the distances instead of keeping predecessor lists. */
+		template<bool Weighted, typename N, typename E, typename D>
+		auto brandes(csr_graph<N, E> const& g,
+		             node_id source,
+		             brandes_scratch<D>& s,
+		             std::vector<double>& centrality) -> void {
+			auto const edge_length = [](E const& w) -> D {
+				if constexpr (Weighted) {
+					return static_cast<D>(w);
+				}
+				else {
+					return D{1};
+				}
+			};
+			auto const relax = [&](node_id u, auto const& visit) {
+				auto const targets = g.targets(u);
+				auto const weights = g.weights(u);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					auto const v = targets[i];
+					if ((i > 0 and targets[i - 1] == v) or v == u) {
+						continue;
+					}
+					visit(v, static_cast<D>(s.distance[u] + edge_length(weights[i])));
+				}
+			};
+
+			s.distance[source] = D{};
+			s.paths[source] = 1.0;
+			s.reached[source] = true;
+			if constexpr (Weighted) {
+				auto heap = dary_heap<D, node_id>(4);
+				heap.push(D{}, source);
+				while (not heap.empty()) {
+					auto const u = heap.pop().second;
+					if (s.done[u]) {
+						continue;
+					}
+					s.done[u] = true;
+					s.order.push_back(u);
+					relax(u, [&](node_id v, D candidate) {
+						if (not s.reached[v] or candidate < s.distance[v]) {
+							s.reached[v] = true;
+							s.distance[v] = candidate;
+							s.paths[v] = s.paths[u];
+							heap.push(candidate, v);
+						}
+						else if (candidate == s.distance[v]) {
+							s.paths[v] += s.paths[u];
+						}
+					});
+				}
+			}
+			else {
+				// The settle order doubles as the BFS queue
+				s.order.push_back(source);
+				for (auto head = std::size_t{0}; head < s.order.size(); ++head) {
+					auto const u = s.order[head];
+					relax(u, [&](node_id v, D candidate) {
+						if (not s.reached[v]) {
+							s.reached[v] = true;
+							s.distance[v] = candidate;
+							s.order.push_back(v);
+						}
+						if (s.distance[v] == candidate) {
+							s.paths[v] += s.paths[u];
+						}
+					});
+				}
+			}
+
+			for (auto i = s.order.size(); i-- > 0;) {
+				auto const u = s.order[i];
+				auto dependency = 0.0;
+				relax(u, [&](node_id v, D candidate) {
+					if (s.reached[v] and s.distance[v] == candidate) {
+						dependency += s.paths[u] / s.paths[v] * (1.0 + s.dependency[v]);
+					}
+				});
+				s.dependency[u] = dependency;
+				if (u != source) {
+					centrality[u] += dependency;
+				}
+			}
+			s.reset();
+		}
+
+		/* k distinct ids of [0, n) by a partial Fisher-Yates shuffle, ascending */
+		inline auto sample_sources(std::size_t n, std::size_t k, std::uint64_t seed)
+		   -> std::vector<node_id> {
+			auto ids = std::vector<node_id>(n);
+			std::iota(ids.begin(), ids.end(), node_id{0});
+			auto engine = std::mt19937_64(seed);
+			for (auto i = std::size_t{0}; i < k; ++i) {
+				auto pick = std::uniform_int_distribution<std::size_t>(i, n - 1);
+				std::swap(ids[i], ids[pick(engine)]);
+			}
+			ids.resize(k);
+			std::sort(ids.begin(), ids.end());
+			return ids;
+		}
+
+		/* Sources are split into a few contiguous pieces per thread, each summing into its own
+		 * accumulator, so searches never contend. Accumulators are added up in piece order. */
+		template<bool Weighted, typename D, typename N, typename E>
+		auto betweenness(csr_graph<N, E> const& g,
+		                 std::vector<node_id> sources,
+		                 betweenness_options const& options) -> betweenness_result<N> {
+			auto const n = g.node_count();
+			auto result = betweenness_result<N>{g.node_table(), std::vector<double>(n, 0.0), std::move(sources)};
+			if (result.sources.empty()) {
+				return result;
+			}
+
+			auto const threads = options.pool == nullptr ? std::size_t{1} : options.pool->size() + 1;
+			auto const pieces = std::min(result.sources.size(), threads * betweenness_pieces_per_thread);
+			auto accumulators = std::vector<std::vector<double>>(pieces);
+			detail::for_range(options.pool, 0, pieces, 1, [&](std::size_t p) {
+				auto& centrality = accumulators[p];
+				centrality.assign(n, 0.0);
+				auto scratch = brandes_scratch<D>(n);
+				auto const first = result.sources.size() * p / pieces;
+				auto const last = result.sources.size() * (p + 1) / pieces;
+				for (auto i = first; i < last; ++i) {
+					brandes<Weighted>(g, result.sources[i], scratch, centrality);
+				}
+			});
+
+			auto scale = static_cast<double>(n) / static_cast<double>(result.sources.size());
+			if (options.normalized) {
+				scale = n > 2 ? scale / (static_cast<double>(n - 1) * static_cast<double>(n - 2)) : 0.0;
+			}
+			detail::for_range(options.pool, 0, n, 4096, [&](std::size_t v) {
+				auto sum = 0.0;
+				for (auto const& centrality : accumulators) {
+					sum += centrality[v];
+				}
+				result.centrality[v] = sum * scale;
+			});
+			return result;
+		}
+	} // namespace detail
+
+	/* Betweenness centrality by Brandes' algorithm: for every node, the sum over ordered pairs
+	 * (s, t) of the fraction of shortest s-t paths running through it. Searches from different
+	 * sources run in parallel. With samples set, only that many sources are searched and the sums
+	 * scaled by n / samples, an unbiased estimate of the exact value. Weighted runs need positive
+	 * weights on every edge but self loops, which are ignored; edges of weight zero would make
+	 * path counts depend on the settle order. */
+	template<typename N, typename E>
+	auto betweenness_centrality(csr_graph<N, E> const& g, betweenness_options const& options = {})
+	   -> betweenness_result<N> {
+		auto const n = g.node_count();
+		auto sources = std::vector<node_id>();
+		if (options.samples == 0 or options.samples >= n) {
+			sources.resize(n);
+			std::iota(sources.begin(), sources.end(), node_id{0});
+		}
+		else {
+			sources = detail::sample_sources(n, options.samples, options.seed);
+		}
+
+		if constexpr (std::is_arithmetic_v<E>) {
+			if (options.weighted) {
+				// Self loops are never relaxed, so their weights don't matter
+				for (auto u = node_id{0}; u < n; ++u) {
+					auto const targets = g.targets(u);
+					auto const weights = g.weights(u);
+					for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+						if (targets[i] != u and not(weights[i] > E{})) {
+							throw std::runtime_error("Cannot call gdwg::betweenness_centrality with "
+							                         "non-positive edge weights");
+						}
+					}
+				}
+				return detail::betweenness<true, E>(g, std::move(sources), options);
+			}
+		}
+		return detail::betweenness<false, std::size_t>(g, std::move(sources), options);
+	}
+
+	template<typename N, typename E>
+	auto betweenness_centrality(graph<N, E> const& g, betweenness_options const& options = {})
+	   -> betweenness_result<N> {
+		return betweenness_centrality(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_BETWEENNESS_HPP
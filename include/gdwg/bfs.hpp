@@ -0,0 +1,246 @@
+#ifndef GDWG_BFS_HPP
+#define GDWG_BFS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gdwg/bitmap.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct bfs_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Switch between top-down and bottom-up steps (needs in-edges)
+		bool direction_optimizing = true;
+
+		// Go bottom-up once the frontier's out-edges exceed the unexplored edges / alpha
+		double alpha = 15.0;
+
+		// Go back top-down once the frontier shrinks below node_count / beta
+		double beta = 18.0;
+	};
+
+	template<typename N>
+	struct bfs_result {
+		static constexpr auto unreachable = std::numeric_limits<std::size_t>::max();
+
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		// Hop count from the source, indexed by node id
+		std::vector<std::size_t> distance;
+
+		// BFS tree parent, no_node for the source and unreachable nodes
+		std::vector<node_id> parent;
+
+		std::size_t top_down_steps = 0;
+		std::size_t bottom_up_steps = 0;
+
+		[[nodiscard]] auto distance_to(N const& dst) const -> std::size_t {
+			return distance[id_of(dst)];
+		}
+
+		/* Nodes from the source to dst, empty if dst is unreachable */
+		[[nodiscard]] auto path_to(N const& dst) const -> std::vector<N> {
+			auto id = id_of(dst);
+			if (distance[id] == unreachable) {
+				return {};
+			}
+
+			auto path = std::vector<N>();
+			for (; id != no_node; id = parent[id]) {
+				path.push_back((*nodes)[id]);
+			}
+			std::reverse(path.begin(), path.end());
+			return path;
+		}
+
+	private:
+		[[nodiscard]] auto id_of(N const& value) const -> node_id {
+			auto const id = detail::find_node(*nodes, value);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::bfs_result<N>::distance_to or path_to on a "
+				                         "node that doesn't exist in the graph");
+			}
+			return id;
+		}
+	};
+
+	namespace detail {
+		// Frontier slice handled by one task in a top-down step
+		inline constexpr auto bfs_top_down_block = std::size_t{256};
+
+		// Bitmap words handled by one task in a bottom-up step
+		inline constexpr auto bfs_bottom_up_words = std::size_t{16};
+
+		/* Expand every frontier node's out-edges, claiming unvisited targets with a CAS on their
+		 * distance. Each block collects its discoveries separately and the blocks are joined in
+		 * order, so a sequential run visits nodes in plain queue order. */
+		template<typename N, typename E>
+		auto bfs_top_down(csr_graph<N, E> const& g,
+		                  std::vector<node_id> const& frontier,
+		                  std::size_t depth,
+		                  bfs_result<N>& result,
+		                  thread_pool* pool) -> std::vector<node_id> {
+			auto const blocks = (frontier.size() + bfs_top_down_block - 1) / bfs_top_down_block;
+			auto found = std::vector<std::vector<node_id>>(blocks);
+
+			detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+				auto const last = std::min(frontier.size(), (b + 1) * bfs_top_down_block);
+				for (auto i = b * bfs_top_down_block; i < last; ++i) {
+					auto const u = frontier[i];
+					for (auto const v : g.targets(u)) {
+						auto dist = std::atomic_ref<std::size_t>(result.distance[v]);
+						auto expected = bfs_result<N>::unreachable;
+						if (dist.load(std::memory_order_relaxed) != expected
+						    or not dist.compare_exchange_strong(expected, depth + 1)) {
+							continue;
+						}
+						result.parent[v] = u;
+						found[b].push_back(v);
+					}
+				}
+			});
+
+			auto next = std::vector<node_id>();
+			for (auto const& block : found) {
+				next.insert(next.end(), block.begin(), block.end());
+			}
+			return next;
+		}
+
+		/* Every unvisited node looks for any in-neighbour in the frontier and stops at the first.
+		 * Tasks own whole bitmap words, so no atomics are needed. Returns the number of nodes
+		 * found and their total out-degree. */
+		template<typename N, typename E>
+		auto bfs_bottom_up(csr_graph<N, E> const& g,
+		                   bitmap const& frontier,
+		                   bitmap& next,
+		                   std::size_t depth,
+		                   bfs_result<N>& result,
+		                   thread_pool* pool) -> std::pair<std::size_t, std::size_t> {
+			auto const words = next.words().size();
+			auto const blocks = (words + bfs_bottom_up_words - 1) / bfs_bottom_up_words;
+			auto counts = std::vector<std::pair<std::size_t, std::size_t>>(blocks);
+
+			detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+				auto const first = b * bfs_bottom_up_words * bitmap::word_bits;
+				auto const last = std::min(g.node_count(), first + bfs_bottom_up_words * bitmap::word_bits);
+				for (auto v = first; v < last; ++v) {
+					if (result.distance[v] != bfs_result<N>::unreachable) {
+						continue;
+					}
+
+					for (auto const u : g.sources(static_cast<node_id>(v))) {
+						if (frontier.test(u)) {
+							result.distance[v] = depth + 1;
+							result.parent[v] = u;
+							next.set(v);
+							++counts[b].first;
+							counts[b].second += g.out_degree(static_cast<node_id>(v));
+							break;
+						}
+					}
+				}
+			});
+
+			auto total = std::pair<std::size_t, std::size_t>{0, 0};
+			for (auto const& [found, degree] : counts) {
+				total.first += found;
+				total.second += degree;
+			}
+			return total;
+		}
+	} // namespace detail
+
+	/* Hop distances and a BFS tree from src. With a pool, every level is expanded in parallel;
+	 * with direction_optimizing and in-edges in the snapshot, dense levels are run bottom-up
+	 * over bitmap frontiers (Beamer et al.). */
+	template<typename N, typename E>
+	auto bfs(csr_graph<N, E> const& g, N const& src, bfs_options const& options = {})
+	   -> bfs_result<N> {
+		auto const source = g.find(src);
+		if (source == no_node) {
+			throw std::runtime_error("Cannot call gdwg::bfs if src doesn't exist in the graph");
+		}
+
+		auto const n = g.node_count();
+		auto result = bfs_result<N>{g.node_table(),
+		                            std::vector<std::size_t>(n, bfs_result<N>::unreachable),
+		                            std::vector<node_id>(n, no_node)};
+		result.distance[source] = 0;
+
+		auto const can_go_bottom_up = options.direction_optimizing and g.has_in_edges();
+		auto queue = std::vector<node_id>{source};
+		auto frontier = bitmap(can_go_bottom_up ? n : 0);
+		auto next = bitmap(can_go_bottom_up ? n : 0);
+		auto frontier_size = std::size_t{1};
+		auto frontier_edges = g.out_degree(source);
+		auto unexplored_edges = g.edge_count();
+		auto bottom_up = false;
+
+		for (auto depth = std::size_t{0}; frontier_size > 0; ++depth) {
+			if (can_go_bottom_up) {
+				if (not bottom_up
+				    and static_cast<double>(frontier_edges)
+				           > static_cast<double>(unexplored_edges) / options.alpha) {
+					frontier.clear();
+					for (auto const u : queue) {
+						frontier.set(u);
+					}
+					bottom_up = true;
+				}
+				else if (bottom_up
+				         and static_cast<double>(frontier_size)
+				                < static_cast<double>(n) / options.beta) {
+					queue.clear();
+					frontier.for_each([&](std::size_t u) { queue.push_back(static_cast<node_id>(u)); });
+					bottom_up = false;
+				}
+			}
+
+			unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+			if (bottom_up) {
+				++result.bottom_up_steps;
+				next.clear();
+				std::tie(frontier_size, frontier_edges) =
+				   detail::bfs_bottom_up(g, frontier, next, depth, result, options.pool);
+				swap(frontier, next);
+			}
+			else {
+				++result.top_down_steps;
+				queue = detail::bfs_top_down(g, queue, depth, result, options.pool);
+				frontier_size = queue.size();
+				frontier_edges = 0;
+				for (auto const u : queue) {
+					frontier_edges += g.out_degree(u);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	/* Freezes g first; bottom-up steps need the in-edges only the snapshot has */
+	template<typename N, typename E>
+	auto bfs(graph<N, E> const& g, N const& src, bfs_options const& options = {}) -> bfs_result<N> {
+		if (not g.is_node(src)) {
+			throw std::runtime_error("Cannot call gdwg::bfs if src doesn't exist in the graph");
+		}
+
+		auto const direction = options.direction_optimizing ? adjacency::in_and_out : adjacency::out;
+		return bfs(csr_graph<N, E>(g, direction), src, options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_BFS_HPP
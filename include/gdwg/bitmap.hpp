@@ -0,0 +1,86 @@
+#ifndef GDWG_BITMAP_HPP
+#define GDWG_BITMAP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gdwg {
+	/* Fixed-size bit set over node ids, used for dense frontiers and visited sets. Parallel code
+	 * that splits work on 64-bit word boundaries can use the plain setters; everything else must
+	 * use set_atomic. */
+	class bitmap {
+	public:
+		static constexpr auto word_bits = std::size_t{64};
+
+		bitmap() = default;
+
+		explicit bitmap(std::size_t size)
+		: words_((size + word_bits - 1) / word_bits, 0)
+		, size_{size} {}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return size_;
+		}
+
+		[[nodiscard]] auto test(std::size_t i) const -> bool {
+			return ((words_[i / word_bits] >> (i % word_bits)) & 1U) != 0;
+		}
+
+		auto set(std::size_t i) -> void {
+			words_[i / word_bits] |= std::uint64_t{1} << (i % word_bits);
+		}
+
+		/* Returns true if this call changed the bit */
+		auto set_atomic(std::size_t i) -> bool {
+			auto const mask = std::uint64_t{1} << (i % word_bits);
+			auto word = std::atomic_ref<std::uint64_t>(words_[i / word_bits]);
+			return (word.fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
+		}
+
+		auto clear() noexcept -> void {
+			std::fill(words_.begin(), words_.end(), 0);
+		}
+
+		[[nodiscard]] auto count() const noexcept -> std::size_t {
+			auto total = std::size_t{0};
+			for (auto const w : words_) {
+				total += static_cast<std::size_t>(std::popcount(w));
+			}
+			return total;
+		}
+
+		/* Call f(i) for every set bit, ascending */
+		template<typename F>
+		auto for_each(F const& f) const -> void {
+			for (auto w = std::size_t{0}; w < words_.size(); ++w) {
+				for (auto bits = words_[w]; bits != 0; bits &= bits - 1) {
+					f(w * word_bits + static_cast<std::size_t>(std::countr_zero(bits)));
+				}
+			}
+		}
+
+		[[nodiscard]] auto words() noexcept -> std::span<std::uint64_t> {
+			return words_;
+		}
+
+		[[nodiscard]] auto words() const noexcept -> std::span<std::uint64_t const> {
+			return words_;
+		}
+
+		friend auto swap(bitmap& lhs, bitmap& rhs) noexcept -> void {
+			std::swap(lhs.words_, rhs.words_);
+			std::swap(lhs.size_, rhs.size_);
+		}
+
+	private:
+		std::vector<std::uint64_t> words_;
+		std::size_t size_ = 0;
+	};
+} // namespace gdwg
+
+#endif // GDWG_BITMAP_HPP
@@ -0,0 +1,418 @@
+#ifndef GDWG_COMPONENTS_HPP
+#define GDWG_COMPONENTS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "gdwg/bitmap.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct scc_options {
+		// nullptr runs Tarjan on the calling thread; otherwise the parallel variant (needs in-edges)
+		thread_pool* pool = nullptr;
+	};
+
+	template<typename N>
+	struct scc_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		// Component of each node id. Components are numbered by their smallest node, so every
+		// algorithm gives the same numbering.
+		std::vector<std::size_t> component;
+
+		std::size_t count = 0;
+
+		[[nodiscard]] auto component_of(N const& value) const -> std::size_t {
+			auto const id = detail::find_node(*nodes, value);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::scc_result<N>::component_of on a node that "
+				                         "doesn't exist in the graph");
+			}
+			return component[id];
+		}
+
+		/* Nodes of component c, ascending */
+		[[nodiscard]] auto members(std::size_t c) const -> std::vector<N> {
+			auto result = std::vector<N>();
+			for (auto id = std::size_t{0}; id < component.size(); ++id) {
+				if (component[id] == c) {
+					result.push_back((*nodes)[id]);
+				}
+			}
+			return result;
+		}
+	};
+
+	namespace detail {
+		// Below this many undecided nodes the parallel variant hands over to Tarjan
+		inline constexpr auto scc_serial_cutoff = std::size_t{4096};
+
+		// Frontier slice handled by one task
+		inline constexpr auto scc_block = std::size_t{256};
+
+		/* Iterative Tarjan over the nodes in order whose representative is still no_node, ignoring
+		 * edges to decided nodes. Each component found gets its root as representative. */
+		template<typename N, typename E>
+		auto tarjan(csr_graph<N, E> const& g,
+		            std::vector<node_id> const& order,
+		            std::vector<node_id>& representative) -> void {
+			constexpr auto unvisited = std::numeric_limits<std::size_t>::max();
+			auto const n = g.node_count();
+			auto index = std::vector<std::size_t>(n, unvisited);
+			auto low = std::vector<std::size_t>(n, 0);
+			auto on_stack = std::vector<bool>(n, false);
+			auto stack = std::vector<node_id>();
+
+			// (node, next out-edge) for the explicit recursion
+			auto calls = std::vector<std::pair<node_id, std::size_t>>();
+			auto next_index = std::size_t{0};
+
+			auto const visit = [&](node_id u) {
+				index[u] = low[u] = next_index++;
+				stack.push_back(u);
+				on_stack[u] = true;
+				calls.emplace_back(u, 0);
+			};
+
+			for (auto const root : order) {
+				if (index[root] != unvisited or representative[root] != no_node) {
+					continue;
+				}
+				visit(root);
+
+				while (not calls.empty()) {
+					auto& [u, edge] = calls.back();
+					auto const targets = g.targets(u);
+					if (edge < targets.size()) {
+						auto const v = targets[edge++];
+						if (representative[v] != no_node) {
+							continue;
+						}
+						if (index[v] == unvisited) {
+							visit(v);
+						}
+						else if (on_stack[v]) {
+							low[u] = std::min(low[u], index[v]);
+						}
+						continue;
+					}
+
+					auto const finished = u;
+					calls.pop_back();
+					if (not calls.empty()) {
+						auto const parent = calls.back().first;
+						low[parent] = std::min(low[parent], low[finished]);
+					}
+
+					if (low[finished] == index[finished]) {
+						auto v = no_node;
+						do {
+							v = stack.back();
+							stack.pop_back();
+							on_stack[v] = false;
+							representative[v] = finished;
+						} while (v != finished);
+					}
+				}
+			}
+		}
+
+		/* Level-synchronous parallel search from frontier. next(u) gives the neighbours to follow
+		 * and claim(u, v) decides, atomically, whether v joins the search. */
+		template<typename Next, typename Claim>
+		auto parallel_search(std::vector<node_id> frontier, Next const& next, Claim const& claim, thread_pool* pool)
+		   -> void {
+			while (not frontier.empty()) {
+				auto const blocks = (frontier.size() + scc_block - 1) / scc_block;
+				auto found = std::vector<std::vector<node_id>>(blocks);
+				detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+					auto const last = std::min(frontier.size(), (b + 1) * scc_block);
+					for (auto i = b * scc_block; i < last; ++i) {
+						auto const u = frontier[i];
+						for (auto const v : next(u)) {
+							if (claim(u, v)) {
+								found[b].push_back(v);
+							}
+						}
+					}
+				});
+
+				frontier.clear();
+				for (auto const& block : found) {
+					frontier.insert(frontier.end(), block.begin(), block.end());
+				}
+			}
+		}
+
+		/* Claims v for representative r if v is still undecided */
+		inline auto claim_node(std::vector<node_id>& representative, node_id v, node_id r) -> bool {
+			auto expected = no_node;
+			return std::atomic_ref<node_id>(representative[v]).compare_exchange_strong(expected, r);
+		}
+
+		inline auto undecided(std::vector<node_id> const& representative, node_id v) -> bool {
+			return std::atomic_ref<node_id const>(representative[v]).load(std::memory_order_relaxed)
+			       == no_node;
+		}
+
+		/* Repeatedly peel off undecided nodes with no undecided predecessor or successor; each is
+		 * its own component. Degrees are counted once and then decremented as nodes go, so a
+		 * whole chain is peeled in O(V + E). */
+		template<typename N, typename E>
+		auto trim(csr_graph<N, E> const& g,
+		          std::vector<node_id> const& active,
+		          std::vector<node_id>& representative,
+		          thread_pool* pool) -> void {
+			auto in = std::vector<std::size_t>(g.node_count(), 0);
+			auto out = std::vector<std::size_t>(g.node_count(), 0);
+			auto const count = [&](node_id u, std::span<node_id const> neighbours) {
+				return static_cast<std::size_t>(std::count_if(neighbours.begin(), neighbours.end(), [&](node_id v) {
+					return v != u and representative[v] == no_node;
+				}));
+			};
+			detail::for_range(pool, 0, active.size(), scc_block, [&](std::size_t i) {
+				auto const u = active[i];
+				in[u] = count(u, g.sources(u));
+				out[u] = count(u, g.targets(u));
+			});
+
+			auto frontier = std::vector<node_id>();
+			for (auto const u : active) {
+				if (in[u] == 0 or out[u] == 0) {
+					representative[u] = u;
+					frontier.push_back(u);
+				}
+			}
+
+			auto const release = [&](std::vector<std::size_t>& degree, node_id u, node_id v) {
+				if (v == u or not undecided(representative, v)) {
+					return false;
+				}
+				auto const left = std::atomic_ref<std::size_t>(degree[v]).fetch_sub(1, std::memory_order_relaxed) - 1;
+				return left == 0 and claim_node(representative, v, v);
+			};
+
+			// Both directions share one frontier; a node is queued by whichever degree hits zero first
+			while (not frontier.empty()) {
+				auto next = std::vector<node_id>();
+				auto const blocks = (frontier.size() + scc_block - 1) / scc_block;
+				auto found = std::vector<std::vector<node_id>>(blocks);
+				detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+					auto const last = std::min(frontier.size(), (b + 1) * scc_block);
+					for (auto i = b * scc_block; i < last; ++i) {
+						auto const u = frontier[i];
+						for (auto const v : g.targets(u)) {
+							if (release(in, u, v)) {
+								found[b].push_back(v);
+							}
+						}
+						for (auto const v : g.sources(u)) {
+							if (release(out, u, v)) {
+								found[b].push_back(v);
+							}
+						}
+					}
+				});
+				for (auto const& block : found) {
+					next.insert(next.end(), block.begin(), block.end());
+				}
+				frontier = std::move(next);
+			}
+		}
+
+		/* Number components by their smallest node */
+		template<typename N>
+		auto canonical_components(std::shared_ptr<std::vector<N> const> nodes,
+		                          std::vector<node_id> const& representative) -> scc_result<N> {
+			constexpr auto unnumbered = std::numeric_limits<std::size_t>::max();
+			auto result = scc_result<N>{std::move(nodes), std::vector<std::size_t>(representative.size())};
+			auto number = std::vector<std::size_t>(representative.size(), unnumbered);
+			for (auto v = std::size_t{0}; v < representative.size(); ++v) {
+				auto& c = number[representative[v]];
+				if (c == unnumbered) {
+					c = result.count++;
+				}
+				result.component[v] = c;
+			}
+			return result;
+		}
+
+		/* Multistep (Slota, Rajamanickam and Madduri): trim, one forward-backward search from a
+		 * high-degree pivot to take out the giant component, then rounds of colour propagation
+		 * until few enough nodes are left for Tarjan. */
+		template<typename N, typename E>
+		auto parallel_scc(csr_graph<N, E> const& g, std::vector<node_id>& representative, thread_pool* pool)
+		   -> void {
+			auto const n = g.node_count();
+			auto active = std::vector<node_id>(n);
+			for (auto v = node_id{0}; v < n; ++v) {
+				active[v] = v;
+			}
+			auto const refresh = [&] {
+				std::erase_if(active, [&](node_id v) { return representative[v] != no_node; });
+			};
+
+			trim(g, active, representative, pool);
+			refresh();
+			if (active.empty()) {
+				return;
+			}
+
+			// Forward-backward from the node most likely to sit in a large component
+			auto const pivot = *std::max_element(active.begin(), active.end(), [&](node_id a, node_id b) {
+				return g.in_degree(a) * g.out_degree(a) < g.in_degree(b) * g.out_degree(b);
+			});
+			auto forward = bitmap(n);
+			forward.set(pivot);
+			parallel_search(
+			   {pivot},
+			   [&](node_id u) { return g.targets(u); },
+			   [&](node_id, node_id v) { return representative[v] == no_node and forward.set_atomic(v); },
+			   pool);
+			representative[pivot] = pivot;
+			parallel_search(
+			   {pivot},
+			   [&](node_id u) { return g.sources(u); },
+			   [&](node_id, node_id v) { return forward.test(v) and claim_node(representative, v, pivot); },
+			   pool);
+			refresh();
+
+			auto colour = std::vector<node_id>(n);
+			auto queued = bitmap(n);
+			while (active.size() > scc_serial_cutoff) {
+				trim(g, active, representative, pool);
+				refresh();
+
+				// Every node ends up with the largest id that reaches it
+				detail::for_range(pool, 0, active.size(), scc_block, [&](std::size_t i) {
+					colour[active[i]] = active[i];
+				});
+				auto frontier = active;
+				while (not frontier.empty()) {
+					queued.clear();
+					auto next = std::vector<node_id>();
+					auto const blocks = (frontier.size() + scc_block - 1) / scc_block;
+					auto found = std::vector<std::vector<node_id>>(blocks);
+					detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+						auto const last = std::min(frontier.size(), (b + 1) * scc_block);
+						for (auto i = b * scc_block; i < last; ++i) {
+							auto const u = frontier[i];
+							auto const c = std::atomic_ref<node_id>(colour[u]).load(std::memory_order_relaxed);
+							for (auto const v : g.targets(u)) {
+								if (representative[v] != no_node) {
+									continue;
+								}
+								auto target = std::atomic_ref<node_id>(colour[v]);
+								auto current = target.load(std::memory_order_relaxed);
+								auto raised = false;
+								while (current < c and not raised) {
+									raised = target.compare_exchange_weak(current, c, std::memory_order_relaxed);
+								}
+								if (raised and queued.set_atomic(v)) {
+									found[b].push_back(v);
+								}
+							}
+						}
+					});
+					for (auto const& block : found) {
+						next.insert(next.end(), block.begin(), block.end());
+					}
+					frontier = std::move(next);
+				}
+
+				// A node that kept its own colour roots the component of everything that reaches
+				// back to it with the same colour
+				auto roots = std::vector<node_id>();
+				for (auto const v : active) {
+					if (colour[v] == v) {
+						representative[v] = v;
+						roots.push_back(v);
+					}
+				}
+				parallel_search(
+				   std::move(roots),
+				   [&](node_id u) { return g.sources(u); },
+				   [&](node_id u, node_id v) {
+					   return colour[v] == colour[u] and claim_node(representative, v, colour[u]);
+				   },
+				   pool);
+				refresh();
+			}
+
+			tarjan(g, active, representative);
+		}
+	} // namespace detail
+
+	/* Strongly connected components in O(V + E). Sequentially this is an iterative Tarjan, so
+	 * deep graphs can't overflow the stack. With a pool it runs the Multistep algorithm, which
+	 * needs a snapshot with in-edges. */
+	template<typename N, typename E>
+	auto strongly_connected_components(csr_graph<N, E> const& g, scc_options const& options = {})
+	   -> scc_result<N> {
+		auto representative = std::vector<node_id>(g.node_count(), no_node);
+		if (options.pool == nullptr) {
+			auto order = std::vector<node_id>(g.node_count());
+			for (auto v = node_id{0}; v < g.node_count(); ++v) {
+				order[v] = v;
+			}
+			detail::tarjan(g, order, representative);
+		}
+		else {
+			if (not g.has_in_edges()) {
+				throw std::runtime_error("Cannot call gdwg::strongly_connected_components in parallel on "
+				                         "a snapshot without in-edges");
+			}
+			detail::parallel_scc(g, representative, options.pool);
+		}
+		return detail::canonical_components(g.node_table(), representative);
+	}
+
+	template<typename N, typename E>
+	auto strongly_connected_components(graph<N, E> const& g, scc_options const& options = {})
+	   -> scc_result<N> {
+		auto const kind = options.pool == nullptr ? adjacency::out : adjacency::in_and_out;
+		return strongly_connected_components(csr_graph<N, E>(g, kind), options);
+	}
+
+	/* The condensation DAG: one node per component id and, for every edge between two different
+	 * components, an edge between their ids with the same weight. Equal weights between the same
+	 * pair of components collapse into one edge. */
+	template<typename N, typename E>
+	auto condensation(csr_graph<N, E> const& g, scc_result<N> const& components)
+	   -> graph<std::size_t, E> {
+		auto dag = graph<std::size_t, E>();
+		for (auto c = std::size_t{0}; c < components.count; ++c) {
+			dag.insert_node(c);
+		}
+		for (auto u = node_id{0}; u < g.node_count(); ++u) {
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				auto const from = components.component[u];
+				auto const to = components.component[targets[e]];
+				if (from != to) {
+					dag.insert_edge(from, to, weights[e]);
+				}
+			}
+		}
+		return dag;
+	}
+
+	template<typename N, typename E>
+	auto condensation(graph<N, E> const& g, scc_options const& options = {}) -> graph<std::size_t, E> {
+		auto const csr = csr_graph<N, E>(g, options.pool == nullptr ? adjacency::out : adjacency::in_and_out);
+		return condensation(csr, strongly_connected_components(csr, options));
+	}
+} // namespace gdwg
+
+#endif // GDWG_COMPONENTS_HPP
@@ -0,0 +1,311 @@
+#ifndef GDWG_COMPRESSED_GRAPH_HPP
+#define GDWG_COMPRESSED_GRAPH_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	struct compression_options {
+		// 0 keeps weights exact; 8 or 16 stores each one as a code of that many bits spread
+		// evenly over [min, max]. Integral weights whose range fits the codes stay exact.
+		unsigned weight_bits = 0;
+	};
+
+	namespace detail {
+		/* Signed distance from a to b, modulo 2^32, folded so small distances either way are small */
+		inline auto zigzag_gap(node_id from, node_id to) -> std::uint32_t {
+			auto const gap = static_cast<std::int32_t>(to - from);
+			return (static_cast<std::uint32_t>(gap) << 1U) ^ static_cast<std::uint32_t>(gap >> 31);
+		}
+
+		inline auto unzigzag_gap(node_id from, std::uint32_t folded) -> node_id {
+			return from + ((folded >> 1U) ^ (0U - (folded & 1U)));
+		}
+
+		inline auto varint_bytes(std::uint32_t value) -> unsigned {
+			return value < (1U << 8U) ? 1U : value < (1U << 16U) ? 2U : value < (1U << 24U) ? 3U : 4U;
+		}
+
+		/* Little-endian value of length bytes at p. Streams are padded, so reading a whole word
+		 * past the value is always in bounds. */
+		inline auto read_varint(std::uint8_t const* p, unsigned length) -> std::uint32_t {
+			if constexpr (std::endian::native == std::endian::little) {
+				auto word = std::uint32_t{0};
+				std::memcpy(&word, p, sizeof(word));
+				return length == 4 ? word : word & ((1U << (8U * length)) - 1U);
+			}
+			else {
+				auto value = std::uint32_t{0};
+				for (auto i = 0U; i < length; ++i) {
+					value |= std::uint32_t{p[i]} << (8U * i);
+				}
+				return value;
+			}
+		}
+	} // namespace detail
+
+	/* A read-only snapshot whose adjacency is compressed for graphs too large for csr_graph. Each
+	 * row keeps csr_graph's order, sorted by destination, and is stored as gaps between
+	 * successive destinations; the first is taken from the source itself, so rows of nearby ids
+	 * start small too. Gaps are written stream-vbyte style: a control byte gives the byte length,
+	 * 1 to 4, of the next four gaps, which follow back to back. Decoding a gap is one word load
+	 * and a mask, with no branch per byte as in LEB128.
+	 *
+	 * Rows are decoded front to back only, so neighbours are visited with for_each_target or
+	 * for_each_edge rather than through a span. Weights are kept exact, or quantised to 8 or 16
+	 * bits when E is arithmetic. */
+	template<typename N, typename E>
+	class compressed_graph {
+	public:
+		using node_id = gdwg::node_id;
+
+		compressed_graph() = default;
+
+		explicit compressed_graph(graph<N, E> const& g, compression_options const& options = {})
+		: compressed_graph(csr_graph<N, E>(g), options) {}
+
+		/* O(V + E) over the snapshot's rows */
+		explicit compressed_graph(csr_graph<N, E> const& csr, compression_options const& options = {})
+		: nodes_{csr.node_table()} {
+			if (options.weight_bits != 0 and options.weight_bits != 8 and options.weight_bits != 16) {
+				throw std::runtime_error("Cannot construct gdwg::compressed_graph<N, E> with weight_bits "
+				                         "other than 0, 8 or 16");
+			}
+
+			auto const n = csr.node_count();
+			edge_deltas_.reserve(n + 1);
+			byte_deltas_.reserve(n + 1);
+			push_row_start(0, 0);
+			for (auto src = node_id{0}; src < n; ++src) {
+				auto const row = csr.targets(src);
+				auto previous = src;
+				for (auto i = std::size_t{0}; i < row.size(); i += 4) {
+					auto const control_at = bytes_.size();
+					bytes_.push_back(0);
+					auto control = 0U;
+					for (auto j = 0U; j < 4 and i + j < row.size(); ++j) {
+						auto const gap = i + j == 0 ? detail::zigzag_gap(src, row[0]) : row[i + j] - previous;
+						previous = row[i + j];
+						auto const length = detail::varint_bytes(gap);
+						control |= (length - 1) << (2 * j);
+						for (auto b = 0U; b < length; ++b) {
+							bytes_.push_back(static_cast<std::uint8_t>(gap >> (8 * b)));
+						}
+					}
+					bytes_[control_at] = static_cast<std::uint8_t>(control);
+				}
+				push_row_start(csr.offsets()[src + 1], bytes_.size());
+			}
+			// Padding for the word-sized loads in read_varint
+			bytes_.resize(bytes_.size() + sizeof(std::uint32_t));
+			bytes_.shrink_to_fit();
+
+			encode_weights(csr.weights(), options.weight_bits);
+		}
+
+		// Accessors
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return edge_deltas_.empty() ? 0 : edge_deltas_.size() - 1;
+		}
+
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return empty() ? 0 : edge_offset(node_count());
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return node_count() == 0;
+		}
+
+		[[nodiscard]] auto node(node_id id) const -> N const& {
+			return (*nodes_)[id];
+		}
+
+		/* log(n). no_node if value is not a node */
+		[[nodiscard]] auto find(N const& value) const -> node_id {
+			return nodes_ ? detail::find_node(*nodes_, value) : no_node;
+		}
+
+		[[nodiscard]] auto out_degree(node_id id) const -> std::size_t {
+			return edge_offset(id + std::size_t{1}) - edge_offset(id);
+		}
+
+		/* Calls f(dst) for id's out-edges in csr_graph order */
+		template<typename F>
+		auto for_each_target(node_id id, F&& f) const -> void {
+			auto const* p = bytes_.data() + byte_blocks_[id / block_rows] + byte_deltas_[id];
+			auto remaining = out_degree(id);
+			auto previous = id;
+			auto first = true;
+			while (remaining != 0) {
+				auto const control = *p++;
+				auto const group = std::min(remaining, std::size_t{4});
+				for (auto j = 0U; j < group; ++j) {
+					auto const length = ((control >> (2 * j)) & 3U) + 1;
+					auto const gap = detail::read_varint(p, length);
+					p += length;
+					previous = first ? detail::unzigzag_gap(id, gap) : previous + gap;
+					first = false;
+					f(previous);
+				}
+				remaining -= group;
+			}
+		}
+
+		/* Calls f(dst, weight) for id's out-edges in csr_graph order */
+		template<typename F>
+		auto for_each_edge(node_id id, F&& f) const -> void {
+			auto e = edge_offset(id);
+			for_each_target(id, [&](node_id dst) { f(dst, weight(e++)); });
+		}
+
+		/* Decodes id's destinations into out, replacing what was there */
+		auto decode_targets(node_id id, std::vector<node_id>& out) const -> void {
+			out.clear();
+			out.reserve(out_degree(id));
+			for_each_target(id, [&out](node_id dst) { out.push_back(dst); });
+		}
+
+		[[nodiscard]] auto targets(node_id id) const -> std::vector<node_id> {
+			auto out = std::vector<node_id>();
+			decode_targets(id, out);
+			return out;
+		}
+
+		/* Weight of the e-th edge in row order; approximate if quantised */
+		[[nodiscard]] auto weight(std::size_t e) const -> E {
+			if constexpr (std::is_arithmetic_v<E>) {
+				if (code_bytes_ != 0) {
+					auto code = std::uint16_t{0};
+					if (code_bytes_ == 1) {
+						code = codes_[e];
+					}
+					else {
+						std::memcpy(&code, codes_.data() + 2 * e, sizeof(code));
+					}
+					auto const value = static_cast<double>(weight_min_) + code * weight_step_;
+					if constexpr (std::is_integral_v<E>) {
+						return static_cast<E>(std::llround(value));
+					}
+					else {
+						return static_cast<E>(value);
+					}
+				}
+			}
+			return weights_[e];
+		}
+
+		[[nodiscard]] auto weights_quantised() const noexcept -> bool {
+			return code_bytes_ != 0;
+		}
+
+		/* Largest difference between a stored weight and the original, 0 when exact. Integral
+		 * weights are rounded again on decode, which can add up to half a unit. */
+		[[nodiscard]] auto max_weight_error() const noexcept -> double {
+			if (code_bytes_ == 0 or exact_codes_) {
+				return 0.0;
+			}
+			return std::is_integral_v<E> ? weight_step_ / 2 + 0.5 : weight_step_ / 2;
+		}
+
+		// Footprint
+		/* Bytes of adjacency and weights, offsets included, excluding node values */
+		[[nodiscard]] auto edge_bytes() const noexcept -> std::size_t {
+			return bytes_.size() + codes_.size() + weights_.size() * sizeof(E)
+			       + (edge_blocks_.size() + byte_blocks_.size()) * sizeof(std::uint64_t)
+			       + (edge_deltas_.size() + byte_deltas_.size()) * sizeof(std::uint32_t);
+		}
+
+		/* edge_bytes() over edge_count(); csr_graph spends sizeof(node_id) + sizeof(E) plus its
+		 * offsets */
+		[[nodiscard]] auto bytes_per_edge() const noexcept -> double {
+			return edge_count() == 0 ? 0.0
+			                         : static_cast<double>(edge_bytes()) / static_cast<double>(edge_count());
+		}
+
+	private:
+		// Row starts, as edge index and byte offset: absolute every block_rows rows and 32-bit
+		// offsets from that in between, about 8 bytes a row rather than 16
+		static constexpr auto block_rows = std::size_t{64};
+
+		std::shared_ptr<std::vector<N> const> nodes_;
+		std::vector<std::uint64_t> edge_blocks_;
+		std::vector<std::uint32_t> edge_deltas_;
+		std::vector<std::uint64_t> byte_blocks_;
+		std::vector<std::uint32_t> byte_deltas_;
+		std::vector<std::uint8_t> bytes_;
+
+		// Exact weights, or codes of code_bytes_ each
+		std::vector<E> weights_;
+		std::vector<std::uint8_t> codes_;
+		unsigned code_bytes_ = 0;
+		bool exact_codes_ = false;
+		E weight_min_{};
+		double weight_step_ = 0;
+
+		[[nodiscard]] auto edge_offset(std::size_t row) const -> std::size_t {
+			return static_cast<std::size_t>(edge_blocks_[row / block_rows] + edge_deltas_[row]);
+		}
+
+		auto push_row_start(std::uint64_t edge, std::uint64_t byte) -> void {
+			if (edge_deltas_.size() % block_rows == 0) {
+				edge_blocks_.push_back(edge);
+				byte_blocks_.push_back(byte);
+			}
+			auto const edge_delta = edge - edge_blocks_.back();
+			auto const byte_delta = byte - byte_blocks_.back();
+			if (std::max(edge_delta, byte_delta) > std::numeric_limits<std::uint32_t>::max()) {
+				throw std::runtime_error("Cannot construct gdwg::compressed_graph<N, E> with more than "
+				                         "2^32 - 1 edges in 64 consecutive rows");
+			}
+			edge_deltas_.push_back(static_cast<std::uint32_t>(edge_delta));
+			byte_deltas_.push_back(static_cast<std::uint32_t>(byte_delta));
+		}
+
+		template<typename Weights>
+		auto encode_weights(Weights const& weights, unsigned bits) -> void {
+			if (bits == 0 or weights.empty()) {
+				weights_.assign(weights.begin(), weights.end());
+				return;
+			}
+			if constexpr (not std::is_arithmetic_v<E>) {
+				throw std::runtime_error("Cannot construct gdwg::compressed_graph<N, E> with quantised "
+				                         "weights unless E is arithmetic");
+			}
+			else {
+				auto const [low, high] = std::minmax_element(weights.begin(), weights.end());
+				auto const levels = static_cast<double>((1U << bits) - 1);
+				auto const range = static_cast<double>(*high) - static_cast<double>(*low);
+				weight_min_ = *low;
+				exact_codes_ = std::is_integral_v<E> and range <= levels;
+				weight_step_ = exact_codes_ ? 1.0 : range / levels;
+				code_bytes_ = bits / 8;
+				codes_.resize(weights.size() * code_bytes_);
+				for (auto e = std::size_t{0}; e < weights.size(); ++e) {
+					auto const offset = static_cast<double>(weights[e]) - static_cast<double>(weight_min_);
+					auto const code = weight_step_ == 0 ? std::uint16_t{0}
+					                                    : static_cast<std::uint16_t>(std::lround(offset / weight_step_));
+					if (code_bytes_ == 1) {
+						codes_[e] = static_cast<std::uint8_t>(code);
+					}
+					else {
+						std::memcpy(codes_.data() + 2 * e, &code, sizeof(code));
+					}
+				}
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_COMPRESSED_GRAPH_HPP
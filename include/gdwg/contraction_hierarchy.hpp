@@ -0,0 +1,720 @@
+#ifndef GDWG_CONTRACTION_HIERARCHY_HPP
+#define GDWG_CONTRACTION_HIERARCHY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/heap.hpp"
+#include "gdwg/serialize.hpp"
+#include "gdwg/shortest_paths.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct contraction_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+	};
+
+	/* A customizable contraction hierarchy for point-to-point routing on non-negative arithmetic
+	 * weights.
+	 *
+	 * Preprocessing is split in two. Contraction picks an elimination order and adds every fill-in
+	 * arc the order implies, ignoring weights, so the structure only depends on which node pairs
+	 * are adjacent. Each round contracts an independent set of nodes that have minimum degree in
+	 * their neighbourhood, in parallel. Customization then computes both directed weights of
+	 * every arc bottom-up through lower triangles, level by level in parallel.
+	 *
+	 * Because the structure is weight-independent, recustomize() takes the same nodes and node
+	 * pairs with new weights and only recomputes the arcs whose triangles were affected.
+	 * Queries are bidirectional upward searches, see contraction_hierarchy::query. */
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	class contraction_hierarchy {
+	public:
+		class query;
+
+		contraction_hierarchy() = default;
+
+		explicit contraction_hierarchy(graph<N, E> const& g, contraction_options const& options = {})
+		: contraction_hierarchy(csr_graph<N, E>(g), options) {}
+
+		explicit contraction_hierarchy(csr_graph<N, E> const& g, contraction_options const& options = {})
+		: nodes_{g.node_table()} {
+			contract(g, options.pool);
+			build_down_arcs();
+
+			input_up_.assign(arc_count(), infinity);
+			input_down_.assign(arc_count(), infinity);
+			load_weights(g, input_up_, input_down_);
+
+			up_.assign(arc_count(), infinity);
+			down_.assign(arc_count(), infinity);
+			middle_up_.assign(arc_count(), no_node);
+			middle_down_.assign(arc_count(), no_node);
+			auto dirty = std::vector<std::uint8_t>(node_count(), 1);
+			customize(dirty, options.pool);
+		}
+
+		/* Weight-only update: g must have the same nodes, and every pair of nodes joined by an edge
+		 * in g must have been adjacent when the hierarchy was built. Returns the number of arcs
+		 * whose weights changed. */
+		auto recustomize(graph<N, E> const& g, thread_pool* pool = nullptr) -> std::size_t {
+			auto const csr = csr_graph<N, E>(g);
+			if (csr.node_count() != node_count()
+			    or not std::equal(nodes_->begin(), nodes_->end(), csr.node_table()->begin())) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::recustomize "
+				                         "with a graph whose nodes differ");
+			}
+
+			auto up = std::vector<E>(arc_count(), infinity);
+			auto down = std::vector<E>(arc_count(), infinity);
+			load_weights(csr, up, down);
+
+			auto dirty = std::vector<std::uint8_t>(node_count(), 0);
+			for (auto v = node_id{0}; v < node_count(); ++v) {
+				for (auto a = up_offsets_[v]; a < up_offsets_[v + 1]; ++a) {
+					if (up[a] != input_up_[a] or down[a] != input_down_[a]) {
+						dirty[v] = 1;
+					}
+				}
+			}
+			input_up_ = std::move(up);
+			input_down_ = std::move(down);
+			return customize(dirty, pool);
+		}
+
+		// Accessors
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return nodes_ ? nodes_->size() : 0;
+		}
+
+		/* Original adjacencies plus shortcuts */
+		[[nodiscard]] auto arc_count() const noexcept -> std::size_t {
+			return up_targets_.size();
+		}
+
+		[[nodiscard]] auto level_count() const noexcept -> std::size_t {
+			return level_offsets_.empty() ? 0 : level_offsets_.size() - 1;
+		}
+
+		// Serialisation
+		auto save(std::ostream& os) const -> void {
+			os.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+			serializer<std::uint64_t>::write(os, node_count());
+			for (auto const& n : *nodes_) {
+				serializer<N>::write(os, n);
+			}
+			detail::write_array(os, level_);
+			detail::write_array(os, up_offsets_);
+			detail::write_array(os, up_targets_);
+			detail::write_array(os, input_up_);
+			detail::write_array(os, input_down_);
+			detail::write_array(os, up_);
+			detail::write_array(os, down_);
+			detail::write_array(os, middle_up_);
+			detail::write_array(os, middle_down_);
+
+			if (not os) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::save on a "
+				                         "stream that failed");
+			}
+		}
+
+		[[nodiscard]] static auto load(std::istream& is) -> contraction_hierarchy {
+			auto header = std::string(magic.size(), '\0');
+			is.read(header.data(), static_cast<std::streamsize>(header.size()));
+			if (not is or header != magic) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::load on a "
+				                         "stream that doesn't hold a contraction hierarchy");
+			}
+
+			auto ch = contraction_hierarchy();
+			auto nodes = std::vector<N>();
+			auto const count = serializer<std::uint64_t>::read(is);
+			for (auto i = std::uint64_t{0}; i < count and is; ++i) {
+				nodes.push_back(serializer<N>::read(is));
+			}
+			ch.nodes_ = std::make_shared<std::vector<N> const>(std::move(nodes));
+			ch.level_ = detail::read_array<std::uint32_t>(is);
+			ch.up_offsets_ = detail::read_array<std::size_t>(is);
+			ch.up_targets_ = detail::read_array<node_id>(is);
+			ch.input_up_ = detail::read_array<E>(is);
+			ch.input_down_ = detail::read_array<E>(is);
+			ch.up_ = detail::read_array<E>(is);
+			ch.down_ = detail::read_array<E>(is);
+			ch.middle_up_ = detail::read_array<node_id>(is);
+			ch.middle_down_ = detail::read_array<node_id>(is);
+
+			auto const arcs = ch.up_targets_.size();
+			if (not is or ch.level_.size() != ch.node_count()
+			    or ch.up_offsets_.size() != ch.node_count() + 1 or ch.up_offsets_.back() != arcs
+			    or ch.input_up_.size() != arcs or ch.input_down_.size() != arcs or ch.up_.size() != arcs
+			    or ch.down_.size() != arcs or ch.middle_up_.size() != arcs
+			    or ch.middle_down_.size() != arcs or not ch.consistent())
+			{
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::load on a "
+				                         "truncated or corrupt stream");
+			}
+			ch.build_levels();
+			ch.build_down_arcs();
+			return ch;
+		}
+
+	private:
+		static constexpr auto magic = std::string_view("GDWGCH01");
+		static constexpr auto infinity = detail::infinite_distance<E>();
+		static constexpr auto unassigned = std::numeric_limits<std::uint32_t>::max();
+
+		std::shared_ptr<std::vector<N> const> nodes_;
+
+		// Contraction round of each node; every arc goes from a lower to a higher level
+		std::vector<std::uint32_t> level_;
+		std::vector<std::size_t> level_offsets_;
+		std::vector<node_id> level_nodes_;
+
+		// Upward arcs, grouped by lower endpoint and sorted by higher endpoint
+		std::vector<std::size_t> up_offsets_;
+		std::vector<node_id> up_targets_;
+
+		// Downward view of the same arcs: for each node, its lower neighbours and the arc index
+		std::vector<std::size_t> down_offsets_;
+		std::vector<node_id> down_sources_;
+		std::vector<std::size_t> down_arcs_;
+
+		// Per arc: lightest original edge lower -> higher (up) and higher -> lower (down)
+		std::vector<E> input_up_;
+		std::vector<E> input_down_;
+
+		// Per arc: customized weights and the node each shortcut goes through
+		std::vector<E> up_;
+		std::vector<E> down_;
+		std::vector<node_id> middle_up_;
+		std::vector<node_id> middle_down_;
+
+		static auto add(E lhs, E rhs) -> E {
+			return lhs == infinity or rhs == infinity ? infinity : static_cast<E>(lhs + rhs);
+		}
+
+		[[nodiscard]] auto find_arc(node_id lower, node_id higher) const -> std::size_t {
+			auto const first = up_targets_.begin() + static_cast<std::ptrdiff_t>(up_offsets_[lower]);
+			auto const last = up_targets_.begin() + static_cast<std::ptrdiff_t>(up_offsets_[lower + 1]);
+			auto const it = std::lower_bound(first, last, higher);
+			return it == last or *it != higher ? arc_count()
+			                                   : static_cast<std::size_t>(it - up_targets_.begin());
+		}
+
+		/* The arc joining a and b in either orientation, and whether a is its lower end */
+		[[nodiscard]] auto arc_between(node_id a, node_id b) const -> std::pair<std::size_t, bool> {
+			return level_[a] < level_[b] ? std::pair(find_arc(a, b), true)
+			                             : std::pair(find_arc(b, a), false);
+		}
+
+		/* Parallel minimum-degree elimination on the undirected structure */
+		auto contract(csr_graph<N, E> const& g, thread_pool* pool) -> void {
+			auto const n = g.node_count();
+			auto adjacent = std::vector<std::vector<node_id>>(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto const v : g.targets(u)) {
+					if (v != u) {
+						adjacent[u].push_back(v);
+						adjacent[v].push_back(u);
+					}
+				}
+			}
+			detail::for_range(pool, 0, n, 64, [&](std::size_t u) {
+				std::sort(adjacent[u].begin(), adjacent[u].end());
+				adjacent[u].erase(std::unique(adjacent[u].begin(), adjacent[u].end()), adjacent[u].end());
+			});
+
+			// Ties are broken by a hash of the id so equal-degree runs still contract in parallel
+			auto const key = [&](node_id u) {
+				return std::tuple(adjacent[u].size(), (std::uint64_t{u} * 0x9E3779B97F4A7C15ULL) >> 32, u);
+			};
+
+			level_.assign(n, unassigned);
+			auto up_lists = std::vector<std::vector<node_id>>(n);
+			auto remaining = std::vector<node_id>(n);
+			for (auto u = node_id{0}; u < n; ++u) {
+				remaining[u] = u;
+			}
+
+			auto selected = std::vector<std::uint8_t>(n, 0);
+			auto is_touched = std::vector<std::uint8_t>(n, 0);
+			for (auto round = std::uint32_t{0}; not remaining.empty(); ++round) {
+				// A clique would otherwise give up one node per round; every order of it is as good
+				auto const clique = std::all_of(remaining.begin(), remaining.end(), [&](node_id u) {
+					return adjacent[u].size() + 1 == remaining.size();
+				});
+				if (clique) {
+					for (auto i = std::size_t{0}; i < remaining.size(); ++i) {
+						level_[remaining[i]] = round + static_cast<std::uint32_t>(i);
+						up_lists[remaining[i]].assign(remaining.begin() + static_cast<std::ptrdiff_t>(i) + 1,
+						                              remaining.end());
+					}
+					break;
+				}
+
+				detail::for_range(pool, 0, remaining.size(), 256, [&](std::size_t i) {
+					auto const u = remaining[i];
+					auto const k = key(u);
+					selected[u] = std::all_of(adjacent[u].begin(), adjacent[u].end(), [&](node_id v) {
+						return k < key(v);
+					});
+				});
+
+				auto chosen = std::vector<node_id>();
+				auto touched = std::vector<node_id>();
+				for (auto const u : remaining) {
+					if (selected[u] != 0) {
+						chosen.push_back(u);
+						level_[u] = round;
+					}
+				}
+				for (auto const u : chosen) {
+					for (auto const v : adjacent[u]) {
+						if (is_touched[v] == 0) {
+							is_touched[v] = 1;
+							touched.push_back(v);
+						}
+					}
+				}
+
+				// Neighbours of a contracted node become pairwise adjacent. Chosen nodes are never
+				// adjacent, so each touched list only reads the untouched lists of chosen nodes.
+				detail::for_range(pool, 0, touched.size(), 16, [&](std::size_t i) {
+					auto const v = touched[i];
+					auto& list = adjacent[v];
+					auto added = std::vector<node_id>();
+					for (auto const u : list) {
+						if (level_[u] == round) {
+							std::copy_if(adjacent[u].begin(),
+							             adjacent[u].end(),
+							             std::back_inserter(added),
+							             [v](node_id w) { return w != v; });
+						}
+					}
+
+					auto const contracted = [&](node_id w) { return level_[w] != unassigned; };
+					std::sort(added.begin(), added.end());
+					added.erase(std::unique(added.begin(), added.end()), added.end());
+					std::erase_if(list, contracted);
+					auto const middle = list.insert(list.end(), added.begin(), added.end());
+					std::inplace_merge(list.begin(), middle, list.end());
+					list.erase(std::unique(list.begin(), list.end()), list.end());
+					is_touched[v] = 0;
+				});
+
+				for (auto const u : chosen) {
+					up_lists[u] = std::move(adjacent[u]);
+					selected[u] = 0;
+				}
+				std::erase_if(remaining, [&](node_id u) { return level_[u] != unassigned; });
+			}
+
+			up_offsets_.assign(n + 1, 0);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				up_offsets_[u + 1] = up_offsets_[u] + up_lists[u].size();
+			}
+			up_targets_.reserve(up_offsets_.back());
+			for (auto const& list : up_lists) {
+				up_targets_.insert(up_targets_.end(), list.begin(), list.end());
+			}
+			build_levels();
+		}
+
+		/* Whether arrays of the right sizes, as load reads them, describe a hierarchy that the
+		 * searches and unpack can walk without leaving the arrays or recursing forever */
+		[[nodiscard]] auto consistent() const -> bool {
+			auto const n = node_count();
+			if (not std::is_sorted(nodes_->begin(), nodes_->end())
+			    or std::adjacent_find(nodes_->begin(), nodes_->end()) != nodes_->end())
+			{
+				return false;
+			}
+
+			// There are at most n contraction rounds
+			if (std::any_of(level_.begin(), level_.end(), [n](std::uint32_t l) { return l >= n; })) {
+				return false;
+			}
+
+			// Rows in range and in order, each arc rising a level and sorted within its row
+			if (up_offsets_.front() != 0) {
+				return false;
+			}
+			for (auto u = node_id{0}; u < n; ++u) {
+				if (up_offsets_[u] > up_offsets_[u + 1]) {
+					return false;
+				}
+				for (auto a = up_offsets_[u]; a < up_offsets_[u + 1]; ++a) {
+					auto const v = up_targets_[a];
+					auto const sorted = a == up_offsets_[u] or up_targets_[a - 1] < v;
+					if (v >= n or level_[u] >= level_[v] or not sorted) {
+						return false;
+					}
+				}
+			}
+
+			// Chordal fill-in: customize closes u's triangles through an arc v -> w for each w above v
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto a = up_offsets_[u]; a < up_offsets_[u + 1]; ++a) {
+					auto const v = up_targets_[a];
+					for (auto b = up_offsets_[u]; b < up_offsets_[u + 1]; ++b) {
+						auto const w = up_targets_[b];
+						if (level_[w] > level_[v] and find_arc(v, w) == arc_count()) {
+							return false;
+						}
+					}
+				}
+			}
+
+			// A shortcut's middle lies below both ends and has arcs to each, so unpack descends
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto a = up_offsets_[u]; a < up_offsets_[u + 1]; ++a) {
+					auto const v = up_targets_[a];
+					for (auto const middle : {middle_up_[a], middle_down_[a]}) {
+						if (middle == no_node) {
+							continue;
+						}
+						if (middle >= n or level_[middle] >= level_[u] or find_arc(middle, u) == arc_count()
+						    or find_arc(middle, v) == arc_count())
+						{
+							return false;
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		auto build_levels() -> void {
+			auto const levels = level_.empty() ? 0 : *std::max_element(level_.begin(), level_.end()) + 1;
+			level_offsets_.assign(levels + 1, 0);
+			for (auto const l : level_) {
+				++level_offsets_[l + 1];
+			}
+			for (auto l = std::size_t{1}; l < level_offsets_.size(); ++l) {
+				level_offsets_[l] += level_offsets_[l - 1];
+			}
+
+			level_nodes_.resize(level_.size());
+			auto next = std::vector<std::size_t>(level_offsets_.begin(), level_offsets_.end() - 1);
+			for (auto u = node_id{0}; u < level_.size(); ++u) {
+				level_nodes_[next[level_[u]]++] = u;
+			}
+		}
+
+		auto build_down_arcs() -> void {
+			auto const n = node_count();
+			down_offsets_.assign(n + 1, 0);
+			for (auto const v : up_targets_) {
+				++down_offsets_[v + 1];
+			}
+			for (auto v = std::size_t{1}; v <= n; ++v) {
+				down_offsets_[v] += down_offsets_[v - 1];
+			}
+
+			down_sources_.resize(arc_count());
+			down_arcs_.resize(arc_count());
+			auto next = std::vector<std::size_t>(down_offsets_.begin(), down_offsets_.end() - 1);
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto a = up_offsets_[u]; a < up_offsets_[u + 1]; ++a) {
+					auto const slot = next[up_targets_[a]]++;
+					down_sources_[slot] = u;
+					down_arcs_[slot] = a;
+				}
+			}
+		}
+
+		/* Lightest original edge per arc direction; throws if g joins a pair with no arc */
+		auto load_weights(csr_graph<N, E> const& g, std::vector<E>& up, std::vector<E>& down) const
+		   -> void {
+			for (auto u = node_id{0}; u < g.node_count(); ++u) {
+				auto const targets = g.targets(u);
+				auto const weights = g.weights(u);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					auto const v = targets[i];
+					if (v == u or (i > 0 and targets[i - 1] == v)) {
+						continue;
+					}
+
+					if (weights[i] < E{}) {
+						throw std::runtime_error("Cannot build gdwg::contraction_hierarchy<N, E> on a "
+						                         "graph with negative weights");
+					}
+
+					auto const [arc, forward] = arc_between(u, v);
+					if (arc == arc_count()) {
+						throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::"
+						                         "recustomize with an edge between nodes that weren't "
+						                         "adjacent");
+					}
+					(forward ? up : down)[arc] = weights[i];
+				}
+			}
+		}
+
+		/* Recompute the arcs of dirty nodes level by level. An arc's weights come from its original
+		 * edges and the lower triangles it closes: every lower neighbour u of v contributes a path
+		 * v -> u -> w for each w above v in up(u), and up(u) minus v is a subset of up(v) because
+		 * the fill-in is chordal, so each triangle is visited once. When an arc out of v changes,
+		 * the arcs between v's upper neighbours it forms triangles with are dirtied through their
+		 * lower ends. Returns the number of arcs whose weights changed. */
+		auto customize(std::vector<std::uint8_t>& dirty, thread_pool* pool) -> std::size_t {
+			auto changed_count = std::atomic<std::size_t>{0};
+
+			for (auto l = std::size_t{0}; l < level_count(); ++l) {
+				detail::for_range(pool, level_offsets_[l], level_offsets_[l + 1], 16, [&](std::size_t i) {
+					auto const v = level_nodes_[i];
+					if (dirty[v] == 0) {
+						return;
+					}
+					dirty[v] = 0;
+
+					auto const first = up_offsets_[v];
+					auto const last = up_offsets_[v + 1];
+					auto previous = std::vector<std::pair<E, E>>();
+					previous.reserve(last - first);
+
+					for (auto a = first; a < last; ++a) {
+						previous.emplace_back(up_[a], down_[a]);
+						up_[a] = input_up_[a];
+						down_[a] = input_down_[a];
+						middle_up_[a] = no_node;
+						middle_down_[a] = no_node;
+					}
+
+					for (auto d = down_offsets_[v]; d < down_offsets_[v + 1]; ++d) {
+						auto const u = down_sources_[d];
+						auto const uv = down_arcs_[d];
+						for (auto uw = up_offsets_[u]; uw < up_offsets_[u + 1]; ++uw) {
+							auto const w = up_targets_[uw];
+							if (level_[w] <= level_[v]) {
+								continue;
+							}
+
+							// load rejects fill-in without this arc, so a miss is only a safeguard
+							auto const a = find_arc(v, w);
+							if (a == arc_count()) {
+								continue;
+							}
+							if (auto const via = add(down_[uv], up_[uw]); via < up_[a]) {
+								up_[a] = via;
+								middle_up_[a] = u;
+							}
+							if (auto const via = add(down_[uw], up_[uv]); via < down_[a]) {
+								down_[a] = via;
+								middle_down_[a] = u;
+							}
+						}
+					}
+
+					// Changed arcs, the highest level among their targets and the top of up(v)
+					auto changed = std::vector<node_id>();
+					auto highest_changed = std::uint32_t{0};
+					auto top = no_node;
+					for (auto a = first; a < last; ++a) {
+						auto const w = up_targets_[a];
+						if (top == no_node or level_[top] < level_[w]) {
+							top = w;
+						}
+						if (previous[a - first] != std::pair(up_[a], down_[a])) {
+							changed.push_back(w);
+							highest_changed = std::max(highest_changed, level_[w]);
+						}
+					}
+					if (changed.empty()) {
+						return;
+					}
+					changed_count += changed.size();
+
+					for (auto a = first; a < last; ++a) {
+						auto const w = up_targets_[a];
+						auto const lower_end = level_[w] < highest_changed
+						                       or (w != top
+						                           and std::binary_search(changed.begin(), changed.end(), w));
+						if (lower_end) {
+							std::atomic_ref<std::uint8_t>(dirty[w]).store(1, std::memory_order_relaxed);
+						}
+					}
+				});
+			}
+
+			return changed_count;
+		}
+
+		/* Expand the arc from a to b into original edges, appending every node after a */
+		auto unpack(node_id a, node_id b, std::vector<N>& out) const -> void {
+			auto const [arc, forward] = arc_between(a, b);
+			auto const middle = forward ? middle_up_[arc] : middle_down_[arc];
+			if (middle == no_node) {
+				out.push_back((*nodes_)[b]);
+				return;
+			}
+			unpack(a, middle, out);
+			unpack(middle, b, out);
+		}
+	};
+
+	/* Reusable search state for one thread. Scratch arrays are reset only where the last query
+	 * touched them, so the cost of a query depends on the search space, not the graph size. */
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	class contraction_hierarchy<N, E>::query {
+	public:
+		explicit query(contraction_hierarchy const& ch)
+		: ch_{&ch}
+		, forward_(ch.node_count())
+		, backward_(ch.node_count()) {}
+
+		[[nodiscard]] auto distance(N const& src, N const& dst) -> std::optional<E> {
+			auto const meet = search(src, dst);
+			if (meet == no_node) {
+				return std::nullopt;
+			}
+			return add(forward_.distance[meet], backward_.distance[meet]);
+		}
+
+		[[nodiscard]] auto path(N const& src, N const& dst) -> std::optional<weighted_path<N, E>> {
+			auto const meet = search(src, dst);
+			if (meet == no_node) {
+				return std::nullopt;
+			}
+
+			auto path = weighted_path<N, E>{{}, add(forward_.distance[meet], backward_.distance[meet]), settled_};
+			auto up_chain = std::vector<node_id>();
+			for (auto id = meet; id != no_node; id = forward_.parent[id]) {
+				up_chain.push_back(id);
+			}
+			std::reverse(up_chain.begin(), up_chain.end());
+
+			path.nodes.push_back((*ch_->nodes_)[up_chain.front()]);
+			for (auto i = std::size_t{1}; i < up_chain.size(); ++i) {
+				ch_->unpack(up_chain[i - 1], up_chain[i], path.nodes);
+			}
+			for (auto id = meet; backward_.parent[id] != no_node; id = backward_.parent[id]) {
+				ch_->unpack(id, backward_.parent[id], path.nodes);
+			}
+			return path;
+		}
+
+		/* Nodes settled by the last query, both directions together */
+		[[nodiscard]] auto settled() const noexcept -> std::size_t {
+			return settled_;
+		}
+
+	private:
+		struct side {
+			std::vector<E> distance;
+			std::vector<node_id> parent;
+			std::vector<node_id> touched;
+			dary_heap<E, node_id> heap;
+
+			explicit side(std::size_t n)
+			: distance(n, infinity)
+			, parent(n, no_node) {}
+
+			auto reset() -> void {
+				for (auto const u : touched) {
+					distance[u] = infinity;
+					parent[u] = no_node;
+				}
+				touched.clear();
+				heap = dary_heap<E, node_id>();
+			}
+
+			auto start(node_id u) -> void {
+				distance[u] = E{};
+				touched.push_back(u);
+				heap.push(E{}, u);
+			}
+		};
+
+		contraction_hierarchy const* ch_;
+		side forward_;
+		side backward_;
+		std::size_t settled_ = 0;
+
+		/* Both searches only climb to higher levels; the best meeting node wins */
+		auto search(N const& src, N const& dst) -> node_id {
+			auto const source = detail::find_node(*ch_->nodes_, src);
+			auto const target = detail::find_node(*ch_->nodes_, dst);
+			if (source == no_node or target == no_node) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::query if src "
+				                         "or dst doesn't exist in the hierarchy");
+			}
+
+			forward_.reset();
+			backward_.reset();
+			forward_.start(source);
+			backward_.start(target);
+			settled_ = 0;
+
+			auto best = infinity;
+			auto meet = no_node;
+			auto step = [&](side& self, side const& other, bool upward) {
+				auto const [d, u] = self.heap.pop();
+				if (d != self.distance[u]) {
+					return;
+				}
+				++settled_;
+
+				if (auto const through = add(d, other.distance[u]); through < best) {
+					best = through;
+					meet = u;
+				}
+
+				for (auto a = ch_->up_offsets_[u]; a < ch_->up_offsets_[u + 1]; ++a) {
+					auto const v = ch_->up_targets_[a];
+					auto const candidate = add(d, upward ? ch_->up_[a] : ch_->down_[a]);
+					if (candidate < self.distance[v]) {
+						if (self.distance[v] == infinity) {
+							self.touched.push_back(v);
+						}
+						self.distance[v] = candidate;
+						self.parent[v] = u;
+						self.heap.push(candidate, v);
+					}
+				}
+			};
+
+			// Each side may stop once its smallest key can't beat the best meeting
+			while (true) {
+				auto const forward_live = not forward_.heap.empty() and forward_.heap.top().first < best;
+				auto const backward_live = not backward_.heap.empty() and backward_.heap.top().first < best;
+				if (not forward_live and not backward_live) {
+					break;
+				}
+
+				if (forward_live and (not backward_live
+				                      or not(backward_.heap.top().first < forward_.heap.top().first)))
+				{
+					step(forward_, backward_, true);
+				}
+				else {
+					step(backward_, forward_, false);
+				}
+			}
+
+			return meet;
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CONTRACTION_HIERARCHY_HPP
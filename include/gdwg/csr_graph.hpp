@@ -0,0 +1,191 @@
+#ifndef GDWG_CSR_GRAPH_HPP
+#define GDWG_CSR_GRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	/* Dense node numbering shared by snapshots and algorithm results */
+	using node_id = std::uint32_t;
+	inline constexpr auto no_node = std::numeric_limits<node_id>::max();
+
+	enum class adjacency { out, in_and_out };
+
+	namespace detail {
+		/* Binary search in a table of node values sorted ascending; no_node if absent */
+		template<typename N>
+		[[nodiscard]] auto find_node(std::vector<N> const& nodes, N const& value) -> node_id {
+			auto const it = std::lower_bound(nodes.begin(), nodes.end(), value);
+			return it == nodes.end() or value < *it ? no_node : static_cast<node_id>(it - nodes.begin());
+		}
+	} // namespace detail
+
+	/* A frozen, read-only compressed sparse row snapshot of a graph. Nodes are numbered in
+	 * ascending order, so id order matches nodes_ order and each node's out-edges are sorted by
+	 * destination and then weight, exactly like edges_. Algorithms that need many passes over the
+	 * edges run on this instead of the pointer-based sets. */
+	template<typename N, typename E>
+	class csr_graph {
+	public:
+		using node_id = gdwg::node_id;
+
+		csr_graph() = default;
+
+		/* O(V + E): one walk over nodes_ and one over edges_ */
+		explicit csr_graph(graph<N, E> const& g, adjacency direction = adjacency::out) {
+			if (g.nodes_.size() >= no_node) {
+				throw std::runtime_error("Cannot build gdwg::csr_graph<N, E> with more than 2^32 - 1 "
+				                         "nodes");
+			}
+
+			auto ids = std::unordered_map<N const*, node_id>();
+			ids.reserve(g.nodes_.size());
+			auto nodes = std::vector<N>();
+			nodes.reserve(g.nodes_.size());
+			for (auto const& n_ptr : g.nodes_) {
+				ids.emplace(n_ptr.get(), static_cast<node_id>(nodes.size()));
+				nodes.push_back(*n_ptr);
+			}
+			nodes_ = std::make_shared<std::vector<N> const>(std::move(nodes));
+
+			// edges_ is sorted by source, so targets come out already in row order
+			offsets_.assign(node_count() + 1, 0);
+			targets_.reserve(g.edges_.size());
+			weights_.reserve(g.edges_.size());
+			N const* prev_src = nullptr;
+			auto src = node_id{0};
+			for (auto const& e_ptr : g.edges_) {
+				if (e_ptr->src != prev_src) {
+					src = ids.at(e_ptr->src);
+					prev_src = e_ptr->src;
+				}
+				++offsets_[src + 1];
+				targets_.push_back(ids.at(e_ptr->dst));
+				weights_.push_back(e_ptr->weight);
+			}
+			prefix_sum(offsets_);
+
+			if (direction == adjacency::in_and_out) {
+				build_in_edges();
+			}
+		}
+
+		// Accessors
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return nodes_ ? nodes_->size() : 0;
+		}
+
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return targets_.size();
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return node_count() == 0;
+		}
+
+		[[nodiscard]] auto has_in_edges() const noexcept -> bool {
+			return not in_offsets_.empty() or empty();
+		}
+
+		[[nodiscard]] auto node(node_id id) const -> N const& {
+			return (*nodes_)[id];
+		}
+
+		/* Node values in id order, shared with every copy of this snapshot */
+		[[nodiscard]] auto node_table() const noexcept -> std::shared_ptr<std::vector<N> const> {
+			return nodes_;
+		}
+
+		/* log(n). no_node if value is not a node */
+		[[nodiscard]] auto find(N const& value) const -> node_id {
+			return empty() ? no_node : detail::find_node(*nodes_, value);
+		}
+
+		[[nodiscard]] auto out_degree(node_id id) const -> std::size_t {
+			return offsets_[id + 1] - offsets_[id];
+		}
+
+		[[nodiscard]] auto in_degree(node_id id) const -> std::size_t {
+			return in_offsets_[id + 1] - in_offsets_[id];
+		}
+
+		/* Destinations of id's out-edges, ascending, parallel edges adjacent */
+		[[nodiscard]] auto targets(node_id id) const -> std::span<node_id const> {
+			return {targets_.data() + offsets_[id], out_degree(id)};
+		}
+
+		[[nodiscard]] auto weights(node_id id) const -> std::span<E const> {
+			return {weights_.data() + offsets_[id], out_degree(id)};
+		}
+
+		/* Sources of id's in-edges, ascending. Requires adjacency::in_and_out */
+		[[nodiscard]] auto sources(node_id id) const -> std::span<node_id const> {
+			return {in_sources_.data() + in_offsets_[id], in_degree(id)};
+		}
+
+		[[nodiscard]] auto in_weights(node_id id) const -> std::span<E const> {
+			return {in_weights_.data() + in_offsets_[id], in_degree(id)};
+		}
+
+		[[nodiscard]] auto offsets() const noexcept -> std::span<std::size_t const> {
+			return offsets_;
+		}
+
+		[[nodiscard]] auto targets() const noexcept -> std::span<node_id const> {
+			return targets_;
+		}
+
+		[[nodiscard]] auto weights() const noexcept -> std::span<E const> {
+			return weights_;
+		}
+
+	private:
+		std::shared_ptr<std::vector<N> const> nodes_;
+		std::vector<std::size_t> offsets_;
+		std::vector<node_id> targets_;
+		std::vector<E> weights_;
+
+		std::vector<std::size_t> in_offsets_;
+		std::vector<node_id> in_sources_;
+		std::vector<E> in_weights_;
+
+		static auto prefix_sum(std::vector<std::size_t>& counts) -> void {
+			for (auto i = std::size_t{1}; i < counts.size(); ++i) {
+				counts[i] += counts[i - 1];
+			}
+		}
+
+		/* Counting sort by destination. Sources are visited in ascending order, so every in-edge
+		 * row ends up sorted by source and then weight. */
+		auto build_in_edges() -> void {
+			in_offsets_.assign(node_count() + 1, 0);
+			for (auto const dst : targets_) {
+				++in_offsets_[dst + 1];
+			}
+			prefix_sum(in_offsets_);
+
+			in_sources_.resize(edge_count());
+			in_weights_.resize(edge_count());
+			auto next = std::vector<std::size_t>(in_offsets_.begin(), in_offsets_.end() - 1);
+			for (auto src = node_id{0}; src < node_count(); ++src) {
+				for (auto e = offsets_[src]; e < offsets_[src + 1]; ++e) {
+					auto const slot = next[targets_[e]]++;
+					in_sources_[slot] = src;
+					in_weights_[slot] = weights_[e];
+				}
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CSR_GRAPH_HPP
@@ -0,0 +1,196 @@
+#ifndef GDWG_DELTA_STEPPING_HPP
+#define GDWG_DELTA_STEPPING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_paths.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	template<typename E>
+	struct delta_stepping_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Bucket width; E{} picks max weight / average out-degree
+		E delta = E{};
+	};
+
+	namespace detail {
+		inline constexpr auto delta_stepping_block = std::size_t{128};
+
+		/* Rejects negative weights and returns the largest one, in parallel over nodes */
+		template<typename N, typename E>
+		auto max_weight(csr_graph<N, E> const& g, thread_pool* pool) -> E {
+			auto const blocks = (g.node_count() + delta_stepping_block - 1) / delta_stepping_block;
+			auto maxima = std::vector<E>(blocks, E{});
+			auto negative = std::atomic<bool>{false};
+
+			detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+				auto const last = std::min(g.node_count(), (b + 1) * delta_stepping_block);
+				for (auto u = b * delta_stepping_block; u < last; ++u) {
+					for (auto const w : g.weights(static_cast<node_id>(u))) {
+						if (w < E{}) {
+							negative = true;
+						}
+						maxima[b] = std::max(maxima[b], w);
+					}
+				}
+			});
+
+			if (negative) {
+				throw std::runtime_error("Cannot call gdwg::delta_stepping on a graph with negative "
+				                         "weights");
+			}
+			return blocks == 0 ? E{} : *std::max_element(maxima.begin(), maxima.end());
+		}
+	} // namespace detail
+
+	/* Parallel single-source shortest paths (Meyer and Sanders). Nodes are kept in buckets of
+	 * width delta; each bucket is drained by repeatedly relaxing the light edges (weight <= delta)
+	 * of its nodes in parallel, then the heavy edges of everything it settled are relaxed once.
+	 * Updates take a per-node spin lock so distance and parent change together. Distances are
+	 * exactly those Dijkstra finds; parents may differ between equally short paths. */
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	auto delta_stepping(csr_graph<N, E> const& g,
+	                    N const& src,
+	                    delta_stepping_options<E> const& options = {}) -> shortest_paths_result<N, E> {
+		auto const source = detail::source_id(g, src);
+		auto* const pool = options.pool;
+		if (options.delta < E{}) {
+			throw std::runtime_error("Cannot call gdwg::delta_stepping with a negative delta");
+		}
+
+		auto const heaviest = detail::max_weight(g, pool);
+		auto delta = options.delta;
+		if (delta == E{}) {
+			auto const average_degree =
+			   std::max(g.edge_count() / std::max(g.node_count(), std::size_t{1}), std::size_t{1});
+			delta = static_cast<E>(heaviest / static_cast<E>(average_degree));
+			if (delta <= E{}) {
+				delta = E{1};
+			}
+		}
+
+		auto const n = g.node_count();
+		auto const infinity = detail::infinite_distance<E>();
+		auto dist = std::vector<E>(n, infinity);
+		auto parent = std::vector<node_id>(n, no_node);
+		auto locks = std::vector<std::atomic_flag>(n);
+
+		// Only non-empty buckets are stored, so a delta far below the heaviest weight costs
+		// nothing for the empty ones in between
+		auto buckets = std::map<std::size_t, std::vector<node_id>>();
+		auto bucket_of = [delta](E d) { return static_cast<std::size_t>(d / delta); };
+
+		auto relax = [&](std::vector<node_id> const& frontier, bool light) {
+			auto const blocks = (frontier.size() + detail::delta_stepping_block - 1)
+			                    / detail::delta_stepping_block;
+			auto improved = std::vector<std::vector<node_id>>(blocks);
+
+			detail::for_range(pool, 0, blocks, 1, [&](std::size_t b) {
+				auto const last = std::min(frontier.size(), (b + 1) * detail::delta_stepping_block);
+				for (auto i = b * detail::delta_stepping_block; i < last; ++i) {
+					auto const u = frontier[i];
+					auto const du = std::atomic_ref<E>(dist[u]).load(std::memory_order_relaxed);
+					auto const targets = g.targets(u);
+					auto const weights = g.weights(u);
+					for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+						auto const v = targets[e];
+						if ((e > 0 and targets[e - 1] == v) or (weights[e] <= delta) != light) {
+							continue;
+						}
+
+						auto const candidate = static_cast<E>(du + weights[e]);
+						auto dv = std::atomic_ref<E>(dist[v]);
+						if (not(candidate < dv.load(std::memory_order_relaxed))) {
+							continue;
+						}
+
+						while (locks[v].test_and_set(std::memory_order_acquire)) {
+						}
+						if (candidate < dv.load(std::memory_order_relaxed)) {
+							dv.store(candidate, std::memory_order_relaxed);
+							parent[v] = u;
+							improved[b].push_back(v);
+						}
+						locks[v].clear(std::memory_order_release);
+					}
+				}
+			});
+
+			for (auto const& block : improved) {
+				for (auto const v : block) {
+					buckets[bucket_of(dist[v])].push_back(v);
+				}
+			}
+		};
+
+		// Rounds in which a node was last expanded or settled, so duplicates are skipped
+		auto expanded = std::vector<std::size_t>(n, std::numeric_limits<std::size_t>::max());
+		auto settled_in = std::vector<std::size_t>(n, std::numeric_limits<std::size_t>::max());
+		auto round = std::size_t{0};
+		auto settled = std::size_t{0};
+
+		dist[source] = E{};
+		buckets[0].push_back(source);
+		while (not buckets.empty()) {
+			// Light edges can refill the current bucket but never an earlier one
+			auto const i = buckets.begin()->first;
+			auto bucket_settled = std::vector<node_id>();
+			while (not buckets.empty() and buckets.begin()->first == i) {
+				auto const pending = std::move(buckets.begin()->second);
+				buckets.erase(buckets.begin());
+				auto frontier = std::vector<node_id>();
+				for (auto const v : pending) {
+					if (bucket_of(dist[v]) == i and expanded[v] != round) {
+						expanded[v] = round;
+						frontier.push_back(v);
+						if (settled_in[v] != i) {
+							settled_in[v] = i;
+							bucket_settled.push_back(v);
+						}
+					}
+				}
+				++round;
+				relax(frontier, true);
+			}
+
+			settled += bucket_settled.size();
+			relax(bucket_settled, false);
+		}
+
+		auto result = shortest_paths_result<N, E>{g.node_table(),
+		                                          std::vector<std::optional<E>>(n),
+		                                          std::move(parent),
+		                                          settled};
+		for (auto v = std::size_t{0}; v < n; ++v) {
+			if (dist[v] != infinity) {
+				result.distance[v] = dist[v];
+			}
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	auto delta_stepping(graph<N, E> const& g,
+	                    N const& src,
+	                    delta_stepping_options<E> const& options = {}) -> shortest_paths_result<N, E> {
+		return delta_stepping(csr_graph<N, E>(g), src, options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_DELTA_STEPPING_HPP
@@ -0,0 +1,641 @@
+#ifndef GDWG_DURABLE_GRAPH_HPP
+#define GDWG_DURABLE_GRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "gdwg/serialize.hpp"
+
+namespace gdwg {
+	struct durability_options {
+		// Pending records are written out once either limit is reached, or on commit()
+		std::size_t group_records = 256;
+		std::size_t group_bytes = std::size_t{1} << 16U;
+
+		// fsync each group; without it a group survives a process crash but not a power cut
+		bool sync = true;
+
+		// Checkpoint automatically once the log grows past this many bytes; 0 never does
+		std::uint64_t checkpoint_bytes = std::uint64_t{1} << 26U;
+	};
+
+	struct recovery_stats {
+		// Generation of the checkpoint loaded, 0 when recovery started from an empty graph
+		std::uint64_t checkpoint = 0;
+
+		// Log records replayed on top of it
+		std::size_t records = 0;
+
+		// Bytes of torn or corrupt log tail that were cut off
+		std::uint64_t truncated_bytes = 0;
+	};
+
+	namespace detail {
+		enum class wal_op : std::uint8_t {
+			insert_node = 1,
+			insert_edge,
+			insert_nodes,
+			insert_edges,
+			replace_node,
+			merge_replace_node,
+			erase_node,
+			erase_edge,
+			clear,
+			erase_nodes,
+			erase_edges,
+		};
+
+		// Record header: payload size, then a checksum of the payload
+		inline constexpr auto wal_header_bytes = std::size_t{8};
+
+		inline auto wal_checksum(char const* data, std::size_t size) -> std::uint32_t {
+			// FNV-1a
+			auto hash = std::uint32_t{2166136261U};
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619U;
+			}
+			return hash;
+		}
+
+		/* Flushes a file, or the directory entries under a path, to stable storage. Returns false
+		 * if that can't be done. */
+		[[nodiscard]] inline auto sync_path(std::filesystem::path const& path) -> bool {
+#if GDWG_HAS_MMAP
+			auto const fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				return false;
+			}
+			auto const synced = ::fsync(fd) == 0;
+			::close(fd);
+			return synced;
+#else
+			(void)path;
+			return true;
+#endif
+		}
+
+		struct file_closer {
+			auto operator()(std::FILE* file) const noexcept -> void {
+				std::fclose(file);
+			}
+		};
+	} // namespace detail
+
+	/* A graph<N, E> whose modifiers are logged so it survives a crash. Each modifier that changes
+	 * the graph appends a checksummed record to a write-ahead log in directory; records are
+	 * buffered and written a group at a time, so fsync is paid per group rather than per edit.
+	 * checkpoint() writes the whole graph in the gdwg::save_binary format and starts a new log.
+	 *
+	 * Opening a directory recovers it: the newest checkpoint is loaded and only the logs written
+	 * since are replayed. A torn record at the end of the log, left by a crash mid-write, is cut
+	 * off. Records still buffered when the process dies are lost, so call commit() before
+	 * acknowledging anything that must not be.
+	 *
+	 * Files are named checkpoint-<generation>.gdwg and wal-<generation>.log. N and E must work
+	 * with gdwg::serializer. */
+	template<typename N, typename E>
+	class durable_graph {
+	public:
+		explicit durable_graph(std::filesystem::path directory, durability_options const& options = {})
+		: directory_{std::move(directory)}
+		, options_{options} {
+			recover();
+		}
+
+		durable_graph(durable_graph const&) = delete;
+		auto operator=(durable_graph const&) -> durable_graph& = delete;
+
+		// Commits whatever is buffered; errors here can't be reported, so commit() first to see them
+		~durable_graph() {
+			try {
+				commit();
+			} catch (...) {
+			}
+		}
+
+		[[nodiscard]] auto get() const noexcept -> graph<N, E> const& {
+			return g_;
+		}
+
+		auto insert_node(N const& value) -> bool {
+			return logged([&] { return g_.insert_node(value); }, detail::wal_op::insert_node, value);
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return logged([&] { return g_.insert_edge(src, dst, weight); },
+			              detail::wal_op::insert_edge,
+			              src,
+			              dst,
+			              weight);
+		}
+
+		template<typename InputIt>
+		auto insert_nodes(InputIt first, InputIt last) -> std::size_t {
+			auto values = std::vector<N>(first, last);
+			return logged([&] { return g_.insert_nodes(values.begin(), values.end()); },
+			              detail::wal_op::insert_nodes,
+			              values);
+		}
+
+		template<typename InputIt>
+		auto insert_edges(InputIt first, InputIt last) -> std::size_t {
+			auto values = std::vector<typename graph<N, E>::value_type>(first, last);
+			return logged([&] { return g_.insert_edges(values.begin(), values.end()); },
+			              detail::wal_op::insert_edges,
+			              values);
+		}
+
+		auto replace_node(N const& old_data, N const& new_data) -> bool {
+			return logged([&] { return g_.replace_node(old_data, new_data); },
+			              detail::wal_op::replace_node,
+			              old_data,
+			              new_data);
+		}
+
+		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+			logged(
+			   [&] {
+				   g_.merge_replace_node(old_data, new_data);
+				   return true;
+			   },
+			   detail::wal_op::merge_replace_node,
+			   old_data,
+			   new_data);
+		}
+
+		auto erase_node(N const& value) -> bool {
+			return logged([&] { return g_.erase_node(value); }, detail::wal_op::erase_node, value);
+		}
+
+		template<typename InputIt>
+		auto erase_nodes(InputIt first, InputIt last) -> std::size_t {
+			auto values = std::vector<N>(first, last);
+			return logged([&] { return g_.erase_nodes(values.begin(), values.end()); },
+			              detail::wal_op::erase_nodes,
+			              values);
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return logged([&] { return g_.erase_edge(src, dst, weight); },
+			              detail::wal_op::erase_edge,
+			              src,
+			              dst,
+			              weight);
+		}
+
+		auto erase_edge(typename graph<N, E>::iterator i) -> typename graph<N, E>::iterator {
+			if (i == g_.end() or i == typename graph<N, E>::iterator{}) {
+				return g_.end();
+			}
+			auto const [src, dst, weight] = *i;
+			auto next = typename graph<N, E>::iterator{};
+			logged(
+			   [&] {
+				   next = g_.erase_edge(i);
+				   return true;
+			   },
+			   detail::wal_op::erase_edge,
+			   src,
+			   dst,
+			   weight);
+			return next;
+		}
+
+		auto erase_edge(typename graph<N, E>::iterator i, typename graph<N, E>::iterator s)
+		   -> typename graph<N, E>::iterator {
+			while (i != s) {
+				i = erase_edge(i);
+			}
+			return i;
+		}
+
+		/* Throws, logging nothing, if an endpoint is missing, as graph::erase_edges does */
+		template<typename InputIt>
+		auto erase_edges(InputIt first, InputIt last) -> std::size_t {
+			auto values = std::vector<typename graph<N, E>::value_type>(first, last);
+			return logged([&] { return g_.erase_edges(values.begin(), values.end()); },
+			              detail::wal_op::erase_edges,
+			              values);
+		}
+
+		auto clear() -> void {
+			logged(
+			   [&] {
+				   g_.clear();
+				   return true;
+			   },
+			   detail::wal_op::clear);
+		}
+
+		/* Writes out the buffered records as one group. If the write fails, whatever part of the
+		 * group reached the log is cut off again and the group stays buffered for the next commit;
+		 * if the log can't be cut, every later commit throws until a checkpoint replaces it. If
+		 * the group is written but can't be synced this still throws, as the group may not
+		 * survive a power cut; it isn't written again. */
+		auto commit() -> void {
+			if (pending_.empty()) {
+				return;
+			}
+			if (failed_) {
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::commit on a log left "
+				                         "torn by an earlier write");
+			}
+			if (std::fwrite(pending_.data(), 1, pending_.size(), wal_.get()) != pending_.size()
+			    or std::fflush(wal_.get()) != 0)
+			{
+				cut_torn_group();
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::commit on a log that "
+				                         "can't be written");
+			}
+			wal_bytes_ += pending_.size();
+			pending_.clear();
+			pending_records_ = 0;
+#if GDWG_HAS_MMAP
+			if (options_.sync and ::fsync(::fileno(wal_.get())) != 0) {
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::commit on a log that "
+				                         "can't be synced");
+			}
+#endif
+			if (options_.checkpoint_bytes != 0 and wal_bytes_ >= options_.checkpoint_bytes) {
+				checkpoint();
+			}
+		}
+
+		/* Snapshots the graph and starts an empty log, so the next recovery replays nothing before
+		 * this point. The old checkpoint and log are removed once the new snapshot is in place. */
+		auto checkpoint() -> void {
+			auto const next = generation_ + 1;
+			auto const target = checkpoint_path(next);
+			auto temporary = target;
+			temporary += ".tmp";
+			{
+				auto os = std::ofstream(temporary, std::ios::binary | std::ios::trunc);
+				if (not os) {
+					throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::checkpoint on a "
+					                         "directory that can't be written");
+				}
+				save_binary(csr_graph<N, E>(g_), os);
+
+				// The last block is only written on close, and may fail there
+				os.close();
+				if (os.fail() or (options_.sync and not detail::sync_path(temporary))) {
+					std::filesystem::remove(temporary);
+					throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::checkpoint when "
+					                         "the snapshot can't be written in full");
+				}
+			}
+
+			// The rename is the commit point. Records buffered so far are in the snapshot, but they
+			// stay pending until the rename is durable, so a failure leaves them for the old log.
+			auto ignored = std::error_code();
+			try {
+				std::filesystem::rename(temporary, target);
+			} catch (...) {
+				std::filesystem::remove(temporary, ignored);
+				throw;
+			}
+			if (options_.sync and not detail::sync_path(directory_)) {
+				std::filesystem::remove(target, ignored);
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::checkpoint when the "
+				                         "directory can't be synced");
+			}
+			pending_.clear();
+			pending_records_ = 0;
+
+			wal_.reset();
+			std::filesystem::remove(wal_path(generation_));
+			std::filesystem::remove(checkpoint_path(generation_));
+			generation_ = next;
+			open_wal();
+		}
+
+		[[nodiscard]] auto generation() const noexcept -> std::uint64_t {
+			return generation_;
+		}
+
+		// Bytes in the current log, not counting records still buffered
+		[[nodiscard]] auto wal_bytes() const noexcept -> std::uint64_t {
+			return wal_bytes_;
+		}
+
+		[[nodiscard]] auto pending_records() const noexcept -> std::size_t {
+			return pending_records_;
+		}
+
+		[[nodiscard]] auto recovery() const noexcept -> recovery_stats const& {
+			return recovery_;
+		}
+
+	private:
+		std::filesystem::path directory_;
+		durability_options options_;
+		graph<N, E> g_;
+		std::unique_ptr<std::FILE, detail::file_closer> wal_;
+		std::uint64_t generation_ = 0;
+		std::uint64_t wal_bytes_ = 0;
+		std::string pending_;
+		std::size_t pending_records_ = 0;
+		std::ostringstream record_{std::ios::ate};
+		recovery_stats recovery_;
+		bool failed_ = false;
+
+		[[nodiscard]] auto checkpoint_path(std::uint64_t generation) const -> std::filesystem::path {
+			return directory_ / ("checkpoint-" + std::to_string(generation) + ".gdwg");
+		}
+
+		[[nodiscard]] auto wal_path(std::uint64_t generation) const -> std::filesystem::path {
+			return directory_ / ("wal-" + std::to_string(generation) + ".log");
+		}
+
+		/* Generation in a file name of the form <prefix><generation><suffix> */
+		static auto parse_generation(std::string_view name, std::string_view prefix, std::string_view suffix)
+		   -> std::optional<std::uint64_t> {
+			if (name.size() <= prefix.size() + suffix.size() or not name.starts_with(prefix)
+			    or not name.ends_with(suffix))
+			{
+				return std::nullopt;
+			}
+			name = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+			auto generation = std::uint64_t{0};
+			for (auto const c : name) {
+				if (c < '0' or c > '9') {
+					return std::nullopt;
+				}
+				generation = generation * 10 + static_cast<std::uint64_t>(c - '0');
+			}
+			return generation;
+		}
+
+		/* Runs edit, which reports whether it changed the graph, and logs op for it. The record is
+		 * encoded first, so one too large for its 32-bit size throws with the graph untouched;
+		 * it is dropped again if edit throws or changes nothing. */
+		template<typename Edit, typename... Args>
+		auto logged(Edit const& edit, detail::wal_op op, Args const&... args) -> decltype(edit()) {
+			auto const start = encode(op, args...);
+			auto result = decltype(edit())();
+			try {
+				result = edit();
+			} catch (...) {
+				pending_.resize(start);
+				throw;
+			}
+			if (static_cast<bool>(result)) {
+				seal(start);
+			}
+			else {
+				pending_.resize(start);
+			}
+			return result;
+		}
+
+		/* Appends a record for op to the buffered group, leaving its header blank, and returns
+		 * where it starts */
+		template<typename... Args>
+		auto encode(detail::wal_op op, Args const&... args) -> std::size_t {
+			// record_ is opened at the end, so this appends to the buffered group
+			record_.str(std::move(pending_));
+			auto const start = static_cast<std::size_t>(record_.tellp());
+			record_.write("\0\0\0\0\0\0\0\0", detail::wal_header_bytes);
+			serializer<std::uint8_t>::write(record_, static_cast<std::uint8_t>(op));
+			(write_value(args), ...);
+			pending_ = std::move(record_).str();
+
+			auto const payload = pending_.size() - start - detail::wal_header_bytes;
+			if (payload > std::numeric_limits<std::uint32_t>::max()) {
+				pending_.resize(start);
+				throw std::runtime_error("Cannot call a gdwg::durable_graph<N, E> modifier with an edit "
+				                         "whose log record would be 4 GiB or more");
+			}
+			return start;
+		}
+
+		/* Fills in the header of the record at start, which ends the buffered group */
+		auto seal(std::size_t start) -> void {
+			auto const payload = static_cast<std::uint32_t>(pending_.size() - start - detail::wal_header_bytes);
+			auto const checksum =
+			   detail::wal_checksum(pending_.data() + start + detail::wal_header_bytes, payload);
+			std::memcpy(pending_.data() + start, &payload, sizeof(payload));
+			std::memcpy(pending_.data() + start + sizeof(payload), &checksum, sizeof(checksum));
+
+			++pending_records_;
+			if (pending_records_ >= options_.group_records or pending_.size() >= options_.group_bytes) {
+				commit();
+			}
+		}
+
+		template<typename T>
+		auto write_value(T const& value) -> void {
+			serializer<T>::write(record_, value);
+		}
+
+		template<typename T>
+		auto write_value(std::vector<T> const& values) -> void {
+			serializer<std::uint64_t>::write(record_, values.size());
+			for (auto const& value : values) {
+				write_value(value);
+			}
+		}
+
+		auto write_value(typename graph<N, E>::value_type const& value) -> void {
+			serializer<N>::write(record_, value.from);
+			serializer<N>::write(record_, value.to);
+			serializer<E>::write(record_, value.weight);
+		}
+
+		auto recover() -> void {
+			std::filesystem::create_directories(directory_);
+			auto checkpoints = std::vector<std::uint64_t>();
+			auto logs = std::vector<std::uint64_t>();
+			for (auto const& entry : std::filesystem::directory_iterator(directory_)) {
+				auto const name = entry.path().filename().string();
+				if (name.ends_with(".tmp")) {
+					std::filesystem::remove(entry.path());
+				}
+				else if (auto const c = parse_generation(name, "checkpoint-", ".gdwg")) {
+					checkpoints.push_back(*c);
+				}
+				else if (auto const w = parse_generation(name, "wal-", ".log")) {
+					logs.push_back(*w);
+				}
+			}
+			std::sort(logs.begin(), logs.end());
+
+			if (not checkpoints.empty()) {
+				generation_ = *std::max_element(checkpoints.begin(), checkpoints.end());
+				g_ = mapped_graph<N, E>(checkpoint_path(generation_).string()).to_graph();
+			}
+			recovery_.checkpoint = generation_;
+
+			// Anything older than the checkpoint is already in it
+			for (auto const c : checkpoints) {
+				if (c < generation_) {
+					std::filesystem::remove(checkpoint_path(c));
+				}
+			}
+			for (auto const w : logs) {
+				if (w < generation_) {
+					std::filesystem::remove(wal_path(w));
+				}
+				else {
+					replay(w);
+					generation_ = w;
+				}
+			}
+			open_wal();
+		}
+
+		/* Applies the records of one log, cutting it at the first record that is torn or corrupt */
+		auto replay(std::uint64_t generation) -> void {
+			auto const path = wal_path(generation);
+			auto at = std::size_t{0};
+			auto size = std::size_t{0};
+			{
+				auto const file = detail::file_mapping(path.string());
+				auto const* const bytes = reinterpret_cast<char const*>(file.data());
+				size = file.size();
+				while (size - at >= detail::wal_header_bytes) {
+					auto payload = std::uint32_t{0};
+					auto checksum = std::uint32_t{0};
+					std::memcpy(&payload, bytes + at, sizeof(payload));
+					std::memcpy(&checksum, bytes + at + sizeof(payload), sizeof(checksum));
+					auto const* const data = bytes + at + detail::wal_header_bytes;
+					if (payload == 0 or payload > size - at - detail::wal_header_bytes
+					    or detail::wal_checksum(data, payload) != checksum)
+					{
+						break;
+					}
+					auto const* const first = reinterpret_cast<std::byte const*>(data);
+					auto buffer = detail::memory_buffer(first, first + payload);
+					auto is = std::istream(&buffer);
+					apply(is);
+					if (not is) {
+						throw std::runtime_error("Cannot construct gdwg::durable_graph<N, E> from a log "
+						                         "record that doesn't decode");
+					}
+					at += detail::wal_header_bytes + payload;
+					++recovery_.records;
+				}
+			}
+
+			if (at != size) {
+				recovery_.truncated_bytes += size - at;
+				std::filesystem::resize_file(path, at);
+			}
+		}
+
+		auto apply(std::istream& is) -> void {
+			auto const read_node = [&is] { return serializer<N>::read(is); };
+			auto const read_edge = [&is] {
+				auto src = serializer<N>::read(is);
+				auto dst = serializer<N>::read(is);
+				return typename graph<N, E>::value_type{std::move(src), std::move(dst), serializer<E>::read(is)};
+			};
+			// Grown as values are read, so a bad count can't allocate more than the record holds
+			auto const read_many = [&is](auto const& read_one) {
+				auto values = std::vector<decltype(read_one())>();
+				auto const count = serializer<std::uint64_t>::read(is);
+				for (auto i = std::uint64_t{0}; i < count and is; ++i) {
+					values.push_back(read_one());
+				}
+				return values;
+			};
+
+			switch (static_cast<detail::wal_op>(serializer<std::uint8_t>::read(is))) {
+			case detail::wal_op::insert_node: g_.insert_node(read_node()); break;
+			case detail::wal_op::insert_edge: {
+				auto const e = read_edge();
+				g_.insert_edge(e.from, e.to, e.weight);
+				break;
+			}
+			case detail::wal_op::insert_nodes: {
+				auto const values = read_many(read_node);
+				g_.insert_nodes(values.begin(), values.end());
+				break;
+			}
+			case detail::wal_op::insert_edges: {
+				auto const values = read_many(read_edge);
+				g_.insert_edges(values.begin(), values.end());
+				break;
+			}
+			case detail::wal_op::replace_node: {
+				auto const old_data = read_node();
+				g_.replace_node(old_data, read_node());
+				break;
+			}
+			case detail::wal_op::merge_replace_node: {
+				auto const old_data = read_node();
+				g_.merge_replace_node(old_data, read_node());
+				break;
+			}
+			case detail::wal_op::erase_node: g_.erase_node(read_node()); break;
+			case detail::wal_op::erase_edge: {
+				auto const e = read_edge();
+				g_.erase_edge(e.from, e.to, e.weight);
+				break;
+			}
+			case detail::wal_op::clear: g_.clear(); break;
+			case detail::wal_op::erase_nodes: {
+				auto const values = read_many(read_node);
+				g_.erase_nodes(values.begin(), values.end());
+				break;
+			}
+			case detail::wal_op::erase_edges: {
+				auto const values = read_many(read_edge);
+				g_.erase_edges(values.begin(), values.end());
+				break;
+			}
+			default:
+				throw std::runtime_error("Cannot construct gdwg::durable_graph<N, E> from a log record "
+				                         "with an unknown operation");
+			}
+		}
+
+		auto open_wal() -> void {
+			auto const path = wal_path(generation_);
+			wal_.reset(std::fopen(path.string().c_str(), "ab"));
+			failed_ = not wal_;
+			if (failed_) {
+				throw std::runtime_error("Cannot construct gdwg::durable_graph<N, E> in a directory "
+				                         "that can't be written");
+			}
+			wal_bytes_ = std::filesystem::file_size(path);
+		}
+
+		/* Cuts the log back to its last whole group after a failed write, so a retried group isn't
+		 * replayed after a torn copy of itself. Closing the stream may still write some of what it
+		 * buffers, so the log is cut after it is closed. */
+		auto cut_torn_group() -> void {
+			failed_ = true;
+			wal_.reset();
+			auto const path = wal_path(generation_);
+			auto error = std::error_code();
+			std::filesystem::resize_file(path, wal_bytes_, error);
+			if (error) {
+				return;
+			}
+			wal_.reset(std::fopen(path.string().c_str(), "ab"));
+			failed_ = not wal_;
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_DURABLE_GRAPH_HPP
@@ -0,0 +1,359 @@
+#ifndef GDWG_EDGE_LIST_HPP
+#define GDWG_EDGE_LIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	/* Text parsing hook for node and weight types read by gdwg::load_edge_list. Arithmetic types
+	 * and strings work out of the box; specialise this for anything else:
+	 *
+	 *   template<>
+	 *   struct gdwg::text_parser<my_type> {
+	 *       static auto parse(std::string_view field) -> std::optional<my_type>;
+	 *   };
+	 *
+	 * Fields arrive trimmed and, for CSV, unquoted. Return std::nullopt to reject one. */
+	template<typename T>
+	struct text_parser;
+
+	template<typename T>
+	requires std::is_arithmetic_v<T> and (not std::is_same_v<T, bool>)
+	struct text_parser<T> {
+		static auto parse(std::string_view field) -> std::optional<T> {
+			if (field.size() > 1 and field.front() == '+') {
+				field.remove_prefix(1);
+			}
+			auto value = T{};
+			auto const* const last = field.data() + field.size();
+			auto const [end, error] = std::from_chars(field.data(), last, value);
+			if (error != std::errc() or end != last) {
+				return std::nullopt;
+			}
+			return value;
+		}
+	};
+
+	template<typename Char, typename Traits, typename Alloc>
+	struct text_parser<std::basic_string<Char, Traits, Alloc>> {
+		static auto parse(std::string_view field)
+		   -> std::optional<std::basic_string<Char, Traits, Alloc>> {
+			return std::basic_string<Char, Traits, Alloc>(field.begin(), field.end());
+		}
+	};
+
+	enum class edge_list_format {
+		// "src dst weight", fields separated by spaces or tabs
+		whitespace,
+		// "src,dst,weight", fields may be double-quoted with "" for a quote
+		csv,
+	};
+
+	struct edge_list_options {
+		// nullptr parses on the calling thread
+		thread_pool* pool = nullptr;
+
+		edge_list_format format = edge_list_format::whitespace;
+
+		// Field separator for edge_list_format::csv
+		char delimiter = ',';
+
+		// Skip the first line
+		bool header = false;
+
+		// Lines starting with this, after leading blanks, are skipped like blank lines
+		char comment = '#';
+
+		// Throw on the first malformed line instead of skipping it
+		bool strict = false;
+
+		// Malformed lines kept in the result; all of them are counted
+		std::size_t max_errors = 100;
+
+		// Bytes per parsing task, rounded up to a line end
+		std::size_t chunk_bytes = std::size_t{1} << 22U;
+	};
+
+	struct malformed_line {
+		// 1-based
+		std::size_t line = 0;
+		std::string text;
+		std::string reason;
+	};
+
+	template<typename N, typename E>
+	struct edge_list_result {
+		gdwg::graph<N, E> g;
+
+		// Lines read, including blank, comment and header lines
+		std::size_t lines = 0;
+
+		// Edges parsed; duplicates among them are inserted once
+		std::size_t edges = 0;
+
+		std::size_t malformed = 0;
+
+		// The first max_errors malformed lines, in file order
+		std::vector<malformed_line> errors;
+	};
+
+	namespace detail {
+		template<typename N, typename E>
+		struct parsed_chunk {
+			std::vector<typename graph<N, E>::value_type> edges;
+			std::vector<malformed_line> errors;
+			std::size_t malformed = 0;
+			std::size_t lines = 0;
+		};
+
+		inline auto is_blank(char c) -> bool {
+			return c == ' ' or c == '\t';
+		}
+
+		inline auto trim(std::string_view field) -> std::string_view {
+			while (not field.empty() and is_blank(field.front())) {
+				field.remove_prefix(1);
+			}
+			while (not field.empty() and is_blank(field.back())) {
+				field.remove_suffix(1);
+			}
+			return field;
+		}
+
+		/* Splits line into exactly three fields, or returns why it can't. Quoted CSV fields with
+		 * escaped quotes are unescaped into scratch. */
+		inline auto split_fields(std::string_view line,
+		                         edge_list_options const& options,
+		                         std::array<std::string_view, 3>& fields,
+		                         std::array<std::string, 3>& scratch) -> char const* {
+			auto count = std::size_t{0};
+			if (options.format == edge_list_format::whitespace) {
+				auto i = std::size_t{0};
+				while (true) {
+					while (i < line.size() and is_blank(line[i])) {
+						++i;
+					}
+					if (i == line.size()) {
+						break;
+					}
+					auto const start = i;
+					while (i < line.size() and not is_blank(line[i])) {
+						++i;
+					}
+					if (count == 3) {
+						return "expected 3 fields";
+					}
+					fields[count++] = line.substr(start, i - start);
+				}
+				return count == 3 ? nullptr : "expected 3 fields";
+			}
+
+			// A blank delimiter, as in TSV, separates fields rather than padding them
+			auto const padding = [&options](char c) { return is_blank(c) and c != options.delimiter; };
+			auto i = std::size_t{0};
+			while (true) {
+				while (i < line.size() and padding(line[i])) {
+					++i;
+				}
+				if (count == 3) {
+					return "expected 3 fields";
+				}
+
+				auto field = std::string_view();
+				if (i < line.size() and line[i] == '"') {
+					auto const start = ++i;
+					auto escaped = false;
+					while (true) {
+						if (i == line.size()) {
+							return "unterminated quote";
+						}
+						if (line[i] == '"') {
+							if (i + 1 < line.size() and line[i + 1] == '"') {
+								escaped = true;
+								i += 2;
+								continue;
+							}
+							break;
+						}
+						++i;
+					}
+					field = line.substr(start, i - start);
+					++i;
+					if (escaped) {
+						auto& unescaped = scratch[count];
+						unescaped.clear();
+						for (auto j = std::size_t{0}; j < field.size(); ++j) {
+							unescaped.push_back(field[j]);
+							if (field[j] == '"') {
+								++j;
+							}
+						}
+						field = unescaped;
+					}
+					while (i < line.size() and padding(line[i])) {
+						++i;
+					}
+					if (i < line.size() and line[i] != options.delimiter) {
+						return "text after a closing quote";
+					}
+				}
+				else {
+					auto const end = std::min(line.find(options.delimiter, i), line.size());
+					field = trim(line.substr(i, end - i));
+					i = end;
+				}
+				fields[count++] = field;
+
+				if (i == line.size()) {
+					break;
+				}
+				++i;
+			}
+			return count == 3 ? nullptr : "expected 3 fields";
+		}
+
+		/* Parses the lines in text; first_line says whether text starts at the top of the file */
+		template<typename N, typename E>
+		auto parse_chunk(std::string_view text, bool first_line, edge_list_options const& options)
+		   -> parsed_chunk<N, E> {
+			auto chunk = parsed_chunk<N, E>();
+			auto fields = std::array<std::string_view, 3>();
+			auto scratch = std::array<std::string, 3>();
+			auto const fail = [&](std::string_view line, char const* reason) {
+				++chunk.malformed;
+				if (chunk.errors.size() < options.max_errors or options.strict) {
+					chunk.errors.push_back({chunk.lines, std::string(line), reason});
+				}
+			};
+
+			while (not text.empty()) {
+				auto const end = std::min(text.find('\n'), text.size());
+				auto line = text.substr(0, end);
+				text.remove_prefix(std::min(end + 1, text.size()));
+				++chunk.lines;
+				if (not line.empty() and line.back() == '\r') {
+					line.remove_suffix(1);
+				}
+
+				auto const content = trim(line);
+				if ((first_line and chunk.lines == 1 and options.header) or content.empty()
+				    or content.front() == options.comment)
+				{
+					continue;
+				}
+
+				if (auto const* const reason = split_fields(content, options, fields, scratch)) {
+					fail(line, reason);
+					continue;
+				}
+				auto src = text_parser<N>::parse(fields[0]);
+				auto dst = text_parser<N>::parse(fields[1]);
+				auto weight = text_parser<E>::parse(fields[2]);
+				if (not src) {
+					fail(line, "bad source");
+				}
+				else if (not dst) {
+					fail(line, "bad destination");
+				}
+				else if (not weight) {
+					fail(line, "bad weight");
+				}
+				else {
+					chunk.edges.push_back({std::move(*src), std::move(*dst), std::move(*weight)});
+				}
+				if (options.strict and chunk.malformed != 0) {
+					break;
+				}
+			}
+			return chunk;
+		}
+
+		/* parse_edge_list's work; caller names the public function in the strict-mode error */
+		template<typename N, typename E>
+		auto build_edge_list(std::string_view text, edge_list_options const& options, char const* caller)
+		   -> edge_list_result<N, E> {
+			auto bounds = std::vector<std::size_t>{0};
+			auto const step = std::max(options.chunk_bytes, std::size_t{1});
+			while (bounds.back() < text.size()) {
+				auto const next = bounds.back() + step;
+				auto const end = next >= text.size() ? text.npos : text.find('\n', next - 1);
+				bounds.push_back(end == text.npos ? text.size() : end + 1);
+			}
+
+			auto chunks = std::vector<parsed_chunk<N, E>>(bounds.size() - 1);
+			for_range(options.pool, 0, chunks.size(), 1, [&](std::size_t c) {
+				chunks[c] =
+				   parse_chunk<N, E>(text.substr(bounds[c], bounds[c + 1] - bounds[c]), c == 0, options);
+			});
+
+			auto result = edge_list_result<N, E>();
+			auto edges = std::vector<typename graph<N, E>::value_type>();
+			auto nodes = std::vector<N>();
+			for (auto& chunk : chunks) {
+				for (auto& error : chunk.errors) {
+					error.line += result.lines;
+					if (options.strict) {
+						throw std::runtime_error(std::string("Cannot call gdwg::") + caller
+						                         + " on malformed line " + std::to_string(error.line) + " ("
+						                         + error.reason + ")");
+					}
+					if (result.errors.size() < options.max_errors) {
+						result.errors.push_back(std::move(error));
+					}
+				}
+				result.lines += chunk.lines;
+				result.malformed += chunk.malformed;
+				for (auto& e : chunk.edges) {
+					nodes.push_back(e.from);
+					nodes.push_back(e.to);
+					edges.push_back(std::move(e));
+				}
+				chunk.edges = {};
+			}
+			result.edges = edges.size();
+
+			// One batch each, so the inserts stay linear after the sort
+			result.g.insert_nodes(nodes.begin(), nodes.end());
+			nodes = std::vector<N>();
+			result.g.insert_edges(edges.begin(), edges.end());
+			return result;
+		}
+	} // namespace detail
+
+	/* Builds a graph from edge-list text. The text is cut into chunks at line ends, chunks are
+	 * parsed in parallel, and the graph is built with insert_nodes and insert_edges, so the tree
+	 * inserts are linear after a sort. Endpoints become nodes. */
+	template<typename N, typename E>
+	auto parse_edge_list(std::string_view text, edge_list_options const& options = {})
+	   -> edge_list_result<N, E> {
+		return detail::build_edge_list<N, E>(text, options, "parse_edge_list");
+	}
+
+	/* parse_edge_list over a file, mapped rather than read so the chunks come straight from the
+	 * page cache */
+	template<typename N, typename E>
+	auto load_edge_list(std::string const& path, edge_list_options const& options = {})
+	   -> edge_list_result<N, E> {
+		auto const file = detail::file_mapping(path);
+		return detail::build_edge_list<N, E>(
+		   std::string_view(reinterpret_cast<char const*>(file.data()), file.size()),
+		   options,
+		   "load_edge_list");
+	}
+} // namespace gdwg
+
+#endif // GDWG_EDGE_LIST_HPP
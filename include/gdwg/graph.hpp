@@ -3,18 +3,63 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <experimental/iterator>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "gdwg/thread_pool.hpp"
+
 namespace gdwg {
+	template<typename N, typename E>
+	class csr_graph;
+
+	namespace detail {
+		template<typename N, typename E>
+		struct graph_access;
+
+		// splitmix64's finaliser: spreads weak hashes such as std::hash<int> over all 64 bits
+		constexpr auto fingerprint_mix(std::uint64_t x) noexcept -> std::uint64_t {
+			x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9U;
+			x = (x ^ (x >> 27U)) * 0x94d049bb133111ebU;
+			return x ^ (x >> 31U);
+		}
+
+		/* std::hash of value, or 0 for types without one */
+		template<typename T>
+		auto fingerprint_hash(T const& value) -> std::uint64_t {
+			if constexpr (requires { std::hash<T>{}(value); }) {
+				return static_cast<std::uint64_t>(std::hash<T>{}(value));
+			}
+			else {
+				return 0;
+			}
+		}
+	} // namespace detail
+
+	/* Summary of a graph's content: equal graphs have equal fingerprints, and graphs with equal
+	 * fingerprints are almost certainly equal. Nodes and weights without a std::hash only count
+	 * towards the sizes. */
+	struct graph_fingerprint {
+		std::size_t nodes = 0;
+		std::size_t edges = 0;
+		std::uint64_t hash = 0;
+
+		auto operator==(graph_fingerprint const&) const -> bool = default;
+	};
+
 	template<typename N, typename E>
 	class graph {
 	public:
@@ -44,6 +89,9 @@ namespace gdwg {
 			std::transform(first, last, std::inserter(nodes_, nodes_.end()), [](auto const& n) {
 				return std::make_shared<N>(n);
 			});
+			for (auto const& n_ptr : nodes_) {
+				hash_ += node_hash(*n_ptr);
+			}
 		}
 
 		// Copy Constructor
@@ -65,12 +113,19 @@ namespace gdwg {
 				                                           e_ptr->weight};
 				               return std::make_shared<edge>(new_edge);
 			               });
+
+			hash_ = other.hash_;
+			if (other.topo_) {
+				enable_topological_order();
+			}
 		}
 
 		// Move Constructor
 		graph(graph&& other) noexcept
 		: nodes_{std::exchange(other.nodes_, std::set<std::shared_ptr<N>, node_comparator>())}
-		, edges_{std::exchange(other.edges_, std::set<std::shared_ptr<edge>, edge_comparator>())} {}
+		, edges_{std::exchange(other.edges_, std::set<std::shared_ptr<edge>, edge_comparator>())}
+		, topo_{std::move(other.topo_)}
+		, hash_{std::exchange(other.hash_, 0)} {}
 
 		// Copy Assignment
 		auto operator=(graph const& other) -> graph& {
@@ -91,13 +146,21 @@ namespace gdwg {
 			// Clear the moved from graph
 			other.nodes_.clear();
 			other.edges_.clear();
+			other.topo_.reset();
+			other.hash_ = 0;
 
 			return *this;
 		}
 
 		// Modifiers
 		auto insert_node(N const& value) -> bool {
-			return nodes_.emplace(std::make_shared<N>(value)).second;
+			auto const [it, inserted] = nodes_.emplace(std::make_shared<N>(value));
+			hash_ += inserted ? node_hash(value) : 0;
+			if (inserted and topo_) {
+				topo_->position.emplace(it->get(), topo_->order.size());
+				topo_->order.push_back(it->get());
+			}
+			return inserted;
 		}
 
 		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
@@ -107,7 +170,175 @@ namespace gdwg {
 			}
 
 			struct edge new_edge = {(*(nodes_.find(src))).get(), (*(nodes_.find(dst))).get(), weight};
-			return edges_.emplace(std::make_shared<edge>(new_edge)).second;
+			if (topo_ and edges_.find(new_edge) == edges_.end()) {
+				if (not topology_insert_edge(new_edge.src, new_edge.dst)) {
+					throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when the edge "
+					                         "would create a cycle");
+				}
+			}
+			auto const inserted = edges_.emplace(std::make_shared<edge>(new_edge)).second;
+			hash_ += inserted ? edge_hash(new_edge) : 0;
+			return inserted;
+		}
+
+		/* Bulk insert_node. Values are sorted first, unless they already are, and go in with a
+		 * position hint, so a batch into an empty or much smaller graph costs a sort plus linear
+		 * work. Returns the number of nodes inserted. */
+		template<typename InputIt>
+		auto insert_nodes(InputIt first, InputIt last) -> std::size_t {
+			auto values = std::vector<N>(first, last);
+			if (not std::is_sorted(values.begin(), values.end())) {
+				std::sort(values.begin(), values.end());
+			}
+			values.erase(std::unique(values.begin(), values.end()), values.end());
+
+			auto const before = nodes_.size();
+			auto hint = nodes_.cbegin();
+			for (auto& value : values) {
+				hint = bulk_position(nodes_, hint, value, values.size());
+				if (hint != nodes_.end() and not(value < **hint)) {
+					continue;
+				}
+				auto const it = nodes_.emplace_hint(hint, std::make_shared<N>(std::move(value)));
+				hash_ += node_hash(**it);
+				if (topo_) {
+					topo_->position.emplace(it->get(), topo_->order.size());
+					topo_->order.push_back(it->get());
+				}
+			}
+			return nodes_.size() - before;
+		}
+
+		/* Bulk insert_edge over value_type ranges, inserted the same way as insert_nodes. Throws
+		 * before changing anything if an endpoint is missing. While a topological order is
+		 * maintained edges go in one by one, so a cycle throws with the earlier edges kept.
+		 * Returns the number of edges inserted. */
+		template<typename InputIt>
+		auto insert_edges(InputIt first, InputIt last) -> std::size_t {
+			auto values = std::vector<value_type>(first, last);
+
+			// Resolve endpoints through a flat copy of nodes_, cheaper to search than the tree,
+			// unless the batch is too small to pay for the copy
+			auto table = std::vector<N*>();
+			if (nodes_.size() <= values.size() * 16) {
+				table.reserve(nodes_.size());
+				for (auto const& n_ptr : nodes_) {
+					table.push_back(n_ptr.get());
+				}
+			}
+			auto const resolve = [&](N const& value) -> N* {
+				auto found = static_cast<N*>(nullptr);
+				if (table.empty()) {
+					auto const it = nodes_.find(value);
+					found = it == nodes_.end() ? nullptr : it->get();
+				}
+				else {
+					auto const it = std::lower_bound(table.begin(),
+					                                 table.end(),
+					                                 value,
+					                                 [](N* lhs, N const& rhs) { return *lhs < rhs; });
+					found = it == table.end() or value < **it ? nullptr : *it;
+				}
+				if (found == nullptr) {
+					throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edges when either "
+					                         "src or dst node does not exist");
+				}
+				return found;
+			};
+
+			auto edges = std::vector<edge>();
+			edges.reserve(values.size());
+			for (auto const& value : values) {
+				edges.push_back(edge{resolve(value.from), resolve(value.to), value.weight});
+			}
+
+			auto const before = edges_.size();
+			if (topo_) {
+				for (auto const& e : edges) {
+					insert_edge(*e.src, *e.dst, e.weight);
+				}
+				return edges_.size() - before;
+			}
+
+			auto const less = [](edge const& lhs, edge const& rhs) {
+				return std::tie(*lhs.src, *lhs.dst, lhs.weight) < std::tie(*rhs.src, *rhs.dst, rhs.weight);
+			};
+			if (not std::is_sorted(edges.begin(), edges.end(), less)) {
+				std::sort(edges.begin(), edges.end(), less);
+			}
+			auto hint = edges_.cbegin();
+			for (auto i = std::size_t{0}; i < edges.size(); ++i) {
+				auto const& e = edges[i];
+				if (i > 0 and not less(edges[i - 1], e)) {
+					continue;
+				}
+				hint = bulk_position(edges_, hint, e, edges.size());
+				if (hint != edges_.end() and not edge_comparator()(e, *hint)) {
+					continue;
+				}
+				edges_.emplace_hint(hint, std::make_shared<edge>(e));
+				hash_ += edge_hash(e);
+			}
+			return edges_.size() - before;
+		}
+
+		/* Bulk erase_node. The erased nodes' edges go in one pass over edges_ rather than one pass
+		 * per node. Returns the number of nodes erased. */
+		template<typename InputIt>
+		auto erase_nodes(InputIt first, InputIt last) -> std::size_t {
+			auto found = std::vector<typename std::set<std::shared_ptr<N>, node_comparator>::iterator>();
+			auto erased = std::unordered_set<N const*>();
+			for (; first != last; ++first) {
+				auto const it = nodes_.find(*first);
+				if (it != nodes_.end() and erased.insert(it->get()).second) {
+					found.push_back(it);
+				}
+			}
+			if (found.empty()) {
+				return 0;
+			}
+
+			if (topo_) {
+				for (auto const it : found) {
+					topology_erase_node(it->get());
+				}
+			}
+			erase_edges_if([&](edge const& e) { return erased.contains(e.src) or erased.contains(e.dst); });
+			for (auto const it : found) {
+				hash_ -= node_hash(**it);
+				nodes_.erase(it);
+			}
+			return found.size();
+		}
+
+		/* Bulk erase_edge over value_type ranges, log(e) each. Throws before changing anything if
+		 * an endpoint is missing. Returns the number of edges erased. */
+		template<typename InputIt>
+		auto erase_edges(InputIt first, InputIt last) -> std::size_t {
+			auto found = std::vector<edges_iterator>();
+			for (; first != last; ++first) {
+				auto const& value = *first;
+				if (not is_node(value.from) or not is_node(value.to)) {
+					throw std::runtime_error("Cannot call gdwg::graph<N, E>::erase_edges on src or dst if "
+					                         "they don't exist in the graph");
+				}
+				if (auto const it = edges_.find(value); it != edges_.end()) {
+					found.push_back(it);
+				}
+			}
+
+			// The same edge may be named twice
+			auto const by_edge = [](edges_iterator lhs, edges_iterator rhs) { return lhs->get() < rhs->get(); };
+			std::sort(found.begin(), found.end(), by_edge);
+			found.erase(std::unique(found.begin(), found.end()), found.end());
+			for (auto const it : found) {
+				if (topo_) {
+					topology_erase_edge((*it)->src, (*it)->dst);
+				}
+				hash_ -= edge_hash(**it);
+				edges_.erase(it);
+			}
+			return found.size();
 		}
 
 		auto replace_node(N const& old_data, N const& new_data) -> bool {
@@ -124,6 +355,7 @@ namespace gdwg {
 			// Insert the new node
 			auto new_node = std::make_shared<N>(new_data);
 			nodes_.emplace(new_node);
+			hash_ += node_hash(new_data);
 
 			// Find all relevant edges
 			auto edge_ptrs = std::vector<std::shared_ptr<edge>>();
@@ -140,11 +372,18 @@ namespace gdwg {
 				auto new_dst_ptr = *(e_ptr->dst) == old_data ? new_node.get() : e_ptr->dst;
 
 				// Insert new and remove old
-				edges_.emplace(std::make_shared<edge>(edge{new_src_ptr, new_dst_ptr, e_ptr->weight}));
+				auto const new_edge = edge{new_src_ptr, new_dst_ptr, e_ptr->weight};
+				edges_.emplace(std::make_shared<edge>(new_edge));
+				hash_ += edge_hash(new_edge) - edge_hash(*e_ptr);
 				edges_.erase(e_ptr);
 			}
 
+			if (topo_) {
+				topology_rename(old_it->get(), new_node.get());
+			}
+
 			// Erase the old node
+			hash_ -= node_hash(old_data);
 			nodes_.erase(old_it);
 
 			return true;
@@ -158,6 +397,14 @@ namespace gdwg {
 				                         "new data if they don't exist in the graph");
 			}
 
+			if (topo_ and old_it != new_it
+			    and (topology_reaches(old_it->get(), new_it->get())
+			         or topology_reaches(new_it->get(), old_it->get())))
+			{
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::merge_replace_node when the "
+				                         "merge would create a cycle");
+			}
+
 			// Find all relevant nodes
 			auto edge_ptrs = std::vector<std::shared_ptr<edge>>();
 			std::copy_if(edges_.begin(),
@@ -173,16 +420,24 @@ namespace gdwg {
 				auto new_dst_ptr = *(e_ptr->dst) == old_data ? (*new_it).get() : e_ptr->dst;
 
 				struct edge new_edge = edge{new_src_ptr, new_dst_ptr, e_ptr->weight};
+				hash_ -= edge_hash(*e_ptr);
 				edges_.erase(e_ptr);
 
 				// If the new edge not exist, insert it
 				if (edges_.find(new_edge) == edges_.end()) {
 					edges_.emplace(std::make_shared<edge>(new_edge));
+					hash_ += edge_hash(new_edge);
 				}
 			}
 
 			// Remove the old node
+			hash_ -= node_hash(old_data);
 			nodes_.erase(old_it);
+
+			// Merging moves edges between arbitrary positions, so order from scratch
+			if (topo_) {
+				enable_topological_order();
+			}
 		}
 
 		/* Remove a node and all relevant edges */
@@ -191,10 +446,15 @@ namespace gdwg {
 				return false;
 			}
 
+			auto const node = nodes_.find(value);
+			if (topo_) {
+				topology_erase_node(node->get());
+			}
+
 			// Remove all relevant edges
-			std::erase_if(edges_,
-			              [&](auto const& e) { return *(e->src) == value or *(e->dst) == value; });
-			nodes_.erase(nodes_.find(value));
+			erase_edges_if([&](edge const& e) { return *(e.src) == value or *(e.dst) == value; });
+			hash_ -= node_hash(value);
+			nodes_.erase(node);
 
 			return true;
 		}
@@ -206,10 +466,14 @@ namespace gdwg {
 				                         "they don't exist in the graph");
 			}
 
-			auto count = std::erase_if(edges_, [&](auto const& e_ptr) { // e
-				return *(e_ptr->src) == src and *(e_ptr->dst) == dst and e_ptr->weight == weight;
+			auto count = erase_edges_if([&](edge const& e) { // e
+				return *(e.src) == src and *(e.dst) == dst and e.weight == weight;
 			});
 
+			if (count > 0 and topo_) {
+				topology_erase_edge(nodes_.find(src)->get(), nodes_.find(dst)->get());
+			}
+
 			return count > 0;
 		}
 
@@ -220,11 +484,21 @@ namespace gdwg {
 				return end();
 			}
 
+			if (topo_) {
+				topology_erase_edge((*i.it_)->src, (*i.it_)->dst);
+			}
+			hash_ -= edge_hash(**i.it_);
 			return iterator{edges_.erase(i.it_)};
 		}
 
 		/* Erase [i, s) */
 		auto erase_edge(iterator i, iterator s) -> iterator {
+			for (auto it = i.it_; it != s.it_; ++it) {
+				if (topo_) {
+					topology_erase_edge((*it)->src, (*it)->dst);
+				}
+				hash_ -= edge_hash(**it);
+			}
 			return iterator{edges_.erase(i.it_, s.it_)};
 		}
 
@@ -232,6 +506,10 @@ namespace gdwg {
 		auto clear() noexcept -> void {
 			nodes_.clear();
 			edges_.clear();
+			hash_ = 0;
+			if (topo_) {
+				*topo_ = topological_index();
+			}
 		}
 
 		// Accessors
@@ -287,7 +565,7 @@ namespace gdwg {
 			return iterator{edges_.find(value_type{src, dst, weight})};
 		}
 
-		// log (n) + e
+		// log (n) + log (e) + out-degree
 		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
 			if (not is_node(src)) { // log(n)
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections if src doesn't "
@@ -295,10 +573,9 @@ namespace gdwg {
 			}
 
 			auto dsts = std::vector<N>();
-			for (auto const& e_ptr : edges_) { // e
-				if (*(e_ptr->src) == src) {
-					dsts.push_back(*(e_ptr->dst));
-				}
+			auto const [first, last] = out_edges(&src); // log(e)
+			for (auto it = first; it != last; ++it) {
+				dsts.push_back(*((*it)->dst));
 			}
 
 			return dsts;
@@ -313,8 +590,140 @@ namespace gdwg {
 			return iterator{edges_.end()};
 		}
 
+		// Parallel traversal
+		/* Call f(node) for every node on the pool. Nodes are split into index ranges */
+		template<typename F>
+		auto parallel_for_each_node(F const& f, thread_pool& pool = thread_pool::default_pool()) const
+		   -> void {
+			auto node_ptrs = std::vector<N const*>();
+			node_ptrs.reserve(nodes_.size());
+			for (auto const& n_ptr : nodes_) {
+				node_ptrs.push_back(n_ptr.get());
+			}
+
+			pool.parallel_for(0, node_ptrs.size(), pool.grain_for(node_ptrs.size()), [&](std::size_t i) {
+				f(*node_ptrs[i]);
+			});
+		}
+
+		/* Call f(src, dst, weight) for every edge on the pool. One walk over edges_ cuts it into
+		 * segments of whole out-edge runs; only a run longer than twice the target segment size is
+		 * split, so a hub node does not end up as a single task. */
+		template<typename F>
+		auto parallel_for_each_edge(F const& f, thread_pool& pool = thread_pool::default_pool()) const
+		   -> void {
+			auto const target = pool.grain_for(edges_.size());
+
+			auto segments = std::vector<edges_iterator>();
+			auto count = std::size_t{0};
+			N const* prev_src = nullptr;
+			for (auto it = edges_.begin(); it != edges_.end(); ++it, ++count) {
+				auto const run_start = (*it)->src != prev_src;
+				if (segments.empty() or (run_start and count >= target) or count >= 2 * target) {
+					segments.push_back(it);
+					count = 0;
+				}
+				prev_src = (*it)->src;
+			}
+			segments.push_back(edges_.end());
+
+			pool.parallel_for(0, segments.size() - 1, 1, [&](std::size_t i) {
+				for (auto it = segments[i]; it != segments[i + 1]; ++it) {
+					f(*((*it)->src), *((*it)->dst), (*it)->weight);
+				}
+			});
+		}
+
+		// Topological order
+		/* Keep a topological order from now on, updated by every modifier (Pearce and Kelly).
+		 * insert_edge and merge_replace_node then throw instead of creating a cycle. Throws if
+		 * the graph already has one. */
+		auto enable_topological_order() -> void {
+			auto index = std::make_unique<topological_index>();
+			auto indegree = std::unordered_map<N const*, std::size_t>();
+			for (auto const& e_ptr : edges_) {
+				++index->in[e_ptr->dst][e_ptr->src];
+				++indegree[e_ptr->dst];
+			}
+
+			// Kahn's algorithm, emitting ready nodes in value order
+			auto& order = index->order;
+			for (auto const& n_ptr : nodes_) {
+				if (indegree[n_ptr.get()] == 0) {
+					order.push_back(n_ptr.get());
+				}
+			}
+			for (auto i = std::size_t{0}; i < order.size(); ++i) {
+				auto const [first, last] = out_edges(order[i]);
+				for (auto it = first; it != last; ++it) {
+					if (--indegree[(*it)->dst] == 0) {
+						order.push_back((*it)->dst);
+					}
+				}
+			}
+			if (order.size() != nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::enable_topological_order on a "
+				                         "graph with a cycle");
+			}
+
+			for (auto i = std::size_t{0}; i < order.size(); ++i) {
+				index->position.emplace(order[i], i);
+			}
+			topo_ = std::move(index);
+		}
+
+		auto disable_topological_order() noexcept -> void {
+			topo_.reset();
+		}
+
+		[[nodiscard]] auto maintains_topological_order() const noexcept -> bool {
+			return topo_ != nullptr;
+		}
+
+		/* Every node, each before all the nodes it has edges to. O(V) */
+		[[nodiscard]] auto topological_order() const -> std::vector<N> {
+			if (not topo_) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::topological_order unless the "
+				                         "topological order is enabled");
+			}
+
+			auto order = std::vector<N>();
+			order.reserve(nodes_.size());
+			for (auto const* n : topo_->order) {
+				if (n != nullptr) {
+					order.push_back(*n);
+				}
+			}
+			return order;
+		}
+
+		/* Only searches the nodes ordered between dst and src */
+		[[nodiscard]] auto would_create_cycle(N const& src, N const& dst) const -> bool {
+			if (not is_node(src) or not is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::would_create_cycle if src or "
+				                         "dst node don't exist in the graph");
+			}
+			if (not topo_) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::would_create_cycle unless the "
+				                         "topological order is enabled");
+			}
+
+			return src == dst or topology_reaches(nodes_.find(dst)->get(), nodes_.find(src)->get());
+		}
+
 		// Comparision
+		/* Kept up to date by every modifier, so O(1); the hash is a wrapping sum over nodes and
+		 * edges, which doesn't depend on insertion order */
+		[[nodiscard]] auto fingerprint() const noexcept -> graph_fingerprint {
+			return {nodes_.size(), edges_.size(), hash_};
+		}
+
+		/* Graphs with different fingerprints differ, which is O(1) to see; otherwise every node
+		 * and edge is compared */
 		[[nodiscard]] auto operator==(graph const& other) const -> bool {
+			if (fingerprint() != other.fingerprint()) {
+				return false;
+			}
 			return std::equal(nodes_.begin(),
 			                  nodes_.end(),
 			                  other.nodes_.begin(),
@@ -347,9 +756,22 @@ namespace gdwg {
 			}
 		};
 
+		// Orders an edge by its source alone, to find a node's out-edges
+		struct source_key {
+			N const* value;
+		};
+
 		struct edge_comparator {
 			using is_transparent = std::true_type;
 
+			auto operator()(std::shared_ptr<edge> const& lhs, source_key const& rhs) const -> bool {
+				return *(lhs->src) < *(rhs.value);
+			}
+
+			auto operator()(source_key const& lhs, std::shared_ptr<edge> const& rhs) const -> bool {
+				return *(lhs.value) < *(rhs->src);
+			}
+
 			auto operator()(std::shared_ptr<edge> const& lhs, std::shared_ptr<edge> const& rhs) const
 			   -> bool {
 				return std::tie(*(lhs->src), *(lhs->dst), lhs->weight)
@@ -381,32 +803,265 @@ namespace gdwg {
 			}
 		};
 
+		using edges_iterator = typename std::set<std::shared_ptr<edge>, edge_comparator>::const_iterator;
+
+		struct topological_index {
+			// order[position[n]] == n; erased nodes leave a nullptr hole
+			std::unordered_map<N const*, std::size_t> position;
+			std::vector<N const*> order;
+			std::size_t holes = 0;
+
+			// Predecessors of each node, with the number of edges from each
+			std::unordered_map<N const*, std::unordered_map<N const*, std::size_t>> in;
+		};
+
 		std::set<std::shared_ptr<N>, node_comparator> nodes_;
 		std::set<std::shared_ptr<edge>, edge_comparator> edges_;
 
+		// Only allocated while a topological order is maintained
+		std::unique_ptr<topological_index> topo_;
+
+		// Sum of node_hash over nodes_ and edge_hash over edges_, wrapping
+		std::uint64_t hash_ = 0;
+
 		/* Swap two graph */
 		static auto swap(graph<N, E>& first, graph<N, E>& second) noexcept {
 			std::swap(first.nodes_, second.nodes_);
 			std::swap(first.edges_, second.edges_);
+			std::swap(first.topo_, second.topo_);
+			std::swap(first.hash_, second.hash_);
+		}
+
+		static auto node_hash(N const& value) -> std::uint64_t {
+			return detail::fingerprint_mix(detail::fingerprint_hash(value));
+		}
+
+		// Mixed in a different order from node_hash, so an edge never cancels a node
+		static auto edge_hash(edge const& e) -> std::uint64_t {
+			auto h = detail::fingerprint_mix(detail::fingerprint_hash(*e.src) + 0x9e3779b97f4a7c15U);
+			h = detail::fingerprint_mix(h + detail::fingerprint_hash(*e.dst));
+			return detail::fingerprint_mix(h + detail::fingerprint_hash(e.weight));
+		}
+
+		/* std::erase_if over edges_ that keeps hash_ in step; pred takes an edge */
+		template<typename Pred>
+		auto erase_edges_if(Pred pred) -> std::size_t {
+			auto count = std::size_t{0};
+			for (auto it = edges_.begin(); it != edges_.end();) {
+				if (pred(**it)) {
+					hash_ -= edge_hash(**it);
+					it = edges_.erase(it);
+					++count;
+				}
+				else {
+					++it;
+				}
+			}
+			return count;
+		}
+
+		/* First element of a sorted set not less than value, for batches inserted in ascending
+		 * order. When the set is small next to the batch the hint just walks forward, which is
+		 * linear over the whole batch; otherwise each value searches the tree. */
+		template<typename Set, typename Value>
+		static auto bulk_position(Set const& set,
+		                          typename Set::const_iterator hint,
+		                          Value const& value,
+		                          std::size_t batch) -> typename Set::const_iterator {
+			if (set.size() > batch * 16) {
+				return set.lower_bound(value);
+			}
+			auto const less = set.key_comp();
+			while (hint != set.end() and less(*hint, value)) {
+				++hint;
+			}
+			return hint;
+		}
+
+		/* Out-edges of node, log(e) */
+		[[nodiscard]] auto out_edges(N const* node) const -> std::pair<edges_iterator, edges_iterator> {
+			return edges_.equal_range(source_key{node});
+		}
+
+		/* Whether to is reachable from from. A path can only lead to later positions, so the
+		 * search never leaves the nodes ordered between the two. */
+		[[nodiscard]] auto topology_reaches(N const* from, N const* to) const -> bool {
+			auto const bound = topo_->position.at(to);
+			if (from == to) {
+				return true;
+			}
+			if (topo_->position.at(from) > bound) {
+				return false;
+			}
+
+			auto seen = std::unordered_set<N const*>{from};
+			auto stack = std::vector<N const*>{from};
+			while (not stack.empty()) {
+				auto const [first, last] = out_edges(stack.back());
+				stack.pop_back();
+				for (auto it = first; it != last; ++it) {
+					auto const* next = (*it)->dst;
+					if (next == to) {
+						return true;
+					}
+					if (topo_->position.at(next) < bound and seen.insert(next).second) {
+						stack.push_back(next);
+					}
+				}
+			}
+			return false;
+		}
+
+		/* Pearce-Kelly: if dst is ordered before src, collect what dst reaches and what reaches
+		 * src within that window and reorder just those, everything reaching src first. Returns
+		 * false, changing nothing, if the edge would close a cycle. */
+		auto topology_insert_edge(N const* src, N const* dst) -> bool {
+			auto& position = topo_->position;
+			auto const lower = position.at(dst);
+			auto const upper = position.at(src);
+			if (src == dst) {
+				return false;
+			}
+
+			if (lower < upper) {
+				auto forward = std::vector<N const*>{dst};
+				auto seen = std::unordered_set<N const*>{dst};
+				for (auto i = std::size_t{0}; i < forward.size(); ++i) {
+					auto const [first, last] = out_edges(forward[i]);
+					for (auto it = first; it != last; ++it) {
+						auto const* next = (*it)->dst;
+						if (next == src) {
+							return false;
+						}
+						if (position.at(next) < upper and seen.insert(next).second) {
+							forward.push_back(next);
+						}
+					}
+				}
+
+				auto backward = std::vector<N const*>{src};
+				seen.insert(src);
+				for (auto i = std::size_t{0}; i < backward.size(); ++i) {
+					for (auto const& [prev, count] : topo_->in[backward[i]]) {
+						if (position.at(prev) > lower and seen.insert(prev).second) {
+							backward.push_back(prev);
+						}
+					}
+				}
+
+				auto const by_position = [&](N const* lhs, N const* rhs) {
+					return position.at(lhs) < position.at(rhs);
+				};
+				std::sort(forward.begin(), forward.end(), by_position);
+				std::sort(backward.begin(), backward.end(), by_position);
+
+				auto slots = std::vector<std::size_t>();
+				slots.reserve(forward.size() + backward.size());
+				for (auto const* n : backward) {
+					slots.push_back(position.at(n));
+				}
+				for (auto const* n : forward) {
+					slots.push_back(position.at(n));
+				}
+				std::sort(slots.begin(), slots.end());
+
+				auto slot = slots.begin();
+				auto const place = [&](N const* n) {
+					position[n] = *slot;
+					topo_->order[*slot] = n;
+					++slot;
+				};
+				std::for_each(backward.begin(), backward.end(), place);
+				std::for_each(forward.begin(), forward.end(), place);
+			}
+
+			++topo_->in[dst][src];
+			return true;
+		}
+
+		auto topology_erase_edge(N const* src, N const* dst) -> void {
+			auto& preds = topo_->in[dst];
+			auto const it = preds.find(src);
+			if (--it->second == 0) {
+				preds.erase(it);
+			}
+		}
+
+		/* Call before the node's edges go; compacts the order once holes outnumber nodes */
+		auto topology_erase_node(N const* node) -> void {
+			auto const [first, last] = out_edges(node);
+			for (auto it = first; it != last; ++it) {
+				topo_->in[(*it)->dst].erase(node);
+			}
+			topo_->in.erase(node);
+			topo_->order[topo_->position.at(node)] = nullptr;
+			topo_->position.erase(node);
+
+			if (++topo_->holes > topo_->position.size()) {
+				std::erase(topo_->order, nullptr);
+				for (auto i = std::size_t{0}; i < topo_->order.size(); ++i) {
+					topo_->position[topo_->order[i]] = i;
+				}
+				topo_->holes = 0;
+			}
+		}
+
+		/* Give renamed its old name's place; call once the edges point at renamed */
+		auto topology_rename(N const* old_node, N const* renamed) -> void {
+			auto const slot = topo_->position.at(old_node);
+			topo_->position.erase(old_node);
+			topo_->position.emplace(renamed, slot);
+			topo_->order[slot] = renamed;
+
+			if (auto const it = topo_->in.find(old_node); it != topo_->in.end()) {
+				topo_->in[renamed] = std::move(it->second);
+				topo_->in.erase(old_node);
+			}
+			auto const [first, last] = out_edges(renamed);
+			for (auto it = first; it != last; ++it) {
+				auto& preds = topo_->in[(*it)->dst];
+				if (auto const count = preds.find(old_node); count != preds.end()) {
+					preds[renamed] = count->second;
+					preds.erase(count);
+				}
+			}
 		}
 
+		// Snapshots read nodes_ and edges_ directly
+		friend class csr_graph<N, E>;
+		friend struct detail::graph_access<N, E>;
+
 		// Hidden Friend: Extractor
+		/* One merged pass: edges_ is sorted by source, so each node's edges follow the previous
+		 * node's. Text is formatted with default flags into a bounded buffer that is written out
+		 * whenever it fills, so memory stays flat however large the graph is. */
 		friend auto operator<<(std::ostream& os, graph const& g) -> std::ostream& {
+			constexpr auto flush_bytes = std::size_t{1} << 16U;
 			auto oss = std::ostringstream{};
-
-			std::for_each(g.nodes_.begin(), g.nodes_.end(), [&](auto const& n_ptr) {
+			auto const flush = [&] {
+				auto buffer = std::move(oss).str();
+				os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				buffer.clear();
+				oss.str(std::move(buffer));
+			};
+
+			auto e_it = g.edges_.begin();
+			for (auto const& n_ptr : g.nodes_) {
 				oss << *n_ptr << " (\n";
 
-				for (auto const& e_ptr : g.edges_) {
-					if (*(e_ptr->src) == *n_ptr) {
-						oss << "  " << *(e_ptr->dst) << " | " << e_ptr->weight << "\n";
+				for (; e_it != g.edges_.end() and (*e_it)->src == n_ptr.get(); ++e_it) {
+					oss << "  " << *((*e_it)->dst) << " | " << (*e_it)->weight << "\n";
+					if (oss.tellp() >= static_cast<std::streamoff>(flush_bytes)) {
+						flush();
 					}
 				}
 
 				oss << ")\n";
-			});
-
-			os << oss.str();
+				if (oss.tellp() >= static_cast<std::streamoff>(flush_bytes)) {
+					flush();
+				}
+			}
+			flush();
 
 			return os;
 		}
@@ -467,6 +1122,63 @@ namespace gdwg {
 			friend class graph<N, E>;
 		};
 	};
+
+	namespace detail {
+		/* The sorted sets behind a graph, for code outside the class that merges two graphs */
+		template<typename N, typename E>
+		struct graph_access {
+			static auto nodes(graph<N, E> const& g) -> auto const& {
+				return g.nodes_;
+			}
+
+			static auto edges(graph<N, E> const& g) -> auto const& {
+				return g.edges_;
+			}
+
+			/* Order elements of different graphs' sets by value, as each set orders its own */
+			static auto node_less(std::shared_ptr<N> const& lhs, std::shared_ptr<N> const& rhs) -> bool {
+				return *lhs < *rhs;
+			}
+
+			static auto edge_less(std::shared_ptr<typename graph<N, E>::edge> const& lhs,
+			                      std::shared_ptr<typename graph<N, E>::edge> const& rhs) -> bool {
+				return std::tie(*lhs->src, *lhs->dst, lhs->weight) < std::tie(*rhs->src, *rhs->dst, rhs->weight);
+			}
+		};
+
+		/* Walks two ranges sorted by less in one pass: left(x) for each element only in the first,
+		 * right(y) for each only in the second, and both(x, y) for each equal pair */
+		template<typename It1, typename It2, typename Less, typename Left, typename Right, typename Both>
+		auto merge_walk(It1 i, It1 i_last, It2 j, It2 j_last, Less less, Left left, Right right, Both both)
+		   -> void {
+			while (i != i_last and j != j_last) {
+				if (less(*i, *j)) {
+					left(*i++);
+				}
+				else if (less(*j, *i)) {
+					right(*j++);
+				}
+				else {
+					both(*i++, *j++);
+				}
+			}
+			for (; i != i_last; ++i) {
+				left(*i);
+			}
+			for (; j != j_last; ++j) {
+				right(*j);
+			}
+		}
+	} // namespace detail
 } // namespace gdwg
 
+// For keying caches by graph content
+template<>
+struct std::hash<gdwg::graph_fingerprint> {
+	auto operator()(gdwg::graph_fingerprint const& f) const noexcept -> std::size_t {
+		auto const sizes = gdwg::detail::fingerprint_mix(f.nodes * 0x9e3779b97f4a7c15U + f.edges);
+		return static_cast<std::size_t>(gdwg::detail::fingerprint_mix(f.hash ^ sizes));
+	}
+};
+
 #endif // GDWG_GRAPH_HPP
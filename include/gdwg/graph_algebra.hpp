@@ -0,0 +1,214 @@
+#ifndef GDWG_GRAPH_ALGEBRA_HPP
+#define GDWG_GRAPH_ALGEBRA_HPP
+
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	/* Set algebra over the nodes and edges of two graphs. Each operation walks both graphs'
+	 * sorted node and edge sets once, O(N + E) comparisons, and builds its result with
+	 * insert_nodes and insert_edges, which take the already sorted batches without a sort.
+	 *
+	 * The overloads taking the left graph as an rvalue work on it in place and return it, so
+	 * only the elements that change are inserted or erased:
+	 *
+	 *   g = gdwg::graph_union(std::move(g), other);
+	 *
+	 * Results carry no topological order; a graph modified in place keeps the one it has. */
+
+	namespace detail {
+		template<typename N, typename E>
+		auto edge_value(std::shared_ptr<typename graph<N, E>::edge> const& e_ptr)
+		   -> typename graph<N, E>::value_type {
+			return {*e_ptr->src, *e_ptr->dst, e_ptr->weight};
+		}
+
+		template<typename N, typename E>
+		auto from_sorted(std::vector<N> const& nodes,
+		                 std::vector<typename graph<N, E>::value_type> const& edges) -> graph<N, E> {
+			auto g = graph<N, E>();
+			g.insert_nodes(nodes.begin(), nodes.end());
+			g.insert_edges(edges.begin(), edges.end());
+			return g;
+		}
+	} // namespace detail
+
+	/* Nodes and edges in either graph */
+	template<typename N, typename E>
+	auto graph_union(graph<N, E> const& a, graph<N, E> const& b) -> graph<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto nodes = std::vector<N>();
+		auto const add_node = [&](auto const& n_ptr) { nodes.push_back(*n_ptr); };
+		detail::merge_walk(access::nodes(a).begin(),
+		                   access::nodes(a).end(),
+		                   access::nodes(b).begin(),
+		                   access::nodes(b).end(),
+		                   access::node_less,
+		                   add_node,
+		                   add_node,
+		                   [&](auto const& n_ptr, auto const&) { add_node(n_ptr); });
+
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		auto const add_edge = [&](auto const& e_ptr) { edges.push_back(detail::edge_value<N, E>(e_ptr)); };
+		detail::merge_walk(access::edges(a).begin(),
+		                   access::edges(a).end(),
+		                   access::edges(b).begin(),
+		                   access::edges(b).end(),
+		                   access::edge_less,
+		                   add_edge,
+		                   add_edge,
+		                   [&](auto const& e_ptr, auto const&) { add_edge(e_ptr); });
+		return detail::from_sorted<N, E>(nodes, edges);
+	}
+
+	/* Only b's nodes and edges that a lacks are inserted. Inserting an edge that closes a cycle
+	 * in a topologically ordered a throws, as insert_edges does. */
+	template<typename N, typename E>
+	auto graph_union(graph<N, E>&& a, graph<N, E> const& b) -> graph<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto nodes = std::vector<N>();
+		detail::merge_walk(
+		   access::nodes(a).begin(),
+		   access::nodes(a).end(),
+		   access::nodes(b).begin(),
+		   access::nodes(b).end(),
+		   access::node_less,
+		   [](auto const&) {},
+		   [&](auto const& n_ptr) { nodes.push_back(*n_ptr); },
+		   [](auto const&, auto const&) {});
+
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		detail::merge_walk(
+		   access::edges(a).begin(),
+		   access::edges(a).end(),
+		   access::edges(b).begin(),
+		   access::edges(b).end(),
+		   access::edge_less,
+		   [](auto const&) {},
+		   [&](auto const& e_ptr) { edges.push_back(detail::edge_value<N, E>(e_ptr)); },
+		   [](auto const&, auto const&) {});
+
+		a.insert_nodes(nodes.begin(), nodes.end());
+		a.insert_edges(edges.begin(), edges.end());
+		return std::move(a);
+	}
+
+	/* Nodes and edges in both graphs */
+	template<typename N, typename E>
+	auto graph_intersection(graph<N, E> const& a, graph<N, E> const& b) -> graph<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto nodes = std::vector<N>();
+		detail::merge_walk(
+		   access::nodes(a).begin(),
+		   access::nodes(a).end(),
+		   access::nodes(b).begin(),
+		   access::nodes(b).end(),
+		   access::node_less,
+		   [](auto const&) {},
+		   [](auto const&) {},
+		   [&](auto const& n_ptr, auto const&) { nodes.push_back(*n_ptr); });
+
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		detail::merge_walk(
+		   access::edges(a).begin(),
+		   access::edges(a).end(),
+		   access::edges(b).begin(),
+		   access::edges(b).end(),
+		   access::edge_less,
+		   [](auto const&) {},
+		   [](auto const&) {},
+		   [&](auto const& e_ptr, auto const&) { edges.push_back(detail::edge_value<N, E>(e_ptr)); });
+		return detail::from_sorted<N, E>(nodes, edges);
+	}
+
+	/* a's nodes and edges missing from b are erased. An edge in a but not in b goes with its
+	 * endpoint when that is erased, so only the others are erased one by one; the node walk
+	 * marks the erased endpoints by address, so telling them apart takes no lookups. */
+	template<typename N, typename E>
+	auto graph_intersection(graph<N, E>&& a, graph<N, E> const& b) -> graph<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto nodes = std::vector<N>();
+		auto gone = std::unordered_set<N const*>();
+		detail::merge_walk(
+		   access::nodes(a).begin(),
+		   access::nodes(a).end(),
+		   access::nodes(b).begin(),
+		   access::nodes(b).end(),
+		   access::node_less,
+		   [&](auto const& n_ptr) {
+			   nodes.push_back(*n_ptr);
+			   gone.insert(n_ptr.get());
+		   },
+		   [](auto const&) {},
+		   [](auto const&, auto const&) {});
+
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		detail::merge_walk(
+		   access::edges(a).begin(),
+		   access::edges(a).end(),
+		   access::edges(b).begin(),
+		   access::edges(b).end(),
+		   access::edge_less,
+		   [&](auto const& e_ptr) {
+			   if (not gone.contains(e_ptr->src) and not gone.contains(e_ptr->dst)) {
+				   edges.push_back(detail::edge_value<N, E>(e_ptr));
+			   }
+		   },
+		   [](auto const&) {},
+		   [](auto const&, auto const&) {});
+
+		a.erase_edges(edges.begin(), edges.end());
+		a.erase_nodes(nodes.begin(), nodes.end());
+		return std::move(a);
+	}
+
+	/* a's edges that aren't in b. All of a's nodes are kept: dropping the shared ones would take
+	 * a's edges between them and its own nodes along, so graph_union(graph_difference(a, b),
+	 * graph_intersection(a, b)) == a holds. */
+	template<typename N, typename E>
+	auto graph_difference(graph<N, E> const& a, graph<N, E> const& b) -> graph<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto nodes = std::vector<N>();
+		nodes.reserve(access::nodes(a).size());
+		for (auto const& n_ptr : access::nodes(a)) {
+			nodes.push_back(*n_ptr);
+		}
+
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		detail::merge_walk(
+		   access::edges(a).begin(),
+		   access::edges(a).end(),
+		   access::edges(b).begin(),
+		   access::edges(b).end(),
+		   access::edge_less,
+		   [&](auto const& e_ptr) { edges.push_back(detail::edge_value<N, E>(e_ptr)); },
+		   [](auto const&) {},
+		   [](auto const&, auto const&) {});
+		return detail::from_sorted<N, E>(nodes, edges);
+	}
+
+	/* The edges a shares with b are erased */
+	template<typename N, typename E>
+	auto graph_difference(graph<N, E>&& a, graph<N, E> const& b) -> graph<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto edges = std::vector<typename graph<N, E>::value_type>();
+		detail::merge_walk(
+		   access::edges(a).begin(),
+		   access::edges(a).end(),
+		   access::edges(b).begin(),
+		   access::edges(b).end(),
+		   access::edge_less,
+		   [](auto const&) {},
+		   [](auto const&) {},
+		   [&](auto const& e_ptr, auto const&) { edges.push_back(detail::edge_value<N, E>(e_ptr)); });
+
+		a.erase_edges(edges.begin(), edges.end());
+		return std::move(a);
+	}
+} // namespace gdwg
+
+#endif // GDWG_GRAPH_ALGEBRA_HPP
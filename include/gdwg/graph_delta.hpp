@@ -0,0 +1,196 @@
+#ifndef GDWG_GRAPH_DELTA_HPP
+#define GDWG_GRAPH_DELTA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/serialize.hpp"
+
+namespace gdwg {
+	/* The edits that turn one graph into another, each list sorted. Edges of erased nodes are
+	 * implied by erasing the node and aren't listed. */
+	template<typename N, typename E>
+	struct graph_delta {
+		using value_type = typename graph<N, E>::value_type;
+
+		std::vector<N> erased_nodes;
+		std::vector<value_type> erased_edges;
+		std::vector<N> inserted_nodes;
+		std::vector<value_type> inserted_edges;
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return size() == 0;
+		}
+
+		/* Number of edits */
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return erased_nodes.size() + erased_edges.size() + inserted_nodes.size() + inserted_edges.size();
+		}
+	};
+
+	/* O(N + E): one merge over each pair of sorted sets. patch(a, diff(a, b)) makes a == b. */
+	template<typename N, typename E>
+	auto diff(graph<N, E> const& a, graph<N, E> const& b) -> graph_delta<N, E> {
+		using access = detail::graph_access<N, E>;
+		auto delta = graph_delta<N, E>();
+
+		// Erased nodes are marked by address, so an edge's endpoints are checked without lookups
+		auto gone = std::unordered_set<N const*>();
+		auto const& a_nodes = access::nodes(a);
+		auto const& b_nodes = access::nodes(b);
+		detail::merge_walk(
+		   a_nodes.begin(),
+		   a_nodes.end(),
+		   b_nodes.begin(),
+		   b_nodes.end(),
+		   access::node_less,
+		   [&](auto const& n_ptr) {
+			   delta.erased_nodes.push_back(*n_ptr);
+			   gone.insert(n_ptr.get());
+		   },
+		   [&](auto const& n_ptr) { delta.inserted_nodes.push_back(*n_ptr); },
+		   [](auto const&, auto const&) {});
+		auto const& a_edges = access::edges(a);
+		auto const& b_edges = access::edges(b);
+		detail::merge_walk(
+		   a_edges.begin(),
+		   a_edges.end(),
+		   b_edges.begin(),
+		   b_edges.end(),
+		   access::edge_less,
+		   [&](auto const& e_ptr) {
+			   if (not gone.contains(e_ptr->src) and not gone.contains(e_ptr->dst)) {
+				   delta.erased_edges.push_back({*e_ptr->src, *e_ptr->dst, e_ptr->weight});
+			   }
+		   },
+		   [&](auto const& e_ptr) {
+			   delta.inserted_edges.push_back({*e_ptr->src, *e_ptr->dst, e_ptr->weight});
+		   },
+		   [](auto const&, auto const&) {});
+		return delta;
+	}
+
+	/* Applies delta to g with the bulk modifiers: erase_edges, erase_nodes, insert_nodes, then
+	 * insert_edges. Costs the size of the delta in tree operations, plus one pass over the edges
+	 * when nodes are erased. Edits that don't fit g, such as erasing what isn't there, are
+	 * skipped; an inserted edge whose endpoint is missing throws, as insert_edges does. */
+	template<typename N, typename E>
+	auto patch(graph<N, E>& g, graph_delta<N, E> const& delta) -> void {
+		auto erased_edges = std::vector<typename graph<N, E>::value_type>();
+		erased_edges.reserve(delta.erased_edges.size());
+		std::copy_if(delta.erased_edges.begin(),
+		             delta.erased_edges.end(),
+		             std::back_inserter(erased_edges),
+		             [&](auto const& e) { return g.is_node(e.from) and g.is_node(e.to); });
+		g.erase_edges(erased_edges.begin(), erased_edges.end());
+		g.erase_nodes(delta.erased_nodes.begin(), delta.erased_nodes.end());
+		g.insert_nodes(delta.inserted_nodes.begin(), delta.inserted_nodes.end());
+		g.insert_edges(delta.inserted_edges.begin(), delta.inserted_edges.end());
+	}
+
+	namespace detail {
+		inline constexpr auto delta_magic = std::string_view("GDWGDLT1", 8);
+
+		/* Edges grouped by source: each source once, then its destinations and weights */
+		template<typename N, typename E>
+		auto write_edges(std::ostream& os, std::vector<typename graph<N, E>::value_type> const& edges)
+		   -> void {
+			auto groups = std::uint64_t{0};
+			for (auto i = std::size_t{0}; i < edges.size(); ++i) {
+				groups += i == 0 or edges[i - 1].from != edges[i].from ? 1U : 0U;
+			}
+			serializer<std::uint64_t>::write(os, groups);
+			for (auto i = std::size_t{0}; i < edges.size();) {
+				auto end = i + 1;
+				while (end < edges.size() and edges[end].from == edges[i].from) {
+					++end;
+				}
+				serializer<N>::write(os, edges[i].from);
+				serializer<std::uint64_t>::write(os, end - i);
+				for (; i < end; ++i) {
+					serializer<N>::write(os, edges[i].to);
+					serializer<E>::write(os, edges[i].weight);
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto read_edges(std::istream& is) -> std::vector<typename graph<N, E>::value_type> {
+			auto edges = std::vector<typename graph<N, E>::value_type>();
+			auto const groups = serializer<std::uint64_t>::read(is);
+			for (auto g = std::uint64_t{0}; g < groups and is; ++g) {
+				auto const from = serializer<N>::read(is);
+				auto const count = serializer<std::uint64_t>::read(is);
+				for (auto e = std::uint64_t{0}; e < count and is; ++e) {
+					auto to = serializer<N>::read(is);
+					edges.push_back({from, std::move(to), serializer<E>::read(is)});
+				}
+			}
+			return edges;
+		}
+
+		template<typename N>
+		auto write_nodes(std::ostream& os, std::vector<N> const& nodes) -> void {
+			serializer<std::uint64_t>::write(os, nodes.size());
+			for (auto const& value : nodes) {
+				serializer<N>::write(os, value);
+			}
+		}
+
+		template<typename N>
+		auto read_nodes(std::istream& is) -> std::vector<N> {
+			auto nodes = std::vector<N>();
+			auto const count = serializer<std::uint64_t>::read(is);
+			for (auto i = std::uint64_t{0}; i < count and is; ++i) {
+				nodes.push_back(serializer<N>::read(is));
+			}
+			return nodes;
+		}
+	} // namespace detail
+
+	/* Writes delta with gdwg::serializer, edges grouped by source so each is written once */
+	template<typename N, typename E>
+	auto write_delta(std::ostream& os, graph_delta<N, E> const& delta) -> void {
+		os.write(detail::delta_magic.data(), static_cast<std::streamsize>(detail::delta_magic.size()));
+		detail::write_nodes(os, delta.erased_nodes);
+		detail::write_edges<N, E>(os, delta.erased_edges);
+		detail::write_nodes(os, delta.inserted_nodes);
+		detail::write_edges<N, E>(os, delta.inserted_edges);
+		if (not os) {
+			throw std::runtime_error("Cannot call gdwg::write_delta on a stream that failed");
+		}
+	}
+
+	template<typename N, typename E>
+	auto read_delta(std::istream& is) -> graph_delta<N, E> {
+		auto magic = std::string(detail::delta_magic.size(), '\0');
+		is.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+		if (not is or magic != detail::delta_magic) {
+			throw std::runtime_error("Cannot call gdwg::read_delta on a stream that doesn't hold a "
+			                         "graph delta");
+		}
+
+		auto delta = graph_delta<N, E>();
+		delta.erased_nodes = detail::read_nodes<N>(is);
+		delta.erased_edges = detail::read_edges<N, E>(is);
+		delta.inserted_nodes = detail::read_nodes<N>(is);
+		delta.inserted_edges = detail::read_edges<N, E>(is);
+		if (not is) {
+			throw std::runtime_error("Cannot call gdwg::read_delta on a truncated graph delta");
+		}
+		return delta;
+	}
+} // namespace gdwg
+
+#endif // GDWG_GRAPH_DELTA_HPP
@@ -0,0 +1,160 @@
+#ifndef GDWG_HEAP_HPP
+#define GDWG_HEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	/* Min-heaps of (key, value) pairs for label-setting searches. None of them supports
+	 * decrease-key: searches push a fresh entry and skip stale ones when they are popped. */
+
+	/* Implicit d-ary heap; arity 2 is the classic binary heap. Wider heaps are shallower, which
+	 * makes push cheaper and pop a little dearer. */
+	template<typename K, typename V>
+	class dary_heap {
+	public:
+		explicit dary_heap(std::size_t arity = 2)
+		: arity_{std::max(arity, std::size_t{2})} {}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return items_.empty();
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return items_.size();
+		}
+
+		[[nodiscard]] auto top() const -> std::pair<K, V> const& {
+			return items_.front();
+		}
+
+		auto push(K key, V value) -> void {
+			items_.emplace_back(std::move(key), std::move(value));
+
+			// Sift up
+			auto i = items_.size() - 1;
+			while (i > 0) {
+				auto const parent = (i - 1) / arity_;
+				if (not(items_[i].first < items_[parent].first)) {
+					break;
+				}
+				std::swap(items_[i], items_[parent]);
+				i = parent;
+			}
+		}
+
+		auto pop() -> std::pair<K, V> {
+			auto top = std::move(items_.front());
+			if (items_.size() > 1) {
+				items_.front() = std::move(items_.back());
+			}
+			items_.pop_back();
+
+			// Sift down
+			auto i = std::size_t{0};
+			while (true) {
+				auto const first_child = i * arity_ + 1;
+				if (first_child >= items_.size()) {
+					break;
+				}
+
+				auto const last_child = std::min(first_child + arity_, items_.size());
+				auto best = first_child;
+				for (auto c = first_child + 1; c < last_child; ++c) {
+					if (items_[c].first < items_[best].first) {
+						best = c;
+					}
+				}
+
+				if (not(items_[best].first < items_[i].first)) {
+					break;
+				}
+				std::swap(items_[i], items_[best]);
+				i = best;
+			}
+
+			return top;
+		}
+
+	private:
+		std::size_t arity_;
+		std::vector<std::pair<K, V>> items_;
+	};
+
+	/* Monotone radix heap for non-negative integer keys (Ahuja et al.). Keys may never be smaller
+	 * than the last key popped, which holds for Dijkstra with non-negative weights. Each entry
+	 * moves down at most 64 buckets over its lifetime, so operations are O(1) amortised with
+	 * a small constant. */
+	template<typename K, typename V>
+	requires std::is_integral_v<K>
+	class radix_heap {
+	public:
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return size_ == 0;
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return size_;
+		}
+
+		auto push(K key, V value) -> void {
+			if (std::cmp_less(key, 0) or static_cast<std::uint64_t>(key) < last_) {
+				throw std::runtime_error("Cannot call gdwg::radix_heap<K, V>::push with a negative key "
+				                         "or a key smaller than the last one popped");
+			}
+
+			auto const k = static_cast<std::uint64_t>(key);
+			buckets_[bucket_of(k)].emplace_back(k, std::move(value));
+			++size_;
+		}
+
+		auto pop() -> std::pair<K, V> {
+			if (buckets_[0].empty()) {
+				redistribute();
+			}
+
+			auto [key, value] = std::move(buckets_[0].back());
+			buckets_[0].pop_back();
+			--size_;
+			return {static_cast<K>(key), std::move(value)};
+		}
+
+	private:
+		std::array<std::vector<std::pair<std::uint64_t, V>>, 65> buckets_;
+		std::uint64_t last_ = 0;
+		std::size_t size_ = 0;
+
+		/* Bucket i holds keys whose highest bit differing from last_ is bit i - 1 */
+		[[nodiscard]] auto bucket_of(std::uint64_t key) const -> std::size_t {
+			return static_cast<std::size_t>(std::bit_width(key ^ last_));
+		}
+
+		/* Move the smallest non-empty bucket down around its minimum. Everything lands in a lower
+		 * bucket, and the minimum itself in bucket 0. */
+		auto redistribute() -> void {
+			auto i = std::size_t{1};
+			while (buckets_[i].empty()) {
+				++i;
+			}
+
+			last_ = std::min_element(buckets_[i].begin(),
+			                         buckets_[i].end(),
+			                         [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; })
+			           ->first;
+
+			for (auto& item : buckets_[i]) {
+				buckets_[bucket_of(item.first)].push_back(std::move(item));
+			}
+			buckets_[i].clear();
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_HEAP_HPP
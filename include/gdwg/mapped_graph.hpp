@@ -0,0 +1,535 @@
+#ifndef GDWG_MAPPED_GRAPH_HPP
+#define GDWG_MAPPED_GRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GDWG_HAS_MMAP 1
+#else
+#define GDWG_HAS_MMAP 0
+#endif
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/serialize.hpp"
+
+namespace gdwg {
+	/* On-disk graph layout, version 1. Every section starts on a 64-byte boundary and holds
+	 * plain arrays in host byte order, so a mapping of the file can be used in place:
+	 *
+	 *   header
+	 *   nodes        node_count values of N, ascending; or serialized values, see node_index
+	 *   node_index   node_count + 1 byte offsets into nodes, only when N is serialized
+	 *   offsets      node_count + 1 uint64, out-edges of id are [offsets[id], offsets[id + 1])
+	 *   targets      edge_count node_id, sorted within each row
+	 *   weights      edge_count values of E; or serialized values, see weight_index
+	 *   weight_index edge_count + 1 byte offsets into weights, only when E is serialized
+	 *
+	 * Trivially copyable N and E are stored as arrays; anything else goes through
+	 * gdwg::serializer, one value after another with an index beside it. */
+	struct binary_header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byte_order;
+		std::uint64_t node_count;
+		std::uint64_t edge_count;
+
+		// sizeof the stored type, or 0 when the column is serialized
+		std::uint32_t node_size;
+		std::uint32_t weight_size;
+
+		std::uint64_t nodes;
+		std::uint64_t node_index;
+		std::uint64_t offsets;
+		std::uint64_t targets;
+		std::uint64_t weights;
+		std::uint64_t weight_index;
+		std::uint64_t file_size;
+	};
+	static_assert(std::is_trivially_copyable_v<binary_header> and sizeof(binary_header) == 96);
+
+	namespace detail {
+		inline constexpr auto binary_magic = std::string_view("GDWGBIN1", 8);
+		inline constexpr auto binary_version = std::uint32_t{1};
+		inline constexpr auto binary_byte_order = std::uint32_t{0x01020304};
+		inline constexpr auto binary_alignment = std::uint64_t{64};
+
+		template<typename T>
+		inline constexpr auto stored_as_array = std::is_trivially_copyable_v<T>;
+
+		/* A read-only view of bytes as an input stream, for serializer<T>::read */
+		class memory_buffer : public std::streambuf {
+		public:
+			memory_buffer(std::byte const* first, std::byte const* last) {
+				auto* const begin = const_cast<char*>(reinterpret_cast<char const*>(first));
+				setg(begin, begin, begin + (last - first));
+			}
+		};
+
+		/* Read-only mapping of a whole file. Falls back to reading it into memory where mmap is
+		 * unavailable. */
+		class file_mapping {
+		public:
+			file_mapping() = default;
+
+			explicit file_mapping(std::string const& path) {
+#if GDWG_HAS_MMAP
+				auto const fd = ::open(path.c_str(), O_RDONLY);
+				if (fd < 0) {
+					throw std::runtime_error("Cannot open " + path + " for mapping");
+				}
+				struct stat status {};
+				if (::fstat(fd, &status) != 0) {
+					::close(fd);
+					throw std::runtime_error("Cannot read the size of " + path);
+				}
+				size_ = static_cast<std::size_t>(status.st_size);
+				if (size_ != 0) {
+					auto* const address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+					if (address == MAP_FAILED) {
+						::close(fd);
+						throw std::runtime_error("Cannot map " + path);
+					}
+					data_ = static_cast<std::byte const*>(address);
+				}
+				::close(fd);
+#else
+				auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+				if (not file) {
+					throw std::runtime_error("Cannot open " + path + " for mapping");
+				}
+				size_ = static_cast<std::size_t>(file.tellg());
+				// uint64_t storage keeps the sections aligned
+				fallback_.resize((size_ + 7) / 8);
+				file.seekg(0);
+				file.read(reinterpret_cast<char*>(fallback_.data()), static_cast<std::streamsize>(size_));
+				data_ = reinterpret_cast<std::byte const*>(fallback_.data());
+#endif
+			}
+
+			file_mapping(file_mapping const&) = delete;
+			auto operator=(file_mapping const&) -> file_mapping& = delete;
+
+			file_mapping(file_mapping&& other) noexcept
+			: data_{std::exchange(other.data_, nullptr)}
+			, size_{std::exchange(other.size_, 0)}
+#if not GDWG_HAS_MMAP
+			, fallback_{std::move(other.fallback_)}
+#endif
+			{
+			}
+
+			auto operator=(file_mapping&& other) noexcept -> file_mapping& {
+				auto moved = file_mapping(std::move(other));
+				std::swap(data_, moved.data_);
+				std::swap(size_, moved.size_);
+#if not GDWG_HAS_MMAP
+				std::swap(fallback_, moved.fallback_);
+#endif
+				return *this;
+			}
+
+			~file_mapping() {
+#if GDWG_HAS_MMAP
+				if (data_ != nullptr) {
+					::munmap(const_cast<std::byte*>(data_), size_);
+				}
+#endif
+			}
+
+			[[nodiscard]] auto data() const noexcept -> std::byte const* {
+				return data_;
+			}
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return size_;
+			}
+
+		private:
+			std::byte const* data_ = nullptr;
+			std::size_t size_ = 0;
+#if not GDWG_HAS_MMAP
+			std::vector<std::uint64_t> fallback_;
+#endif
+		};
+
+		/* Stored values of one column: an array for trivially copyable T, otherwise serialized
+		 * values with a byte index */
+		template<typename T>
+		class mapped_column {
+		public:
+			mapped_column() = default;
+
+			mapped_column(std::byte const* values, std::uint64_t const* index)
+			: values_{values}
+			, index_{index} {}
+
+			[[nodiscard]] auto operator[](std::size_t i) const -> decltype(auto) {
+				if constexpr (stored_as_array<T>) {
+					return reinterpret_cast<T const*>(values_)[i];
+				}
+				else {
+					auto buffer = memory_buffer(values_ + index_[i], values_ + index_[i + 1]);
+					auto is = std::istream(&buffer);
+					return serializer<T>::read(is);
+				}
+			}
+
+			[[nodiscard]] auto array() const noexcept -> T const* requires stored_as_array<T> {
+				return reinterpret_cast<T const*>(values_);
+			}
+
+			/* Index entries of count values never go backwards */
+			[[nodiscard]] auto consistent(std::size_t count) const -> bool {
+				if constexpr (stored_as_array<T>) {
+					return true;
+				}
+				else {
+					return std::is_sorted(index_, index_ + count + 1);
+				}
+			}
+
+		private:
+			std::byte const* values_ = nullptr;
+			std::uint64_t const* index_ = nullptr;
+		};
+
+		/* What is wrong with a header for a file of file_size bytes holding N and E, or nullptr.
+		 * Only the header is checked; the sections are trusted to match it. */
+		template<typename N, typename E>
+		auto header_error(binary_header const& header, std::uint64_t file_size) -> char const* {
+			if (std::string_view(header.magic, sizeof(header.magic)) != binary_magic) {
+				return "a file that doesn't hold a graph";
+			}
+			if (header.version != binary_version or header.byte_order != binary_byte_order) {
+				return "a file of another version or byte order";
+			}
+			if (header.node_size != (stored_as_array<N> ? sizeof(N) : 0)
+			    or header.weight_size != (stored_as_array<E> ? sizeof(E) : 0))
+			{
+				return "a file written with other node or weight types";
+			}
+
+			auto const n = header.node_count;
+			auto const m = header.edge_count;
+			// Counts are checked against the space left by division, so a forged count can't wrap
+			// the byte size it implies
+			auto const fits = [file_size](std::uint64_t at, std::uint64_t count, std::uint64_t size) {
+				return at % binary_alignment == 0 and at <= file_size
+				       and (size == 0 or count <= (file_size - at) / size);
+			};
+			if (n >= no_node or m > file_size / sizeof(node_id) or header.file_size != file_size
+			    or not fits(header.nodes, n, stored_as_array<N> ? sizeof(N) : 0)
+			    or not fits(header.node_index, n + 1, stored_as_array<N> ? 0 : sizeof(std::uint64_t))
+			    or not fits(header.offsets, n + 1, sizeof(std::uint64_t))
+			    or not fits(header.targets, m, sizeof(node_id))
+			    or not fits(header.weights, m, stored_as_array<E> ? sizeof(E) : 0)
+			    or not fits(header.weight_index, m + 1, stored_as_array<E> ? 0 : sizeof(std::uint64_t)))
+			{
+				return "a truncated or corrupt file";
+			}
+			return nullptr;
+		}
+
+		inline auto align_up(std::uint64_t offset) -> std::uint64_t {
+			return (offset + binary_alignment - 1) / binary_alignment * binary_alignment;
+		}
+
+		/* Bytes of a column and, when serialized, its index */
+		template<typename T, typename Values>
+		auto encode_column(Values const& values) -> std::pair<std::string, std::vector<std::uint64_t>> {
+			if constexpr (stored_as_array<T>) {
+				auto bytes = std::string(values.size() * sizeof(T), '\0');
+				if (not values.empty()) {
+					std::memcpy(bytes.data(), values.data(), bytes.size());
+				}
+				return {std::move(bytes), {}};
+			}
+			else {
+				auto os = std::ostringstream();
+				auto index = std::vector<std::uint64_t>{0};
+				index.reserve(values.size() + 1);
+				for (auto const& value : values) {
+					serializer<T>::write(os, value);
+					index.push_back(static_cast<std::uint64_t>(os.tellp()));
+				}
+				return {std::move(os).str(), std::move(index)};
+			}
+		}
+	} // namespace detail
+
+	/* Writes g in the binary layout, ready for gdwg::mapped_graph */
+	template<typename N, typename E>
+	auto save_binary(csr_graph<N, E> const& g, std::ostream& os) -> void {
+		auto const empty_nodes = std::vector<N>();
+		auto const& node_values = g.empty() ? empty_nodes : *g.node_table();
+		auto const weights = g.weights();
+		auto const [node_bytes, node_index] = detail::encode_column<N>(node_values);
+		auto const [weight_bytes, weight_index] = detail::encode_column<E>(weights);
+		auto offsets = std::vector<std::uint64_t>(g.offsets().begin(), g.offsets().end());
+		if (offsets.empty()) {
+			offsets.push_back(0);
+		}
+
+		auto header = binary_header{};
+		std::memcpy(header.magic, detail::binary_magic.data(), sizeof(header.magic));
+		header.version = detail::binary_version;
+		header.byte_order = detail::binary_byte_order;
+		header.node_count = g.node_count();
+		header.edge_count = g.edge_count();
+		header.node_size = detail::stored_as_array<N> ? sizeof(N) : 0;
+		header.weight_size = detail::stored_as_array<E> ? sizeof(E) : 0;
+
+		// Lay the sections out back to back, each aligned
+		auto end = std::uint64_t{sizeof(binary_header)};
+		auto const place = [&](std::uint64_t bytes) {
+			auto const at = detail::align_up(end);
+			end = at + bytes;
+			return at;
+		};
+		header.nodes = place(node_bytes.size());
+		header.node_index = place(node_index.size() * sizeof(std::uint64_t));
+		header.offsets = place(offsets.size() * sizeof(std::uint64_t));
+		header.targets = place(g.edge_count() * sizeof(node_id));
+		header.weights = place(weight_bytes.size());
+		header.weight_index = place(weight_index.size() * sizeof(std::uint64_t));
+		header.file_size = end;
+
+		auto written = std::uint64_t{0};
+		auto const write = [&](std::uint64_t at, void const* data, std::uint64_t bytes) {
+			static constexpr char padding[detail::binary_alignment] = {};
+			os.write(padding, static_cast<std::streamsize>(at - written));
+			os.write(static_cast<char const*>(data), static_cast<std::streamsize>(bytes));
+			written = at + bytes;
+		};
+		write(0, &header, sizeof(header));
+		write(header.nodes, node_bytes.data(), node_bytes.size());
+		write(header.node_index, node_index.data(), node_index.size() * sizeof(std::uint64_t));
+		write(header.offsets, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+		write(header.targets, g.targets().data(), g.edge_count() * sizeof(node_id));
+		write(header.weights, weight_bytes.data(), weight_bytes.size());
+		write(header.weight_index, weight_index.data(), weight_index.size() * sizeof(std::uint64_t));
+
+		if (not os) {
+			throw std::runtime_error("Cannot call gdwg::save_binary on a stream that failed");
+		}
+	}
+
+	template<typename N, typename E>
+	auto save_binary(graph<N, E> const& g, std::string const& path) -> void {
+		auto os = std::ofstream(path, std::ios::binary | std::ios::trunc);
+		if (not os) {
+			throw std::runtime_error("Cannot call gdwg::save_binary on a file that can't be opened");
+		}
+		save_binary(csr_graph<N, E>(g), os);
+	}
+
+	/* A read-only graph over a file written by gdwg::save_binary. Opening maps the file and checks
+	 * the header and section bounds, nothing more: node values, offsets, targets and trivially
+	 * copyable weights are read in place, so startup costs page faults rather than rebuilding.
+	 * verify() does the full O(V + E) consistency check for files of unknown origin.
+	 *
+	 * Node ids, rows and ordering are exactly those of csr_graph<N, E>. Serialized node or
+	 * weight types are decoded on access, so node() and weight() return them by value. */
+	template<typename N, typename E>
+	class mapped_graph {
+	public:
+		explicit mapped_graph(std::string const& path)
+		: file_{path} {
+			if (file_.size() < sizeof(binary_header)) {
+				fail("a file too short to hold a graph");
+			}
+			std::memcpy(&header_, file_.data(), sizeof(header_));
+			if (auto const* const error = detail::header_error<N, E>(header_, file_.size())) {
+				fail(error);
+			}
+
+			auto const n = header_.node_count;
+			auto const m = header_.edge_count;
+			offsets_ = section<std::uint64_t>(header_.offsets);
+			targets_ = section<node_id>(header_.targets);
+			auto const* const node_index =
+			   detail::stored_as_array<N> ? nullptr : section<std::uint64_t>(header_.node_index);
+			auto const* const weight_index =
+			   detail::stored_as_array<E> ? nullptr : section<std::uint64_t>(header_.weight_index);
+			// Compared by subtraction, so a forged index entry can't wrap the end of its column
+			if (offsets_[0] != 0 or offsets_[n] != m
+			    or (node_index != nullptr
+			        and (header_.node_index < header_.nodes
+			             or node_index[n] > header_.node_index - header_.nodes))
+			    or (weight_index != nullptr
+			        and (header_.weight_index < header_.weights
+			             or weight_index[m] > header_.weight_index - header_.weights)))
+			{
+				fail("a truncated or corrupt file");
+			}
+			nodes_ = detail::mapped_column<N>(section<std::byte>(header_.nodes), node_index);
+			weights_ = detail::mapped_column<E>(section<std::byte>(header_.weights), weight_index);
+		}
+
+		// Accessors
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return static_cast<std::size_t>(header_.node_count);
+		}
+
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return static_cast<std::size_t>(header_.edge_count);
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return node_count() == 0;
+		}
+
+		/* Size of the mapped file */
+		[[nodiscard]] auto mapped_bytes() const noexcept -> std::size_t {
+			return file_.size();
+		}
+
+		[[nodiscard]] auto node(node_id id) const -> decltype(auto) {
+			return nodes_[id];
+		}
+
+		/* log(n). no_node if value is not a node */
+		[[nodiscard]] auto find(N const& value) const -> node_id {
+			auto low = std::size_t{0};
+			auto high = node_count();
+			while (low < high) {
+				auto const mid = low + (high - low) / 2;
+				if (nodes_[mid] < value) {
+					low = mid + 1;
+				}
+				else {
+					high = mid;
+				}
+			}
+			return low == node_count() or value < nodes_[low] ? no_node : static_cast<node_id>(low);
+		}
+
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return find(value) != no_node;
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const s = find(src);
+			auto const d = find(dst);
+			if (s == no_node or d == no_node) {
+				throw std::runtime_error("Cannot call gdwg::mapped_graph<N, E>::is_connected if src or "
+				                         "dst node don't exist in the graph");
+			}
+			auto const row = targets(s);
+			return std::binary_search(row.begin(), row.end(), d);
+		}
+
+		[[nodiscard]] auto out_degree(node_id id) const -> std::size_t {
+			return static_cast<std::size_t>(offsets_[id + 1] - offsets_[id]);
+		}
+
+		/* Destinations of id's out-edges, ascending, parallel edges adjacent */
+		[[nodiscard]] auto targets(node_id id) const -> std::span<node_id const> {
+			return {targets_ + offsets_[id], out_degree(id)};
+		}
+
+		/* Weight of the e-th edge in row order */
+		[[nodiscard]] auto weight(std::size_t e) const -> decltype(auto) {
+			return weights_[e];
+		}
+
+		[[nodiscard]] auto weights(node_id id) const -> std::span<E const>
+		requires detail::stored_as_array<E> {
+			return {weights_.array() + offsets_[id], out_degree(id)};
+		}
+
+		[[nodiscard]] auto offsets() const noexcept -> std::span<std::uint64_t const> {
+			return {offsets_, node_count() + 1};
+		}
+
+		[[nodiscard]] auto targets() const noexcept -> std::span<node_id const> {
+			return {targets_, edge_count()};
+		}
+
+		/* O(V + E): serialized values in order, nodes strictly ascending, offsets non-decreasing
+		 * and within the edges, and targets in range and sorted within each row */
+		[[nodiscard]] auto verify() const -> bool {
+			if (not nodes_.consistent(node_count()) or not weights_.consistent(edge_count())) {
+				return false;
+			}
+			for (auto id = std::size_t{1}; id < node_count(); ++id) {
+				if (not(nodes_[id - 1] < nodes_[id])) {
+					return false;
+				}
+			}
+			for (auto id = node_id{0}; id < node_count(); ++id) {
+				if (offsets_[id] > offsets_[id + 1] or offsets_[id + 1] > edge_count()) {
+					return false;
+				}
+				auto const row = targets(id);
+				if (not std::is_sorted(row.begin(), row.end())
+				    or std::any_of(row.begin(), row.end(), [&](node_id v) { return v >= node_count(); }))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/* Copies everything into an in-memory graph */
+		[[nodiscard]] auto to_graph() const -> graph<N, E> {
+			auto values = std::vector<N>();
+			values.reserve(node_count());
+			for (auto id = node_id{0}; id < node_count(); ++id) {
+				values.push_back(node(id));
+			}
+			auto edges = std::vector<typename graph<N, E>::value_type>();
+			edges.reserve(edge_count());
+			for (auto id = node_id{0}; id < node_count(); ++id) {
+				for (auto e = offsets_[id]; e < offsets_[id + 1]; ++e) {
+					edges.push_back({values[id], values[targets_[e]], weight(static_cast<std::size_t>(e))});
+				}
+			}
+
+			// Rows come out sorted, so the bulk inserts never search
+			auto g = graph<N, E>();
+			g.insert_nodes(values.begin(), values.end());
+			g.insert_edges(edges.begin(), edges.end());
+			return g;
+		}
+
+	private:
+		detail::file_mapping file_;
+		binary_header header_{};
+		std::uint64_t const* offsets_ = nullptr;
+		node_id const* targets_ = nullptr;
+		detail::mapped_column<N> nodes_;
+		detail::mapped_column<E> weights_;
+
+		[[noreturn]] static auto fail(std::string const& what) -> void {
+			throw std::runtime_error("Cannot construct gdwg::mapped_graph<N, E> from " + what);
+		}
+
+		template<typename T>
+		[[nodiscard]] auto section(std::uint64_t at) const -> T const* {
+			return reinterpret_cast<T const*>(file_.data() + at);
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_MAPPED_GRAPH_HPP
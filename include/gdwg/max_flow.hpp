@@ -0,0 +1,374 @@
+#ifndef GDWG_MAX_FLOW_HPP
+#define GDWG_MAX_FLOW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	/* Edge weights usable as capacities: summed, compared and split by subtraction */
+	template<typename E>
+	concept flow_capacity = std::is_arithmetic_v<E> and not std::is_same_v<E, bool>;
+
+	template<typename N, typename E>
+	struct flow_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		E value{};
+
+		// Flow on each edge, in edge order (the order graph iterates edges and csr_graph stores
+		// them). Parallel edges fill up in that order.
+		std::vector<E> flow;
+
+		// Indexed by node id: the source side of a minimum cut
+		std::vector<bool> source_side;
+
+		[[nodiscard]] auto on_source_side(N const& node) const -> bool {
+			auto const id = detail::find_node(*nodes, node);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::flow_result<N, E>::on_source_side on a node "
+				                         "that doesn't exist in the graph");
+			}
+			return source_side[id];
+		}
+	};
+
+	template<typename N, typename E>
+	struct cut_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		E value{};
+
+		// Indexed by node id
+		std::vector<bool> source_side;
+
+		// Edges from the source side to the sink side; their weights add up to value
+		std::vector<typename graph<N, E>::value_type> edges;
+	};
+
+	namespace detail {
+		/* Highest-label push-relabel over a residual graph with one arc pair per connected node
+		 * pair, parallel edges merged into one arc by adding their capacities. Labels are exact
+		 * BFS distances after every global relabel: to the sink where it's reachable, otherwise n
+		 * plus the distance back to the source, so excess that can't reach the sink drains home
+		 * in the same loop and the result is a flow, not just a preflow. */
+		template<typename E>
+		class push_relabel {
+		public:
+			template<typename N>
+			push_relabel(csr_graph<N, E> const& g, node_id source, node_id sink)
+			: n_{g.node_count()}
+			, source_{source}
+			, sink_{sink} {
+				build(g);
+				run();
+			}
+
+			[[nodiscard]] auto value() const -> E {
+				return excess_[sink_];
+			}
+
+			/* Flow per csr edge, filling parallel edges in order */
+			template<typename N>
+			[[nodiscard]] auto edge_flows(csr_graph<N, E> const& g) const -> std::vector<E> {
+				auto flows = std::vector<E>(g.edge_count(), E{});
+				auto const weights = g.weights();
+				auto remaining = E{};
+				for (auto e = std::size_t{0}; e < flows.size(); ++e) {
+					auto const a = edge_arc_[e];
+					if (a == no_arc) {
+						continue;
+					}
+					if (e == 0 or edge_arc_[e - 1] != a) {
+						remaining = static_cast<E>(capacity_[a] - residual_[a]);
+					}
+					flows[e] = std::min(weights[e], remaining);
+					remaining = static_cast<E>(remaining - flows[e]);
+				}
+				return flows;
+			}
+
+			/* Nodes the source still reaches in the residual graph */
+			[[nodiscard]] auto source_side() const -> std::vector<bool> {
+				auto side = std::vector<bool>(n_, false);
+				auto queue = std::vector<node_id>{source_};
+				side[source_] = true;
+				for (auto i = std::size_t{0}; i < queue.size(); ++i) {
+					auto const u = queue[i];
+					for (auto a = first_[u]; a < first_[u + 1]; ++a) {
+						if (residual_[a] > E{} and not side[head_[a]]) {
+							side[head_[a]] = true;
+							queue.push_back(head_[a]);
+						}
+					}
+				}
+				return side;
+			}
+
+		private:
+			static constexpr auto no_arc = static_cast<std::size_t>(-1);
+
+			std::size_t n_;
+			node_id source_;
+			node_id sink_;
+
+			// Arcs of u are [first_[u], first_[u + 1]); reverse_[a] is a's partner
+			std::vector<std::size_t> first_;
+			std::vector<node_id> head_;
+			std::vector<std::size_t> reverse_;
+			std::vector<E> capacity_;
+			std::vector<E> residual_;
+			std::vector<std::size_t> edge_arc_;
+
+			std::vector<std::size_t> label_;
+			std::vector<E> excess_;
+			std::vector<std::size_t> current_;
+			std::vector<std::vector<node_id>> active_;
+			std::size_t highest_ = 0;
+
+			/* O(V + E): count arcs per node, prefix sum, then place each pair */
+			template<typename N>
+			auto build(csr_graph<N, E> const& g) -> void {
+				auto const offsets = g.offsets();
+				auto const targets = g.targets();
+				auto const weights = g.weights();
+				auto const run_start = [&](node_id u, std::size_t e) {
+					return targets[e] != u and (e == offsets[u] or targets[e - 1] != targets[e]);
+				};
+
+				first_.assign(n_ + 1, 0);
+				for (auto u = node_id{0}; u < n_; ++u) {
+					for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+						if (weights[e] < E{}) {
+							throw std::runtime_error("Cannot call gdwg::max_flow or gdwg::min_cut with "
+							                         "negative edge weights");
+						}
+						if (run_start(u, e)) {
+							++first_[u + 1];
+							++first_[targets[e] + 1];
+						}
+					}
+				}
+				for (auto u = std::size_t{1}; u <= n_; ++u) {
+					first_[u] += first_[u - 1];
+				}
+
+				auto const arcs = first_[n_];
+				head_.resize(arcs);
+				reverse_.resize(arcs);
+				capacity_.assign(arcs, E{});
+				edge_arc_.assign(g.edge_count(), no_arc);
+				auto next = std::vector<std::size_t>(first_.begin(), first_.end() - 1);
+				for (auto u = node_id{0}; u < n_; ++u) {
+					auto forward = no_arc;
+					for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+						auto const v = targets[e];
+						if (v == u) {
+							continue;
+						}
+						if (run_start(u, e)) {
+							forward = next[u]++;
+							auto const backward = next[v]++;
+							head_[forward] = v;
+							head_[backward] = u;
+							reverse_[forward] = backward;
+							reverse_[backward] = forward;
+						}
+						capacity_[forward] = static_cast<E>(capacity_[forward] + weights[e]);
+						edge_arc_[e] = forward;
+					}
+				}
+				residual_ = capacity_;
+			}
+
+			auto run() -> void {
+				label_.assign(n_, 0);
+				excess_.assign(n_, E{});
+				current_.assign(n_, 0);
+				active_.assign(2 * n_ + 1, {});
+
+				for (auto a = first_[source_]; a < first_[source_ + 1]; ++a) {
+					push(a, residual_[a]);
+				}
+				global_relabel();
+
+				// Relabel work between global relabels, in arc scans
+				auto const period = 6 * n_ + first_[n_];
+				auto work = std::size_t{0};
+				while (true) {
+					while (highest_ > 0 and active_[highest_].empty()) {
+						--highest_;
+					}
+					if (active_[highest_].empty()) {
+						break;
+					}
+
+					auto const u = active_[highest_].back();
+					active_[highest_].pop_back();
+					work += discharge(u);
+					if (work > period) {
+						global_relabel();
+						work = 0;
+					}
+				}
+			}
+
+			auto activate(node_id v) -> void {
+				if (v == source_ or v == sink_ or label_[v] >= 2 * n_) {
+					return;
+				}
+				active_[label_[v]].push_back(v);
+				highest_ = std::max(highest_, label_[v]);
+			}
+
+			auto push(std::size_t a, E amount) -> void {
+				auto const v = head_[a];
+				auto const u = head_[reverse_[a]];
+				residual_[a] = static_cast<E>(residual_[a] - amount);
+				residual_[reverse_[a]] = static_cast<E>(residual_[reverse_[a]] + amount);
+				excess_[u] = static_cast<E>(excess_[u] - amount);
+				auto const was_idle = not(excess_[v] > E{});
+				excess_[v] = static_cast<E>(excess_[v] + amount);
+				if (was_idle and excess_[v] > E{}) {
+					activate(v);
+				}
+			}
+
+			/* Push along admissible arcs until u's excess is gone, relabelling when they run out.
+			 * Returns the relabel work done. */
+			auto discharge(node_id u) -> std::size_t {
+				auto work = std::size_t{0};
+				while (excess_[u] > E{}) {
+					if (current_[u] == first_[u + 1]) {
+						auto lowest = 2 * n_ - 1;
+						for (auto a = first_[u]; a < first_[u + 1]; ++a) {
+							if (residual_[a] > E{}) {
+								lowest = std::min(lowest, label_[head_[a]]);
+							}
+						}
+						label_[u] = lowest + 1;
+						current_[u] = first_[u];
+						work += first_[u + 1] - first_[u] + 12;
+						if (label_[u] >= 2 * n_) {
+							break;
+						}
+						continue;
+					}
+
+					auto const a = current_[u];
+					if (residual_[a] > E{} and label_[u] == label_[head_[a]] + 1) {
+						push(a, std::min(excess_[u], residual_[a]));
+					}
+					else {
+						++current_[u];
+					}
+				}
+				return work;
+			}
+
+			/* Exact labels by backward BFS from the sink, then from the source for the rest */
+			auto global_relabel() -> void {
+				auto const unlabelled = 2 * n_;
+				label_.assign(n_, unlabelled);
+				auto queue = std::vector<node_id>();
+				queue.reserve(n_);
+				auto const search = [&](node_id root, std::size_t base) {
+					label_[root] = base;
+					auto const start = queue.size();
+					queue.push_back(root);
+					for (auto i = start; i < queue.size(); ++i) {
+						auto const u = queue[i];
+						for (auto a = first_[u]; a < first_[u + 1]; ++a) {
+							auto const v = head_[a];
+							if (label_[v] == unlabelled and residual_[reverse_[a]] > E{}) {
+								label_[v] = label_[u] + 1;
+								queue.push_back(v);
+							}
+						}
+					}
+				};
+				// The source never gets a label from the sink's search
+				label_[source_] = n_;
+				search(sink_, 0);
+				search(source_, n_);
+
+				for (auto& bucket : active_) {
+					bucket.clear();
+				}
+				highest_ = 0;
+				for (auto v = node_id{0}; v < n_; ++v) {
+					current_[v] = first_[v];
+					if (excess_[v] > E{}) {
+						activate(v);
+					}
+				}
+			}
+		};
+
+		template<typename N, typename E>
+		auto flow_terminals(csr_graph<N, E> const& g, N const& source, N const& sink)
+		   -> std::pair<node_id, node_id> {
+			auto const s = g.find(source);
+			auto const t = g.find(sink);
+			if (s == no_node or t == no_node) {
+				throw std::runtime_error("Cannot call gdwg::max_flow or gdwg::min_cut if source or sink "
+				                         "doesn't exist in the graph");
+			}
+			if (s == t) {
+				throw std::runtime_error("Cannot call gdwg::max_flow or gdwg::min_cut with the same "
+				                         "source and sink");
+			}
+			return {s, t};
+		}
+	} // namespace detail
+
+	/* Maximum flow from source to sink, edge weights as capacities. Parallel edges add up and
+	 * self loops carry nothing. E must be wide enough to hold the total capacity leaving the
+	 * source. */
+	template<typename N, flow_capacity E>
+	auto max_flow(csr_graph<N, E> const& g, N const& source, N const& sink) -> flow_result<N, E> {
+		auto const [s, t] = detail::flow_terminals(g, source, sink);
+		auto const engine = detail::push_relabel<E>(g, s, t);
+		return {g.node_table(), engine.value(), engine.edge_flows(g), engine.source_side()};
+	}
+
+	template<typename N, flow_capacity E>
+	auto max_flow(graph<N, E> const& g, N const& source, N const& sink) -> flow_result<N, E> {
+		return max_flow(csr_graph<N, E>(g), source, sink);
+	}
+
+	/* Minimum source-sink cut: the nodes the source reaches in the residual graph of a maximum
+	 * flow, and the saturated edges leaving them */
+	template<typename N, flow_capacity E>
+	auto min_cut(csr_graph<N, E> const& g, N const& source, N const& sink) -> cut_result<N, E> {
+		auto const [s, t] = detail::flow_terminals(g, source, sink);
+		auto const engine = detail::push_relabel<E>(g, s, t);
+		auto result = cut_result<N, E>{g.node_table(), engine.value(), engine.source_side(), {}};
+		for (auto u = node_id{0}; u < g.node_count(); ++u) {
+			if (not result.source_side[u]) {
+				continue;
+			}
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				if (not result.source_side[targets[e]]) {
+					result.edges.push_back({g.node(u), g.node(targets[e]), weights[e]});
+				}
+			}
+		}
+		return result;
+	}
+
+	template<typename N, flow_capacity E>
+	auto min_cut(graph<N, E> const& g, N const& source, N const& sink) -> cut_result<N, E> {
+		return min_cut(csr_graph<N, E>(g), source, sink);
+	}
+} // namespace gdwg
+
+#endif // GDWG_MAX_FLOW_HPP
@@ -0,0 +1,278 @@
+#ifndef GDWG_NEIGHBORHOOD_HPP
+#define GDWG_NEIGHBORHOOD_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "gdwg/bitmap.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct neighborhood_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+	};
+
+	template<typename N>
+	struct k_hop_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+		std::size_t k = 0;
+
+		// Seed node ids, in the order they were given
+		std::vector<node_id> seeds;
+
+		// Hop h of seed i is members[offsets[i * (k + 1) + h], offsets[i * (k + 1) + h + 1]),
+		// ascending. Hop 0 is the seed itself; every node appears at the first hop it's reached.
+		std::vector<std::size_t> offsets;
+		std::vector<node_id> members;
+
+		[[nodiscard]] auto seed_count() const noexcept -> std::size_t {
+			return seeds.size();
+		}
+
+		/* Ids first reached from seed i after exactly h hops */
+		[[nodiscard]] auto hop(std::size_t i, std::size_t h) const -> std::span<node_id const> {
+			auto const first = offsets[i * (k + 1) + h];
+			return std::span<node_id const>(members).subspan(first, offsets[i * (k + 1) + h + 1] - first);
+		}
+
+		/* Ids within k hops of seed i, hop by hop */
+		[[nodiscard]] auto neighborhood(std::size_t i) const -> std::span<node_id const> {
+			auto const first = offsets[i * (k + 1)];
+			return std::span<node_id const>(members).subspan(first, offsets[(i + 1) * (k + 1)] - first);
+		}
+
+		[[nodiscard]] auto hop_nodes(std::size_t i, std::size_t h) const -> std::vector<N> {
+			auto values = std::vector<N>();
+			for (auto const id : hop(i, h)) {
+				values.push_back((*nodes)[id]);
+			}
+			return values;
+		}
+	};
+
+	namespace detail {
+		// Seeds expanded together, one bit each in a word per node
+		inline constexpr auto k_hop_batch = std::size_t{64};
+
+		// Runs of batches per thread, each with its own scratch; more than one lets idle threads steal
+		inline constexpr auto k_hop_pieces_per_thread = std::size_t{2};
+
+		/* Frontier words for one run of batches. Every entry is zero between batches, so reusing
+		 * them only costs the nodes a batch touched. */
+		struct k_hop_scratch {
+			std::vector<std::uint64_t> seen;
+			std::vector<std::uint64_t> frontier;
+			std::vector<std::uint64_t> next;
+			std::vector<node_id> active;
+			std::vector<node_id> discovered;
+			std::vector<node_id> touched;
+
+			explicit k_hop_scratch(std::size_t n)
+			: seen(n, 0)
+			, frontier(n, 0)
+			, next(n, 0) {}
+		};
+
+		/* Breadth-first search from up to 64 seeds at once. Each node carries a word whose bit j
+		 * says seed j's frontier holds it, so a node shared by several neighbourhoods is expanded
+		 * once per hop for all of them. Returns bucket j * (k + 1) + h with seed j's hop h. */
+		template<typename N, typename E>
+		auto k_hop_batch_search(csr_graph<N, E> const& g,
+		                        std::span<node_id const> seeds,
+		                        std::size_t k,
+		                        k_hop_scratch& scratch) -> std::vector<std::vector<node_id>> {
+			auto& [seen, frontier, next, active, discovered, touched] = scratch;
+			auto buckets = std::vector<std::vector<node_id>>(seeds.size() * (k + 1));
+			active.clear();
+			touched.clear();
+			for (auto j = std::size_t{0}; j < seeds.size(); ++j) {
+				auto const s = seeds[j];
+				auto const bit = std::uint64_t{1} << j;
+				if (frontier[s] == 0) {
+					active.push_back(s);
+					touched.push_back(s);
+				}
+				frontier[s] |= bit;
+				seen[s] |= bit;
+				buckets[j * (k + 1)].push_back(s);
+			}
+
+			for (auto h = std::size_t{1}; h <= k and not active.empty(); ++h) {
+				discovered.clear();
+				for (auto const v : active) {
+					auto const bits = frontier[v];
+					for (auto const w : g.targets(v)) {
+						auto const fresh = bits & ~seen[w];
+						if (fresh == 0) {
+							continue;
+						}
+						if (next[w] == 0) {
+							discovered.push_back(w);
+						}
+						next[w] |= fresh;
+					}
+				}
+
+				for (auto const v : active) {
+					frontier[v] = 0;
+				}
+				for (auto const w : discovered) {
+					if (seen[w] == 0) {
+						touched.push_back(w);
+					}
+					seen[w] |= next[w];
+					for (auto bits = next[w]; bits != 0; bits &= bits - 1) {
+						auto const j = static_cast<std::size_t>(std::countr_zero(bits));
+						buckets[j * (k + 1) + h].push_back(w);
+					}
+					frontier[w] = next[w];
+					next[w] = 0;
+				}
+				std::swap(active, discovered);
+			}
+
+			for (auto const v : active) {
+				frontier[v] = 0;
+			}
+			for (auto const v : touched) {
+				seen[v] = 0;
+			}
+			for (auto& bucket : buckets) {
+				std::sort(bucket.begin(), bucket.end());
+			}
+			return buckets;
+		}
+
+		template<typename N>
+		auto seed_ids(std::vector<N> const& nodes, std::vector<N> const& seeds, char const* message)
+		   -> std::vector<node_id> {
+			auto ids = std::vector<node_id>();
+			ids.reserve(seeds.size());
+			for (auto const& seed : seeds) {
+				auto const id = find_node(nodes, seed);
+				if (id == no_node) {
+					throw std::runtime_error(message);
+				}
+				ids.push_back(id);
+			}
+			return ids;
+		}
+	} // namespace detail
+
+	/* Nodes within k out-hops of every seed, grouped by the hop they're first reached at. Seeds
+	 * are searched 64 at a time with bitmap frontiers (MS-BFS), and batches run in parallel on the
+	 * pool. Frontier words are allocated once per run of batches, and each batch only touches
+	 * the nodes it reaches, so beyond that the cost follows the neighbourhood sizes rather than the
+	 * graph size. */
+	template<typename N, typename E>
+	auto k_hop_neighbors(csr_graph<N, E> const& g,
+	                     std::vector<N> const& seeds,
+	                     std::size_t k,
+	                     neighborhood_options const& options = {}) -> k_hop_result<N> {
+		auto result = k_hop_result<N>{g.node_table(), k, {}, {}, {}};
+		if (not seeds.empty()) {
+			result.seeds = detail::seed_ids(*result.nodes,
+			                                seeds,
+			                                "Cannot call gdwg::k_hop_neighbors on a seed that doesn't "
+			                                "exist in the graph");
+		}
+
+		auto const batches = (seeds.size() + detail::k_hop_batch - 1) / detail::k_hop_batch;
+		auto found = std::vector<std::vector<std::vector<node_id>>>(batches);
+		auto const threads = options.pool == nullptr ? std::size_t{1} : options.pool->size() + 1;
+		auto const pieces = std::min(batches, threads * detail::k_hop_pieces_per_thread);
+		detail::for_range(options.pool, 0, pieces, 1, [&](std::size_t p) {
+			auto scratch = detail::k_hop_scratch(g.node_count());
+			for (auto b = batches * p / pieces; b < batches * (p + 1) / pieces; ++b) {
+				auto const first = b * detail::k_hop_batch;
+				auto const count = std::min(detail::k_hop_batch, seeds.size() - first);
+				auto const batch = std::span(result.seeds).subspan(first, count);
+				found[b] = detail::k_hop_batch_search(g, batch, k, scratch);
+			}
+		});
+
+		result.offsets.reserve(seeds.size() * (k + 1) + 1);
+		result.offsets.push_back(0);
+		for (auto const& buckets : found) {
+			for (auto const& bucket : buckets) {
+				result.offsets.push_back(result.offsets.back() + bucket.size());
+			}
+		}
+
+		result.members.resize(result.offsets.back());
+		detail::for_range(options.pool, 0, batches, 1, [&](std::size_t b) {
+			auto const first_bucket = b * detail::k_hop_batch * (k + 1);
+			for (auto i = std::size_t{0}; i < found[b].size(); ++i) {
+				auto const& bucket = found[b][i];
+				auto const at = static_cast<std::ptrdiff_t>(result.offsets[first_bucket + i]);
+				std::copy(bucket.begin(), bucket.end(), result.members.begin() + at);
+			}
+			found[b] = {};
+		});
+		return result;
+	}
+
+	template<typename N, typename E>
+	auto k_hop_neighbors(graph<N, E> const& g,
+	                     std::vector<N> const& seeds,
+	                     std::size_t k,
+	                     neighborhood_options const& options = {}) -> k_hop_result<N> {
+		return k_hop_neighbors(csr_graph<N, E>(g), seeds, k, options);
+	}
+
+	/* The subgraph induced by the nodes within k out-hops of seed: those nodes and every edge
+	 * between them, weights included */
+	template<typename N, typename E>
+	auto ego_graph(csr_graph<N, E> const& g, N const& seed, std::size_t k) -> graph<N, E> {
+		auto const s = g.find(seed);
+		if (s == no_node) {
+			throw std::runtime_error("Cannot call gdwg::ego_graph on a seed that doesn't exist in the "
+			                         "graph");
+		}
+
+		auto inside = bitmap(g.node_count());
+		auto members = std::vector<node_id>{s};
+		inside.set(s);
+		for (auto h = std::size_t{0}, first = std::size_t{0}; h < k and first < members.size(); ++h) {
+			auto const last = members.size();
+			for (; first < last; ++first) {
+				for (auto const w : g.targets(members[first])) {
+					if (not inside.test(w)) {
+						inside.set(w);
+						members.push_back(w);
+					}
+				}
+			}
+		}
+
+		auto ego = graph<N, E>{};
+		inside.for_each([&](std::size_t v) { ego.insert_node(g.node(static_cast<node_id>(v))); });
+		inside.for_each([&](std::size_t v) {
+			auto const u = static_cast<node_id>(v);
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				if (inside.test(targets[e])) {
+					ego.insert_edge(g.node(u), g.node(targets[e]), weights[e]);
+				}
+			}
+		});
+		return ego;
+	}
+
+	template<typename N, typename E>
+	auto ego_graph(graph<N, E> const& g, N const& seed, std::size_t k) -> graph<N, E> {
+		return ego_graph(csr_graph<N, E>(g), seed, k);
+	}
+} // namespace gdwg
+
+#endif // GDWG_NEIGHBORHOOD_HPP
@@ -0,0 +1,472 @@
+#ifndef GDWG_PAGED_GRAPH_HPP
+#define GDWG_PAGED_GRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "gdwg/serialize.hpp"
+
+namespace gdwg {
+	struct paged_graph_options {
+		// Bytes per segment, rounded up to a whole number of pages
+		std::size_t segment_bytes = std::size_t{1} << 20U;
+
+		// Segments kept mapped at once; memory use is bounded by segment_bytes times this. A scan
+		// reads offsets, targets, weights and node values together, so keep at least four plus
+		// room for the node values that are looked up often
+		std::size_t cache_segments = 64;
+	};
+
+	struct paged_io_stats {
+		// Reads served by a segment that was already mapped
+		std::uint64_t hits = 0;
+
+		// Segments mapped, and the bytes they covered
+		std::uint64_t misses = 0;
+		std::uint64_t bytes_mapped = 0;
+
+		// Segments unmapped to make room
+		std::uint64_t evictions = 0;
+	};
+
+	namespace detail {
+		/* A file read through a bounded set of fixed-size mapped segments, least recently used
+		 * first out. Every read copies, so values may straddle segment boundaries. */
+		class segment_cache {
+		public:
+			segment_cache(std::string const& path, paged_graph_options const& options)
+			: capacity_{std::max(options.cache_segments, std::size_t{1})} {
+#if GDWG_HAS_MMAP
+				fd_ = ::open(path.c_str(), O_RDONLY);
+				if (fd_ < 0) {
+					throw std::runtime_error("Cannot open " + path + " for mapping");
+				}
+				struct stat status {};
+				if (::fstat(fd_, &status) != 0) {
+					::close(fd_);
+					throw std::runtime_error("Cannot read the size of " + path);
+				}
+				size_ = static_cast<std::uint64_t>(status.st_size);
+				auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+				file_.open(path, std::ios::binary | std::ios::ate);
+				if (not file_) {
+					throw std::runtime_error("Cannot open " + path + " for mapping");
+				}
+				size_ = static_cast<std::uint64_t>(file_.tellg());
+				auto const page = std::size_t{4096};
+#endif
+				segment_bytes_ = (std::max(options.segment_bytes, std::size_t{1}) + page - 1) / page * page;
+			}
+
+			segment_cache(segment_cache const&) = delete;
+			auto operator=(segment_cache const&) -> segment_cache& = delete;
+
+			~segment_cache() {
+				while (not lru_.empty()) {
+					evict();
+				}
+#if GDWG_HAS_MMAP
+				::close(fd_);
+#endif
+			}
+
+			[[nodiscard]] auto size() const noexcept -> std::uint64_t {
+				return size_;
+			}
+
+			[[nodiscard]] auto stats() const noexcept -> paged_io_stats const& {
+				return stats_;
+			}
+
+			auto reset_stats() noexcept -> void {
+				stats_ = {};
+			}
+
+			/* Copies bytes [offset, offset + count) of the file into out */
+			auto read(std::uint64_t offset, void* out, std::size_t count) -> void {
+				auto* destination = static_cast<std::byte*>(out);
+				while (count != 0) {
+					auto const index = static_cast<std::size_t>(offset / segment_bytes_);
+					auto const& seg = acquire(index);
+					auto const within = static_cast<std::size_t>(offset - std::uint64_t{index} * segment_bytes_);
+					auto const n = std::min(count, seg.size - within);
+					std::memcpy(destination, seg.data + within, n);
+					destination += n;
+					offset += n;
+					count -= n;
+				}
+			}
+
+			template<typename T>
+			auto load(std::uint64_t offset) -> T {
+				auto value = T{};
+				read(offset, &value, sizeof(T));
+				return value;
+			}
+
+		private:
+			struct segment {
+				std::size_t index = 0;
+				std::byte const* data = nullptr;
+				std::size_t size = 0;
+#if not GDWG_HAS_MMAP
+				std::vector<std::byte> buffer;
+#endif
+			};
+
+			std::list<segment> lru_;
+			std::unordered_map<std::size_t, std::list<segment>::iterator> where_;
+			std::size_t capacity_;
+			std::size_t segment_bytes_ = 0;
+			std::uint64_t size_ = 0;
+			paged_io_stats stats_;
+#if GDWG_HAS_MMAP
+			int fd_ = -1;
+#else
+			std::ifstream file_;
+#endif
+
+			auto acquire(std::size_t index) -> segment const& {
+				// Most reads land in the segment used last
+				if (not lru_.empty() and lru_.front().index == index) {
+					++stats_.hits;
+					return lru_.front();
+				}
+				if (auto const it = where_.find(index); it != where_.end()) {
+					++stats_.hits;
+					lru_.splice(lru_.begin(), lru_, it->second);
+					return lru_.front();
+				}
+				if (lru_.size() == capacity_) {
+					evict();
+				}
+
+				auto const offset = std::uint64_t{index} * segment_bytes_;
+				if (offset >= size_) {
+					throw std::runtime_error("Cannot read past the end of a gdwg::paged_graph file");
+				}
+				auto seg = segment{};
+				seg.index = index;
+				seg.size = static_cast<std::size_t>(std::min<std::uint64_t>(segment_bytes_, size_ - offset));
+#if GDWG_HAS_MMAP
+				auto* const address =
+				   ::mmap(nullptr, seg.size, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(offset));
+				if (address == MAP_FAILED) {
+					throw std::runtime_error("Cannot map a segment of a gdwg::paged_graph file");
+				}
+				// Fault the whole segment in with one large read rather than page by page
+				::madvise(address, seg.size, MADV_WILLNEED);
+				seg.data = static_cast<std::byte const*>(address);
+#else
+				seg.buffer.resize(seg.size);
+				file_.seekg(static_cast<std::streamoff>(offset));
+				file_.read(reinterpret_cast<char*>(seg.buffer.data()), static_cast<std::streamsize>(seg.size));
+				seg.data = seg.buffer.data();
+#endif
+				++stats_.misses;
+				stats_.bytes_mapped += seg.size;
+				lru_.push_front(std::move(seg));
+				where_.emplace(index, lru_.begin());
+				return lru_.front();
+			}
+
+			auto evict() -> void {
+				auto const& seg = lru_.back();
+#if GDWG_HAS_MMAP
+				::munmap(const_cast<std::byte*>(seg.data), seg.size);
+#endif
+				where_.erase(seg.index);
+				lru_.pop_back();
+				++stats_.evictions;
+			}
+		};
+	} // namespace detail
+
+	/* A read-only graph over a file written by gdwg::save_binary, for graphs that don't fit in
+	 * memory. Unlike gdwg::mapped_graph, which maps the whole file, the file is read through a
+	 * cache of cache_segments mapped segments, so resident memory stays bounded however big the
+	 * file is. The layout is CSR sorted by source, so a row and its weights sit in a few adjacent
+	 * segments and iteration reads the file front to back.
+	 *
+	 * Accessors mirror gdwg::graph and return values, since nothing stays mapped for long. The
+	 * cache is updated by const accessors, so a paged_graph must not be shared between threads;
+	 * open one per thread instead. */
+	template<typename N, typename E>
+	class paged_graph {
+	public:
+		using value_type = typename graph<N, E>::value_type;
+
+		explicit paged_graph(std::string const& path, paged_graph_options const& options = {})
+		: file_{path, options} {
+			if (file_.size() < sizeof(binary_header)) {
+				fail("a file too short to hold a graph");
+			}
+			file_.read(0, &header_, sizeof(header_));
+			if (auto const* const error = detail::header_error<N, E>(header_, file_.size())) {
+				fail(error);
+			}
+			if (offset(0) != 0 or offset(header_.node_count) != header_.edge_count) {
+				fail("a truncated or corrupt file");
+			}
+		}
+
+		class iterator {
+		public:
+			using value_type = paged_graph::value_type;
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+
+			iterator() = default;
+
+			auto operator*() const -> reference {
+				return value_type{g_->node(row_), g_->node(g_->target(edge_)), g_->weight(edge_)};
+			}
+
+			auto operator++() -> iterator& {
+				++edge_;
+				g_->settle(row_, edge_);
+				return *this;
+			}
+
+			auto operator++(int) -> iterator {
+				auto old = *this;
+				++(*this);
+				return old;
+			}
+
+			auto operator--() -> iterator& {
+				--edge_;
+				while (g_->offset(row_) > edge_) {
+					--row_;
+				}
+				return *this;
+			}
+
+			auto operator--(int) -> iterator {
+				auto old = *this;
+				--(*this);
+				return old;
+			}
+
+			auto operator==(iterator const& other) const -> bool {
+				return edge_ == other.edge_;
+			}
+
+		private:
+			paged_graph const* g_ = nullptr;
+			node_id row_ = 0;
+			std::uint64_t edge_ = 0;
+
+			iterator(paged_graph const* g, node_id row, std::uint64_t edge)
+			: g_{g}
+			, row_{row}
+			, edge_{edge} {}
+
+			friend class paged_graph;
+		};
+
+		// Accessors
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return static_cast<std::size_t>(header_.node_count);
+		}
+
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return static_cast<std::size_t>(header_.edge_count);
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return node_count() == 0;
+		}
+
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return find_node(value) != no_node;
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const s = find_node(src);
+			auto const d = find_node(dst);
+			if (s == no_node or d == no_node) {
+				throw std::runtime_error("Cannot call gdwg::paged_graph<N, E>::is_connected if src or "
+				                         "dst node don't exist in the graph");
+			}
+			auto const first = lower_bound(s, d);
+			return first != offset(s + 1) and target(first) == d;
+		}
+
+		/* All node values in order; reads the whole node column */
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			auto values = std::vector<N>();
+			values.reserve(node_count());
+			for (auto id = node_id{0}; id < node_count(); ++id) {
+				values.push_back(node(id));
+			}
+			return values;
+		}
+
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			auto const s = find_node(src);
+			auto const d = find_node(dst);
+			if (s == no_node or d == no_node) {
+				throw std::runtime_error("Cannot call gdwg::paged_graph<N, E>::weights if src or dst "
+				                         "node don't exist in the graph");
+			}
+			auto weights = std::vector<E>();
+			for (auto e = lower_bound(s, d); e != offset(s + 1) and target(e) == d; ++e) {
+				weights.push_back(weight(e));
+			}
+			return weights;
+		}
+
+		// log (n) + log (out-degree) + parallel edges
+		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
+			auto const s = find_node(src);
+			auto const d = find_node(dst);
+			if (s == no_node or d == no_node) {
+				return end();
+			}
+			for (auto e = lower_bound(s, d); e != offset(s + 1) and target(e) == d; ++e) {
+				if (this->weight(e) == weight) {
+					return iterator(this, s, e);
+				}
+			}
+			return end();
+		}
+
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			auto const s = find_node(src);
+			if (s == no_node) {
+				throw std::runtime_error("Cannot call gdwg::paged_graph<N, E>::connections if src "
+				                         "doesn't exist in the graph");
+			}
+			auto dsts = std::vector<N>();
+			for (auto e = offset(s); e != offset(s + 1); ++e) {
+				dsts.push_back(node(target(e)));
+			}
+			return dsts;
+		}
+
+		// Iterator
+		[[nodiscard]] auto begin() const -> iterator {
+			auto row = node_id{0};
+			settle(row, 0);
+			return iterator(this, row, 0);
+		}
+
+		[[nodiscard]] auto end() const -> iterator {
+			return iterator(this, static_cast<node_id>(node_count()), header_.edge_count);
+		}
+
+		// I/O
+		[[nodiscard]] auto io_stats() const noexcept -> paged_io_stats const& {
+			return file_.stats();
+		}
+
+		auto reset_io_stats() const noexcept -> void {
+			file_.reset_stats();
+		}
+
+	private:
+		mutable detail::segment_cache file_;
+		binary_header header_{};
+		mutable std::string scratch_;
+
+		[[noreturn]] static auto fail(std::string const& what) -> void {
+			throw std::runtime_error("Cannot construct gdwg::paged_graph<N, E> from " + what);
+		}
+
+		[[nodiscard]] auto offset(std::uint64_t id) const -> std::uint64_t {
+			return file_.load<std::uint64_t>(header_.offsets + id * sizeof(std::uint64_t));
+		}
+
+		[[nodiscard]] auto target(std::uint64_t e) const -> node_id {
+			return file_.load<node_id>(header_.targets + e * sizeof(node_id));
+		}
+
+		/* Reads the i-th value of a column stored as an array or serialized beside an index */
+		template<typename T>
+		[[nodiscard]] auto column(std::uint64_t values, std::uint64_t index, std::uint64_t i) const -> T {
+			if constexpr (detail::stored_as_array<T>) {
+				return file_.load<T>(values + i * sizeof(T));
+			}
+			else {
+				auto const first = file_.load<std::uint64_t>(index + i * sizeof(std::uint64_t));
+				auto const last = file_.load<std::uint64_t>(index + (i + 1) * sizeof(std::uint64_t));
+				if (last < first or values + last > file_.size()) {
+					throw std::runtime_error("Cannot read a corrupt value from a gdwg::paged_graph file");
+				}
+				scratch_.resize(static_cast<std::size_t>(last - first));
+				file_.read(values + first, scratch_.data(), scratch_.size());
+				auto const* const bytes = reinterpret_cast<std::byte const*>(scratch_.data());
+				auto buffer = detail::memory_buffer(bytes, bytes + scratch_.size());
+				auto is = std::istream(&buffer);
+				return serializer<T>::read(is);
+			}
+		}
+
+		[[nodiscard]] auto node(node_id id) const -> N {
+			return column<N>(header_.nodes, header_.node_index, id);
+		}
+
+		[[nodiscard]] auto weight(std::uint64_t e) const -> E {
+			return column<E>(header_.weights, header_.weight_index, e);
+		}
+
+		/* log(n) node reads */
+		[[nodiscard]] auto find_node(N const& value) const -> node_id {
+			auto low = std::size_t{0};
+			auto high = node_count();
+			while (low < high) {
+				auto const mid = low + (high - low) / 2;
+				if (node(static_cast<node_id>(mid)) < value) {
+					low = mid + 1;
+				}
+				else {
+					high = mid;
+				}
+			}
+			return low == node_count() or value < node(static_cast<node_id>(low)) ? no_node
+			                                                                       : static_cast<node_id>(low);
+		}
+
+		/* First edge of row s whose target is not below d */
+		[[nodiscard]] auto lower_bound(node_id s, node_id d) const -> std::uint64_t {
+			auto low = offset(s);
+			auto high = offset(s + 1);
+			while (low < high) {
+				auto const mid = low + (high - low) / 2;
+				if (target(mid) < d) {
+					low = mid + 1;
+				}
+				else {
+					high = mid;
+				}
+			}
+			return low;
+		}
+
+		/* Moves row forward to the row that holds edge, skipping rows with no edges */
+		auto settle(node_id& row, std::uint64_t edge) const -> void {
+			while (row < node_count() and offset(row + 1) <= edge) {
+				++row;
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_PAGED_GRAPH_HPP
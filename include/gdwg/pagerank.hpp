@@ -0,0 +1,234 @@
+#ifndef GDWG_PAGERANK_HPP
+#define GDWG_PAGERANK_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct pagerank_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Probability of following an edge rather than teleporting
+		double damping = 0.85;
+
+		// Stop once the L1 change of an iteration drops below this
+		double tolerance = 1e-9;
+
+		std::size_t max_iterations = 100;
+
+		// Split a node's rank over its out-edges in proportion to their weights. Ignored unless E
+		// is arithmetic; otherwise, and when false, every out-edge gets an equal share.
+		bool weighted = true;
+	};
+
+	template<typename N>
+	struct pagerank_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		// Indexed by node id, sums to 1
+		std::vector<double> rank;
+
+		std::size_t iterations = 0;
+		bool converged = false;
+
+		// L1 change of each iteration, so callers can see how convergence went
+		std::vector<double> residuals;
+
+		[[nodiscard]] auto rank_of(N const& value) const -> double {
+			auto const id = detail::find_node(*nodes, value);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::pagerank_result<N>::rank_of on a node that "
+				                         "doesn't exist in the graph");
+			}
+			return rank[id];
+		}
+	};
+
+	namespace detail {
+		// Nodes per task; also the unit of the fixed-order reductions
+		inline constexpr auto pagerank_block = std::size_t{1024};
+
+		/* Power iteration pulling along in-edges, so every node writes only its own rank and no
+		 * atomics are needed. Each iteration first scales ranks by the inverse out-weight into a
+		 * contiguous array, after which a node's new rank is a plain sum (or dot product with the
+		 * in-edge weights) over it. Sums are reduced per block in block order, so results don't
+		 * depend on the pool. Rank of nodes without out-weight goes to the teleport vector. */
+		template<typename N, typename E>
+		auto pagerank(csr_graph<N, E> const& g,
+		              std::vector<double> const& teleport,
+		              pagerank_options const& options) -> pagerank_result<N> {
+			if (not g.has_in_edges()) {
+				throw std::runtime_error("Cannot call gdwg::pagerank on a csr_graph without in-edges");
+			}
+			if (not(options.damping >= 0.0 and options.damping <= 1.0)) {
+				throw std::runtime_error("Cannot call gdwg::pagerank with a damping factor outside "
+				                         "[0, 1]");
+			}
+
+			auto const n = g.node_count();
+			auto result = pagerank_result<N>{g.node_table(), teleport, 0, false, {}};
+			if (n == 0) {
+				result.converged = true;
+				return result;
+			}
+
+			auto constexpr arithmetic = std::is_arithmetic_v<E>;
+			auto const weighted = arithmetic and options.weighted;
+
+			// In-edge weights row by row, and each node's 1 / out-weight (0 if dangling)
+			auto rows = std::vector<std::size_t>(n + 1, 0);
+			auto coefficients = std::vector<double>();
+			auto inverse = std::vector<double>(n, 0.0);
+			for (auto v = node_id{0}; v < n; ++v) {
+				rows[v + 1] = rows[v] + g.in_degree(v);
+			}
+			for (auto u = node_id{0}; u < n; ++u) {
+				auto total = static_cast<double>(g.out_degree(u));
+				if constexpr (arithmetic) {
+					if (weighted) {
+						total = 0.0;
+						for (auto const w : g.weights(u)) {
+							if constexpr (std::is_signed_v<E>) {
+								if (not(w >= E{})) {
+									throw std::runtime_error("Cannot call gdwg::pagerank with negative "
+									                         "edge weights");
+								}
+							}
+							total += static_cast<double>(w);
+						}
+					}
+				}
+				inverse[u] = total > 0.0 ? 1.0 / total : 0.0;
+			}
+			if constexpr (arithmetic) {
+				if (weighted) {
+					coefficients.reserve(g.edge_count());
+					for (auto v = node_id{0}; v < n; ++v) {
+						for (auto const w : g.in_weights(v)) {
+							coefficients.push_back(static_cast<double>(w));
+						}
+					}
+				}
+			}
+
+			auto const blocks = (n + pagerank_block - 1) / pagerank_block;
+			auto share = std::vector<double>(n);
+			auto next = std::vector<double>(n);
+			auto partial = std::vector<double>(blocks);
+			auto const sum_blocks = [&] {
+				return std::accumulate(partial.begin(), partial.end(), 0.0);
+			};
+			auto const for_blocks = [&](auto const& f) {
+				detail::for_range(options.pool, 0, blocks, 1, [&](std::size_t b) {
+					f(b, b * pagerank_block, std::min(n, (b + 1) * pagerank_block));
+				});
+			};
+
+			auto& rank = result.rank;
+			while (result.iterations < options.max_iterations) {
+				// Rank each out-edge carries per unit of weight, and the rank with nowhere to go
+				for_blocks([&](std::size_t b, std::size_t first, std::size_t last) {
+					auto dangling = 0.0;
+					for (auto u = first; u < last; ++u) {
+						share[u] = rank[u] * inverse[u];
+						dangling += inverse[u] == 0.0 ? rank[u] : 0.0;
+					}
+					partial[b] = dangling;
+				});
+				auto const dangling = sum_blocks();
+
+				for_blocks([&](std::size_t b, std::size_t first, std::size_t last) {
+					auto change = 0.0;
+					for (auto v = first; v < last; ++v) {
+						auto const sources = g.sources(static_cast<node_id>(v));
+						auto const* const src = sources.data();
+						auto sum = 0.0;
+						if (weighted) {
+							auto const* const w = coefficients.data() + rows[v];
+							for (auto e = std::size_t{0}; e < sources.size(); ++e) {
+								sum += w[e] * share[src[e]];
+							}
+						}
+						else {
+							for (auto e = std::size_t{0}; e < sources.size(); ++e) {
+								sum += share[src[e]];
+							}
+						}
+						next[v] = (1.0 - options.damping + options.damping * dangling) * teleport[v]
+						          + options.damping * sum;
+						change += std::abs(next[v] - rank[v]);
+					}
+					partial[b] = change;
+				});
+				auto const residual = sum_blocks();
+
+				std::swap(rank, next);
+				++result.iterations;
+				result.residuals.push_back(residual);
+				if (residual < options.tolerance) {
+					result.converged = true;
+					break;
+				}
+			}
+			return result;
+		}
+
+		inline auto uniform_teleport(std::size_t n) -> std::vector<double> {
+			return std::vector<double>(n, n == 0 ? 0.0 : 1.0 / static_cast<double>(n));
+		}
+	} // namespace detail
+
+	/* PageRank by power iteration. Needs a snapshot with in-edges */
+	template<typename N, typename E>
+	auto pagerank(csr_graph<N, E> const& g, pagerank_options const& options = {})
+	   -> pagerank_result<N> {
+		return detail::pagerank(g, detail::uniform_teleport(g.node_count()), options);
+	}
+
+	template<typename N, typename E>
+	auto pagerank(graph<N, E> const& g, pagerank_options const& options = {})
+	   -> pagerank_result<N> {
+		return pagerank(csr_graph<N, E>(g, adjacency::in_and_out), options);
+	}
+
+	/* PageRank that teleports only to the seeds, evenly; a repeated seed gets a larger share */
+	template<typename N, typename E>
+	auto personalized_pagerank(csr_graph<N, E> const& g,
+	                           std::vector<N> const& seeds,
+	                           pagerank_options const& options = {}) -> pagerank_result<N> {
+		if (seeds.empty()) {
+			throw std::runtime_error("Cannot call gdwg::personalized_pagerank without seeds");
+		}
+
+		auto teleport = std::vector<double>(g.node_count(), 0.0);
+		for (auto const& seed : seeds) {
+			auto const id = g.find(seed);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::personalized_pagerank on a seed that "
+				                         "doesn't exist in the graph");
+			}
+			teleport[id] += 1.0 / static_cast<double>(seeds.size());
+		}
+		return detail::pagerank(g, teleport, options);
+	}
+
+	template<typename N, typename E>
+	auto personalized_pagerank(graph<N, E> const& g,
+	                           std::vector<N> const& seeds,
+	                           pagerank_options const& options = {}) -> pagerank_result<N> {
+		return personalized_pagerank(csr_graph<N, E>(g, adjacency::in_and_out), seeds, options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_PAGERANK_HPP
@@ -0,0 +1,290 @@
+#ifndef GDWG_RANDOM_WALK_HPP
+#define GDWG_RANDOM_WALK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct walker_options {
+		// nullptr builds on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Pick successors in proportion to edge weights. Ignored unless E is arithmetic;
+		// otherwise, and when false, every out-edge is equally likely.
+		bool weighted = true;
+	};
+
+	struct walk_options {
+		// nullptr walks on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Nodes per walk, start included. Walks stop early at nodes without out-edges.
+		std::size_t length = 80;
+
+		std::size_t walks_per_node = 10;
+
+		// node2vec return and in-out parameters; 1 and 1 is a plain first-order walk
+		double p = 1.0;
+		double q = 1.0;
+
+		std::uint64_t seed = 0;
+
+		// Walks generated before the sink sees any of them, which bounds memory use
+		std::size_t batch = 1U << 14U;
+	};
+
+	namespace detail {
+		/* SplitMix64: tiny state, so every walk can have its own generator seeded from its index */
+		class walk_rng {
+		public:
+			explicit walk_rng(std::uint64_t seed) noexcept
+			: state_{seed} {}
+
+			auto next() noexcept -> std::uint64_t {
+				auto z = (state_ += 0x9e3779b97f4a7c15ULL);
+				z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+				z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+				return z ^ (z >> 31U);
+			}
+
+			/* Uniform in [0, bound): multiply-shift for the usual degrees, bias below 2^-32 */
+			auto below(std::size_t bound) noexcept -> std::size_t {
+				if (bound <= 0xffffffffU) {
+					return static_cast<std::size_t>(((next() >> 32U) * bound) >> 32U);
+				}
+				return static_cast<std::size_t>(next() % bound);
+			}
+
+			/* Uniform in [0, 1) */
+			auto unit() noexcept -> double {
+				return static_cast<double>(next() >> 11U) * 0x1.0p-53;
+			}
+
+		private:
+			std::uint64_t state_;
+		};
+
+		inline auto walk_seed(std::uint64_t seed, std::uint64_t walk) noexcept -> std::uint64_t {
+			auto mix = walk_rng(seed ^ (walk * 0xd1b54a32d192ed03ULL));
+			return mix.next();
+		}
+	} // namespace detail
+
+	/* Random walks over a snapshot. Weighted successors come from per-node alias tables built in
+	 * O(E) with Vose's method, so each step costs two random numbers whatever the degree.
+	 * node2vec bias is applied by rejection: a candidate drawn from the first-order table is kept
+	 * with probability proportional to 1/p when it returns to the previous node, 1 when it stays
+	 * next to it and 1/q otherwise, which needs one binary search of the previous node's
+	 * targets instead of a second-order table per edge.
+	 *
+	 * Every walk seeds its own generator from the seed and its index, so output is the same for
+	 * any pool and any batch size. */
+	template<typename N, typename E>
+	class random_walker {
+	public:
+		explicit random_walker(graph<N, E> const& g, walker_options const& options = {})
+		: random_walker(csr_graph<N, E>(g), options) {}
+
+		explicit random_walker(csr_graph<N, E> g, walker_options const& options = {})
+		: graph_{std::move(g)} {
+			if constexpr (std::is_arithmetic_v<E>) {
+				if (options.weighted) {
+					build_alias_tables(options.pool);
+				}
+			}
+		}
+
+		[[nodiscard]] auto snapshot() const noexcept -> csr_graph<N, E> const& {
+			return graph_;
+		}
+
+		/* One walk, the index-th from start; walks with equal seed and index are equal */
+		[[nodiscard]] auto
+		walk(N const& start, walk_options const& options = {}, std::uint64_t index = 0) const
+		   -> std::vector<N> {
+			auto const id = graph_.find(start);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::random_walker<N, E>::walk on a node that "
+				                         "doesn't exist in the graph");
+			}
+			check(options);
+
+			auto ids = std::vector<node_id>(options.length);
+			ids.resize(walk(id, options, index, ids.data()));
+			auto nodes = std::vector<N>();
+			nodes.reserve(ids.size());
+			for (auto const v : ids) {
+				nodes.push_back(graph_.node(v));
+			}
+			return nodes;
+		}
+
+		/* walks_per_node walks from every node, round by round in node order. Calls
+		 * sink(std::span<node_id const>) for each walk on the calling thread and in that order,
+		 * one batch at a time. Returns the number of walks. */
+		template<typename Sink>
+		auto generate(walk_options const& options, Sink&& sink) const -> std::size_t {
+			check(options);
+			auto const n = graph_.node_count();
+			auto const total = n * options.walks_per_node;
+			auto const batch = std::max(options.batch, std::size_t{1});
+			auto const grain =
+			   std::max(std::size_t{64}, std::size_t{4096} / std::max(options.length, std::size_t{1}));
+
+			auto buffer = std::vector<node_id>(std::min(batch, total) * options.length);
+			auto lengths = std::vector<std::size_t>(std::min(batch, total));
+			for (auto first = std::size_t{0}; first < total; first += batch) {
+				auto const count = std::min(batch, total - first);
+				detail::for_range(options.pool, 0, count, grain, [&](std::size_t i) {
+					auto const index = first + i;
+					lengths[i] = walk(static_cast<node_id>(index % n),
+					                  options,
+					                  index,
+					                  buffer.data() + i * options.length);
+				});
+				for (auto i = std::size_t{0}; i < count; ++i) {
+					sink(std::span<node_id const>(buffer.data() + i * options.length, lengths[i]));
+				}
+			}
+			return total;
+		}
+
+	private:
+		csr_graph<N, E> graph_;
+
+		// Per out-edge, in edge order: chance of keeping the drawn slot, and the edge to take instead
+		std::vector<double> probability_;
+		std::vector<std::size_t> alias_;
+
+		// Per node when weighted: every out-edge has weight zero, so the walk stops there
+		std::vector<std::uint8_t> stuck_;
+
+		static auto check(walk_options const& options) -> void {
+			if (not(options.p > 0.0 and options.q > 0.0)) {
+				throw std::runtime_error("Cannot generate gdwg::random_walker<N, E> walks with "
+				                         "non-positive p or q");
+			}
+		}
+
+		auto build_alias_tables(thread_pool* pool) -> void {
+			auto const offsets = graph_.offsets();
+			auto const weights = graph_.weights();
+			for (auto const w : weights) {
+				if (not(w >= E{})) {
+					throw std::runtime_error("Cannot build gdwg::random_walker<N, E> with negative edge "
+					                         "weights");
+				}
+			}
+
+			probability_.assign(graph_.edge_count(), 1.0);
+			alias_.resize(graph_.edge_count());
+			stuck_.assign(graph_.node_count(), 0);
+			detail::for_range(pool, 0, graph_.node_count(), 256, [&](std::size_t u) {
+				thread_local auto small = std::vector<std::size_t>();
+				thread_local auto large = std::vector<std::size_t>();
+				auto const first = offsets[u];
+				auto const last = offsets[u + 1];
+				auto total = 0.0;
+				for (auto e = first; e < last; ++e) {
+					alias_[e] = e;
+					total += static_cast<double>(weights[e]);
+				}
+				if (total == 0.0) {
+					stuck_[u] = 1;
+					return;
+				}
+
+				small.clear();
+				large.clear();
+				auto const scale = static_cast<double>(last - first) / total;
+				for (auto e = first; e < last; ++e) {
+					probability_[e] = static_cast<double>(weights[e]) * scale;
+					(probability_[e] < 1.0 ? small : large).push_back(e);
+				}
+				while (not small.empty() and not large.empty()) {
+					auto const s = small.back();
+					auto const l = large.back();
+					small.pop_back();
+					alias_[s] = l;
+					probability_[l] -= 1.0 - probability_[s];
+					if (probability_[l] < 1.0) {
+						large.pop_back();
+						small.push_back(l);
+					}
+				}
+				// Whatever is left is 1 up to rounding
+				for (auto const e : small) {
+					probability_[e] = 1.0;
+				}
+				for (auto const e : large) {
+					probability_[e] = 1.0;
+				}
+			});
+		}
+
+		/* Edge index of a successor of u, or no edge when u is a dead end */
+		auto step(node_id u, detail::walk_rng& rng) const -> std::size_t {
+			auto const first = graph_.offsets()[u];
+			auto const degree = graph_.offsets()[u + 1] - first;
+			auto const e = first + rng.below(degree);
+			if (probability_.empty()) {
+				return e;
+			}
+			return rng.unit() < probability_[e] ? e : alias_[e];
+		}
+
+		[[nodiscard]] auto dead_end(node_id u) const -> bool {
+			return graph_.out_degree(u) == 0 or (not stuck_.empty() and stuck_[u] != 0);
+		}
+
+		/* Writes up to options.length ids to out and returns how many */
+		auto walk(node_id start, walk_options const& options, std::uint64_t index, node_id* out) const
+		   -> std::size_t {
+			if (options.length == 0) {
+				return 0;
+			}
+
+			auto rng = detail::walk_rng(detail::walk_seed(options.seed, index));
+			auto const biased = options.p != 1.0 or options.q != 1.0;
+			auto const bias_max = std::max({1.0 / options.p, 1.0, 1.0 / options.q});
+			auto const targets = graph_.targets();
+
+			out[0] = start;
+			auto size = std::size_t{1};
+			while (size < options.length and not dead_end(out[size - 1])) {
+				auto const u = out[size - 1];
+				auto next = targets[step(u, rng)];
+				if (biased and size > 1) {
+					auto const previous = out[size - 2];
+					while (rng.unit() * bias_max >= bias(previous, next, options)) {
+						next = targets[step(u, rng)];
+					}
+				}
+				out[size++] = next;
+			}
+			return size;
+		}
+
+		/* Unnormalised node2vec weight of moving to next after previous */
+		[[nodiscard]] auto bias(node_id previous, node_id next, walk_options const& options) const
+		   -> double {
+			if (next == previous) {
+				return 1.0 / options.p;
+			}
+			auto const targets = graph_.targets(previous);
+			return std::binary_search(targets.begin(), targets.end(), next) ? 1.0 : 1.0 / options.q;
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_RANDOM_WALK_HPP
@@ -0,0 +1,461 @@
+#ifndef GDWG_REACHABILITY_HPP
+#define GDWG_REACHABILITY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "gdwg/bitmap.hpp"
+#include "gdwg/components.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	struct reachability_options {
+		// nullptr builds on the calling thread
+		thread_pool* pool = nullptr;
+
+		// Upper bound on the bytes spent on landmark bitsets
+		std::size_t label_budget = std::size_t{64} << 20U;
+
+		// Number of interval labels per component
+		std::size_t intervals = 2;
+	};
+
+	namespace detail {
+		/* Any word where both bitsets are set. Bitsets are a few words long, so AVX2 handles four
+		 * words at a time and the rest is a plain loop the compiler can vectorize. */
+		inline auto bits_intersect(std::uint64_t const* lhs, std::uint64_t const* rhs, std::size_t words)
+		   -> bool {
+			auto w = std::size_t{0};
+#if defined(__AVX2__)
+			for (; w + 4 <= words; w += 4) {
+				auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(lhs + w));
+				auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(rhs + w));
+				if (_mm256_testz_si256(a, b) == 0) {
+					return true;
+				}
+			}
+#endif
+			auto any = std::uint64_t{0};
+			for (; w < words; ++w) {
+				any |= lhs[w] & rhs[w];
+			}
+			return any != 0;
+		}
+
+		/* Every bit of subset is also in superset */
+		inline auto bits_subset(std::uint64_t const* subset, std::uint64_t const* superset, std::size_t words)
+		   -> bool {
+			auto w = std::size_t{0};
+#if defined(__AVX2__)
+			for (; w + 4 <= words; w += 4) {
+				auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(subset + w));
+				auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(superset + w));
+				if (_mm256_testc_si256(b, a) == 0) {
+					return false;
+				}
+			}
+#endif
+			auto missing = std::uint64_t{0};
+			for (; w < words; ++w) {
+				missing |= subset[w] & ~superset[w];
+			}
+			return missing == 0;
+		}
+	} // namespace detail
+
+	/* Answers "is there a path from src to dst" without searching the graph in the common case.
+	 *
+	 * Strongly connected components are collapsed first, so the labels live on the condensation
+	 * DAG. Each component gets its topological position, a few interval labels from randomised
+	 * post-order traversals (GRAIL), and two bitsets over a set of landmark components with the
+	 * highest degrees: which landmarks it reaches and which reach it. A shared landmark proves
+	 * reachability; a topological position, interval or landmark that's out of place disproves
+	 * it. Only queries neither settles fall back to a search that is pruned by the same labels.
+	 * When the budget covers a landmark bit for every component, every answer is a bit test.
+	 *
+	 * Queries are const and safe to run from many threads at once. */
+	template<typename N>
+	class reachability_index {
+	public:
+		template<typename E>
+		explicit reachability_index(graph<N, E> const& g, reachability_options const& options = {})
+		: reachability_index(csr_graph<N, E>(g, options.pool == nullptr ? adjacency::out : adjacency::in_and_out),
+		                     options) {}
+
+		template<typename E>
+		explicit reachability_index(csr_graph<N, E> const& g, reachability_options const& options = {}) {
+			auto const components = strongly_connected_components(g, {.pool = options.pool});
+			nodes_ = components.nodes;
+			component_.assign(components.component.begin(), components.component.end());
+			count_ = components.count;
+
+			build_dag(g);
+			build_order();
+			build_landmarks(options);
+			build_intervals(options);
+		}
+
+		[[nodiscard]] auto is_reachable(N const& src, N const& dst) const -> bool {
+			auto const s = detail::find_node(*nodes_, src);
+			auto const d = detail::find_node(*nodes_, dst);
+			if (s == no_node or d == no_node) {
+				throw std::runtime_error("Cannot call gdwg::reachability_index<N>::is_reachable if src "
+				                         "or dst node don't exist in the graph");
+			}
+			return is_reachable(s, d);
+		}
+
+		[[nodiscard]] auto is_reachable(node_id src, node_id dst) const -> bool {
+			auto const s = component_[src];
+			auto const d = component_[dst];
+			if (s == d) {
+				return true;
+			}
+
+			switch (check(s, d)) {
+			case verdict::yes: return true;
+			case verdict::no: return false;
+			case verdict::unknown: break;
+			}
+			return search(s, d);
+		}
+
+		// Accessors
+		[[nodiscard]] auto component_count() const noexcept -> std::size_t {
+			return count_;
+		}
+
+		[[nodiscard]] auto landmark_count() const noexcept -> std::size_t {
+			return landmarks_;
+		}
+
+		/* Whether every component is a landmark, so no query ever searches */
+		[[nodiscard]] auto exact() const noexcept -> bool {
+			return landmarks_ == count_;
+		}
+
+		/* Bytes held by the index, labels and condensation included */
+		[[nodiscard]] auto memory_bytes() const noexcept -> std::size_t {
+			return component_.capacity() * sizeof(std::uint32_t) + offsets_.capacity() * sizeof(std::size_t)
+			       + targets_.capacity() * sizeof(std::uint32_t) + position_.capacity() * sizeof(std::uint32_t)
+			       + slot_.capacity() * sizeof(std::uint32_t) + out_.capacity() * sizeof(std::uint64_t)
+			       + in_.capacity() * sizeof(std::uint64_t) + low_.capacity() * sizeof(std::uint32_t)
+			       + post_.capacity() * sizeof(std::uint32_t);
+		}
+
+	private:
+		static constexpr auto no_slot = std::numeric_limits<std::uint32_t>::max();
+
+		enum class verdict { yes, no, unknown };
+
+		std::shared_ptr<std::vector<N> const> nodes_;
+		std::vector<std::uint32_t> component_;
+		std::size_t count_ = 0;
+
+		// Condensation DAG as CSR over component ids, without duplicate edges
+		std::vector<std::size_t> offsets_;
+		std::vector<std::uint32_t> targets_;
+
+		// Position of each component in a topological order
+		std::vector<std::uint32_t> position_;
+
+		// Landmark bit of each component, or no_slot; words_ words per bitset
+		std::vector<std::uint32_t> slot_;
+		std::size_t landmarks_ = 0;
+		std::size_t words_ = 0;
+		std::vector<std::uint64_t> out_;
+		std::vector<std::uint64_t> in_;
+
+		// intervals_ interval labels per component: [low, post] of a post-order traversal
+		std::size_t intervals_ = 0;
+		std::vector<std::uint32_t> low_;
+		std::vector<std::uint32_t> post_;
+
+		[[nodiscard]] auto successors(std::uint32_t c) const -> std::span<std::uint32_t const> {
+			return std::span<std::uint32_t const>(targets_).subspan(offsets_[c], offsets_[c + 1] - offsets_[c]);
+		}
+
+		[[nodiscard]] auto out_bits(std::uint32_t c) const -> std::uint64_t const* {
+			return out_.data() + c * words_;
+		}
+
+		[[nodiscard]] auto in_bits(std::uint32_t c) const -> std::uint64_t const* {
+			return in_.data() + c * words_;
+		}
+
+		static auto test(std::uint64_t const* bits, std::uint32_t slot) -> bool {
+			return ((bits[slot / 64] >> (slot % 64)) & 1U) != 0;
+		}
+
+		/* What the labels alone say about s reaching d, s != d */
+		[[nodiscard]] auto check(std::uint32_t s, std::uint32_t d) const -> verdict {
+			if (position_[s] > position_[d]) {
+				return verdict::no;
+			}
+			if (slot_[d] != no_slot) {
+				return test(out_bits(s), slot_[d]) ? verdict::yes : verdict::no;
+			}
+			if (slot_[s] != no_slot) {
+				return test(in_bits(d), slot_[s]) ? verdict::yes : verdict::no;
+			}
+			if (detail::bits_intersect(out_bits(s), in_bits(d), words_)) {
+				return verdict::yes;
+			}
+
+			// Whatever reaches s reaches d, and whatever d reaches s reaches
+			if (not detail::bits_subset(in_bits(s), in_bits(d), words_)
+			    or not detail::bits_subset(out_bits(d), out_bits(s), words_))
+			{
+				return verdict::no;
+			}
+			for (auto i = std::size_t{0}; i < intervals_; ++i) {
+				auto const k = i * count_;
+				if (low_[k + d] < low_[k + s] or post_[k + s] < post_[k + d]) {
+					return verdict::no;
+				}
+			}
+			return verdict::unknown;
+		}
+
+		/* Depth-first search over the DAG that skips every component the labels rule out. Visited
+		 * components are a bit each, allocated per query, so nothing sized to the graph outlives it. */
+		[[nodiscard]] auto search(std::uint32_t s, std::uint32_t d) const -> bool {
+			auto visited = bitmap(count_);
+			visited.set(s);
+			auto stack = std::vector<std::uint32_t>{s};
+			while (not stack.empty()) {
+				auto const c = stack.back();
+				stack.pop_back();
+				for (auto const next : successors(c)) {
+					if (next == d) {
+						return true;
+					}
+					if (visited.test(next)) {
+						continue;
+					}
+					visited.set(next);
+
+					switch (check(next, d)) {
+					case verdict::yes: return true;
+					case verdict::no: break;
+					case verdict::unknown: stack.push_back(next); break;
+					}
+				}
+			}
+			return false;
+		}
+
+		template<typename E>
+		auto build_dag(csr_graph<N, E> const& g) -> void {
+			auto lists = std::vector<std::vector<std::uint32_t>>(count_);
+			for (auto u = node_id{0}; u < g.node_count(); ++u) {
+				for (auto const v : g.targets(u)) {
+					if (component_[u] != component_[v]) {
+						lists[component_[u]].push_back(component_[v]);
+					}
+				}
+			}
+
+			offsets_.assign(count_ + 1, 0);
+			for (auto c = std::size_t{0}; c < count_; ++c) {
+				auto& list = lists[c];
+				std::sort(list.begin(), list.end());
+				list.erase(std::unique(list.begin(), list.end()), list.end());
+				offsets_[c + 1] = offsets_[c] + list.size();
+			}
+			targets_.reserve(offsets_.back());
+			for (auto const& list : lists) {
+				targets_.insert(targets_.end(), list.begin(), list.end());
+			}
+		}
+
+		/* Topological positions by Kahn's algorithm */
+		auto build_order() -> void {
+			auto indegree = std::vector<std::uint32_t>(count_, 0);
+			for (auto const t : targets_) {
+				++indegree[t];
+			}
+
+			auto order = std::vector<std::uint32_t>();
+			order.reserve(count_);
+			for (auto c = std::uint32_t{0}; c < count_; ++c) {
+				if (indegree[c] == 0) {
+					order.push_back(c);
+				}
+			}
+			for (auto i = std::size_t{0}; i < order.size(); ++i) {
+				for (auto const next : successors(order[i])) {
+					if (--indegree[next] == 0) {
+						order.push_back(next);
+					}
+				}
+			}
+
+			position_.resize(count_);
+			for (auto i = std::size_t{0}; i < count_; ++i) {
+				position_[order[i]] = static_cast<std::uint32_t>(i);
+			}
+		}
+
+		/* Landmarks are the components with the largest (in + 1) * (out + 1), as many as the budget
+		 * allows. Out-bitsets are filled from sinks up and in-bitsets from sources down, one depth
+		 * level at a time so each level runs in parallel. */
+		auto build_landmarks(reachability_options const& options) -> void {
+			auto const max_words = (count_ + 63) / 64;
+			words_ = count_ == 0 ? 0 : std::min(max_words, options.label_budget / (2 * sizeof(std::uint64_t) * count_));
+			landmarks_ = std::min(count_, words_ * 64);
+
+			auto indegree = std::vector<std::size_t>(count_, 0);
+			for (auto const t : targets_) {
+				++indegree[t];
+			}
+			auto by_degree = std::vector<std::uint32_t>(count_);
+			std::iota(by_degree.begin(), by_degree.end(), 0U);
+			auto const score = [&](std::uint32_t c) {
+				return (indegree[c] + 1) * (successors(c).size() + 1);
+			};
+			std::partial_sort(by_degree.begin(),
+			                  by_degree.begin() + static_cast<std::ptrdiff_t>(landmarks_),
+			                  by_degree.end(),
+			                  [&](std::uint32_t a, std::uint32_t b) { return score(a) > score(b); });
+
+			slot_.assign(count_, no_slot);
+			out_.assign(count_ * words_, 0);
+			in_.assign(count_ * words_, 0);
+			for (auto i = std::size_t{0}; i < landmarks_; ++i) {
+				auto const c = by_degree[i];
+				slot_[c] = static_cast<std::uint32_t>(i);
+				out_[c * words_ + i / 64] |= std::uint64_t{1} << (i % 64);
+				in_[c * words_ + i / 64] |= std::uint64_t{1} << (i % 64);
+			}
+			if (words_ == 0) {
+				return;
+			}
+
+			// Depth of each component: longest path from a source, in topological order
+			auto order = std::vector<std::uint32_t>(count_);
+			for (auto c = std::uint32_t{0}; c < count_; ++c) {
+				order[position_[c]] = c;
+			}
+			auto depth = std::vector<std::uint32_t>(count_, 0);
+			auto levels = std::size_t{1};
+			for (auto const c : order) {
+				for (auto const next : successors(c)) {
+					depth[next] = std::max(depth[next], depth[c] + 1);
+				}
+				levels = std::max(levels, std::size_t{depth[c]} + 1);
+			}
+			auto level_offsets = std::vector<std::size_t>(levels + 1, 0);
+			for (auto const d : depth) {
+				++level_offsets[d + 1];
+			}
+			std::partial_sum(level_offsets.begin(), level_offsets.end(), level_offsets.begin());
+			auto by_level = std::vector<std::uint32_t>(count_);
+			auto fill = std::vector<std::size_t>(level_offsets.begin(), level_offsets.end() - 1);
+			for (auto c = std::uint32_t{0}; c < count_; ++c) {
+				by_level[fill[depth[c]]++] = c;
+			}
+
+			// Successors sit at greater depths, predecessors at smaller ones
+			for (auto l = levels; l-- > 0;) {
+				detail::for_range(options.pool, level_offsets[l], level_offsets[l + 1], 64, [&](std::size_t i) {
+					auto const c = by_level[i];
+					auto* const bits = out_.data() + c * words_;
+					for (auto const next : successors(c)) {
+						auto const* const from = out_bits(next);
+						for (auto w = std::size_t{0}; w < words_; ++w) {
+							bits[w] |= from[w];
+						}
+					}
+				});
+			}
+			for (auto l = std::size_t{0}; l < levels; ++l) {
+				// Components of one level can share a successor, so the push is atomic
+				detail::for_range(options.pool, level_offsets[l], level_offsets[l + 1], 64, [&](std::size_t i) {
+					auto const c = by_level[i];
+					auto const* const from = in_bits(c);
+					for (auto const next : successors(c)) {
+						auto* const bits = in_.data() + next * words_;
+						for (auto w = std::size_t{0}; w < words_; ++w) {
+							std::atomic_ref<std::uint64_t>(bits[w]).fetch_or(from[w], std::memory_order_relaxed);
+						}
+					}
+				});
+			}
+		}
+
+		/* Post-order ranks of intervals_ traversals, each visiting children in a different order */
+		auto build_intervals(reachability_options const& options) -> void {
+			intervals_ = options.intervals;
+			low_.assign(intervals_ * count_, 0);
+			post_.assign(intervals_ * count_, 0);
+
+			detail::for_range(options.pool, 0, intervals_, 1, [&](std::size_t k) {
+				auto* const low = low_.data() + k * count_;
+				auto* const post = post_.data() + k * count_;
+				auto visited = std::vector<bool>(count_, false);
+				auto rank = std::uint32_t{0};
+				auto calls = std::vector<std::pair<std::uint32_t, std::size_t>>();
+
+				// Traversal k starts children at a rotation that depends on k and the component
+				auto const child = [&](std::uint32_t c, std::size_t i) {
+					auto const next = successors(c);
+					return next[(i + k * (c + 1)) % next.size()];
+				};
+
+				for (auto r = std::size_t{0}; r < count_; ++r) {
+					auto const root = static_cast<std::uint32_t>(k % 2 == 0 ? r : count_ - 1 - r);
+					if (visited[root]) {
+						continue;
+					}
+					visited[root] = true;
+					low[root] = std::numeric_limits<std::uint32_t>::max();
+					calls.emplace_back(root, 0);
+
+					while (not calls.empty()) {
+						auto& [c, i] = calls.back();
+						if (i < successors(c).size()) {
+							auto const next = child(c, i++);
+							if (not visited[next]) {
+								visited[next] = true;
+								low[next] = std::numeric_limits<std::uint32_t>::max();
+								calls.emplace_back(next, 0);
+							}
+							else {
+								low[c] = std::min(low[c], low[next]);
+							}
+							continue;
+						}
+
+						auto const done = c;
+						post[done] = rank++;
+						low[done] = std::min(low[done], post[done]);
+						calls.pop_back();
+						if (not calls.empty()) {
+							auto const parent = calls.back().first;
+							low[parent] = std::min(low[parent], low[done]);
+						}
+					}
+				}
+			});
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_REACHABILITY_HPP
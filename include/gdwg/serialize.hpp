@@ -0,0 +1,116 @@
+#ifndef GDWG_SERIALIZE_HPP
+#define GDWG_SERIALIZE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	/* Binary serialisation hook for node and weight types. Trivially copyable types, strings and
+	 * pairs work out of the box; specialise this for anything else:
+	 *
+	 *   template<>
+	 *   struct gdwg::serializer<my_type> {
+	 *       static auto write(std::ostream& os, my_type const& value) -> void;
+	 *       static auto read(std::istream& is) -> my_type;
+	 *   };
+	 *
+	 * Values are written in host byte order. */
+	template<typename T>
+	struct serializer;
+
+	template<typename T>
+	requires std::is_trivially_copyable_v<T>
+	struct serializer<T> {
+		static auto write(std::ostream& os, T const& value) -> void {
+			os.write(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+
+		static auto read(std::istream& is) -> T {
+			auto value = T{};
+			is.read(reinterpret_cast<char*>(&value), sizeof(T));
+			return value;
+		}
+	};
+
+	namespace detail {
+		// Values are read a block at a time after a length prefix, so a forged length can't
+		// allocate more than the stream actually holds
+		inline constexpr auto read_block_bytes = std::size_t{1} << 16U;
+
+		/* Appends a length-prefixed run of trivially copyable values to values, stopping early if
+		 * the stream fails */
+		template<typename Container>
+		auto read_prefixed(std::istream& is, Container& values) -> void {
+			using value_type = typename Container::value_type;
+			auto const count = serializer<std::uint64_t>::read(is);
+			auto const block = std::max(read_block_bytes / sizeof(value_type), std::size_t{1});
+			for (auto done = std::uint64_t{0}; done < count and is;) {
+				auto const size = static_cast<std::size_t>(std::min<std::uint64_t>(count - done, block));
+				auto const at = values.size();
+				values.resize(at + size);
+				is.read(reinterpret_cast<char*>(values.data() + at),
+				        static_cast<std::streamsize>(size * sizeof(value_type)));
+				done += size;
+			}
+		}
+	} // namespace detail
+
+	template<typename Char, typename Traits, typename Alloc>
+	struct serializer<std::basic_string<Char, Traits, Alloc>> {
+		static auto write(std::ostream& os, std::basic_string<Char, Traits, Alloc> const& value)
+		   -> void {
+			serializer<std::uint64_t>::write(os, value.size());
+			os.write(reinterpret_cast<char const*>(value.data()),
+			         static_cast<std::streamsize>(value.size() * sizeof(Char)));
+		}
+
+		static auto read(std::istream& is) -> std::basic_string<Char, Traits, Alloc> {
+			auto value = std::basic_string<Char, Traits, Alloc>();
+			detail::read_prefixed(is, value);
+			return value;
+		}
+	};
+
+	template<typename First, typename Second>
+	requires(not std::is_trivially_copyable_v<std::pair<First, Second>>)
+	struct serializer<std::pair<First, Second>> {
+		static auto write(std::ostream& os, std::pair<First, Second> const& value) -> void {
+			serializer<First>::write(os, value.first);
+			serializer<Second>::write(os, value.second);
+		}
+
+		static auto read(std::istream& is) -> std::pair<First, Second> {
+			auto first = serializer<First>::read(is);
+			return {std::move(first), serializer<Second>::read(is)};
+		}
+	};
+
+	namespace detail {
+		/* Length-prefixed vector of trivially copyable values, written in one block */
+		template<typename T>
+		requires std::is_trivially_copyable_v<T>
+		auto write_array(std::ostream& os, std::vector<T> const& values) -> void {
+			serializer<std::uint64_t>::write(os, values.size());
+			os.write(reinterpret_cast<char const*>(values.data()),
+			         static_cast<std::streamsize>(values.size() * sizeof(T)));
+		}
+
+		template<typename T>
+		requires std::is_trivially_copyable_v<T>
+		auto read_array(std::istream& is) -> std::vector<T> {
+			auto values = std::vector<T>();
+			read_prefixed(is, values);
+			return values;
+		}
+	} // namespace detail
+} // namespace gdwg
+
+#endif // GDWG_SERIALIZE_HPP
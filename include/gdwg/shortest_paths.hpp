@@ -0,0 +1,421 @@
+#ifndef GDWG_SHORTEST_PATHS_HPP
+#define GDWG_SHORTEST_PATHS_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/heap.hpp"
+
+namespace gdwg {
+	/* Weights that can be summed along a path and compared, with E{} as the empty path */
+	template<typename E>
+	concept path_weight = std::totally_ordered<E> and std::default_initializable<E> and requires(E a, E b) {
+		{ a + b } -> std::convertible_to<E>;
+	};
+
+	enum class heap_kind { binary, d_ary, radix };
+
+	struct dijkstra_options {
+		heap_kind heap = heap_kind::binary;
+
+		// Children per node for heap_kind::d_ary
+		std::size_t arity = 4;
+	};
+
+	template<typename N, typename E>
+	struct weighted_path {
+		std::vector<N> nodes;
+		E weight;
+
+		// Nodes settled by the search that found this path
+		std::size_t settled = 0;
+	};
+
+	template<typename N, typename E>
+	struct shortest_paths_result {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		// Indexed by node id, empty for unreachable nodes
+		std::vector<std::optional<E>> distance;
+
+		// Shortest-path tree parent, no_node for the source and unreachable nodes
+		std::vector<node_id> parent;
+
+		std::size_t settled = 0;
+
+		[[nodiscard]] auto distance_to(N const& dst) const -> std::optional<E> {
+			return distance[id_of(dst)];
+		}
+
+		[[nodiscard]] auto path_to(N const& dst) const -> std::optional<weighted_path<N, E>> {
+			return path_to(id_of(dst));
+		}
+
+		[[nodiscard]] auto path_to(node_id dst) const -> std::optional<weighted_path<N, E>> {
+			if (not distance[dst]) {
+				return std::nullopt;
+			}
+
+			auto path = weighted_path<N, E>{{}, *distance[dst], settled};
+			for (auto id = dst; id != no_node; id = parent[id]) {
+				path.nodes.push_back((*nodes)[id]);
+			}
+			std::reverse(path.nodes.begin(), path.nodes.end());
+			return path;
+		}
+
+	private:
+		[[nodiscard]] auto id_of(N const& value) const -> node_id {
+			auto const id = detail::find_node(*nodes, value);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::shortest_paths_result<N, E>::distance_to or "
+				                         "path_to on a node that doesn't exist in the graph");
+			}
+			return id;
+		}
+	};
+
+	namespace detail {
+		/* Lazy-deletion Dijkstra: a node is settled the first time it is popped and later pops of
+		 * it are stale. Out-edges are sorted by destination then weight, so only the first edge of
+		 * each parallel run (the lightest) is relaxed. Stops once target is settled. */
+		template<typename N, typename E, typename Heap>
+		auto dijkstra(csr_graph<N, E> const& g, node_id source, node_id target, Heap heap)
+		   -> shortest_paths_result<N, E> {
+			auto const n = g.node_count();
+			auto result = shortest_paths_result<N, E>{g.node_table(),
+			                                          std::vector<std::optional<E>>(n),
+			                                          std::vector<node_id>(n, no_node)};
+			auto done = std::vector<bool>(n, false);
+
+			result.distance[source] = E{};
+			heap.push(E{}, source);
+			while (not heap.empty()) {
+				auto const [d, u] = heap.pop();
+				if (done[u]) {
+					continue;
+				}
+				done[u] = true;
+				++result.settled;
+				if (u == target) {
+					break;
+				}
+
+				auto const targets = g.targets(u);
+				auto const weights = g.weights(u);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					// Checked before the skips: a negative edge into a settled node makes its
+					// distance wrong too
+					if (weights[i] < E{}) {
+						throw std::runtime_error("Cannot call gdwg::shortest_paths on a graph with "
+						                         "negative weights");
+					}
+
+					auto const v = targets[i];
+					if ((i > 0 and targets[i - 1] == v) or done[v]) {
+						continue;
+					}
+
+					auto const candidate = static_cast<E>(d + weights[i]);
+					if (not result.distance[v] or candidate < *result.distance[v]) {
+						result.distance[v] = candidate;
+						result.parent[v] = u;
+						heap.push(candidate, v);
+					}
+				}
+			}
+
+			return result;
+		}
+
+		template<typename N, typename E>
+		auto dijkstra(csr_graph<N, E> const& g,
+		              node_id source,
+		              node_id target,
+		              dijkstra_options const& options) -> shortest_paths_result<N, E> {
+			switch (options.heap) {
+			case heap_kind::binary: return dijkstra(g, source, target, dary_heap<E, node_id>(2));
+			case heap_kind::d_ary: return dijkstra(g, source, target, dary_heap<E, node_id>(options.arity));
+			case heap_kind::radix:
+				if constexpr (std::is_integral_v<E>) {
+					return dijkstra(g, source, target, radix_heap<E, node_id>());
+				}
+				else {
+					throw std::runtime_error("Cannot call gdwg::shortest_paths with a radix heap on "
+					                         "non-integral weights");
+				}
+			}
+			return {};
+		}
+
+		/* Unreached distance for arithmetic weights */
+		template<typename E>
+		constexpr auto infinite_distance() -> E {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return std::numeric_limits<E>::infinity();
+			}
+			else {
+				return std::numeric_limits<E>::max();
+			}
+		}
+
+		template<typename N, typename E>
+		auto source_id(csr_graph<N, E> const& g, N const& src) -> node_id {
+			auto const id = g.find(src);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::shortest_paths or gdwg::shortest_path if "
+				                         "src or dst doesn't exist in the graph");
+			}
+			return id;
+		}
+	} // namespace detail
+
+	/* Single-source shortest paths over non-negative weights. Parallel edges count with their
+	 * minimum weight. */
+	template<typename N, path_weight E>
+	auto shortest_paths(csr_graph<N, E> const& g, N const& src, dijkstra_options const& options = {})
+	   -> shortest_paths_result<N, E> {
+		return detail::dijkstra(g, detail::source_id(g, src), no_node, options);
+	}
+
+	template<typename N, path_weight E>
+	auto shortest_paths(graph<N, E> const& g, N const& src, dijkstra_options const& options = {})
+	   -> shortest_paths_result<N, E> {
+		return shortest_paths(csr_graph<N, E>(g), src, options);
+	}
+
+	/* Point-to-point query; the search stops as soon as dst is settled */
+	template<typename N, path_weight E>
+	auto shortest_path(csr_graph<N, E> const& g,
+	                   N const& src,
+	                   N const& dst,
+	                   dijkstra_options const& options = {}) -> std::optional<weighted_path<N, E>> {
+		auto const source = detail::source_id(g, src);
+		auto const target = detail::source_id(g, dst);
+		return detail::dijkstra(g, source, target, options).path_to(target);
+	}
+
+	template<typename N, path_weight E>
+	auto shortest_path(graph<N, E> const& g,
+	                   N const& src,
+	                   N const& dst,
+	                   dijkstra_options const& options = {}) -> std::optional<weighted_path<N, E>> {
+		return shortest_path(csr_graph<N, E>(g), src, dst, options);
+	}
+
+	namespace detail {
+		/* One direction of a bidirectional search: tentative distances, tree links and a heap */
+		template<typename E>
+		struct search_side {
+			std::vector<std::optional<E>> distance;
+			std::vector<node_id> link;
+			std::vector<bool> done;
+			dary_heap<E, node_id> heap;
+
+			search_side(std::size_t n, node_id start)
+			: distance(n)
+			, link(n, no_node)
+			, done(n, false) {
+				distance[start] = E{};
+				heap.push(E{}, start);
+			}
+
+			/* Drop stale entries so the top key is a live one */
+			auto prune() -> void {
+				while (not heap.empty() and done[heap.top().second]) {
+					heap.pop();
+				}
+			}
+		};
+	} // namespace detail
+
+	/* Point-to-point Dijkstra from both ends at once, always advancing the side with the smaller
+	 * tentative distance. It stops when the two smallest keys together reach the best meeting
+	 * path, which typically settles about half the nodes a one-directional search does. Needs a
+	 * snapshot with in-edges. A negative weight throws when the search scans it; edges past the
+	 * point where the search stops aren't looked at. */
+	template<typename N, path_weight E>
+	auto bidirectional_shortest_path(csr_graph<N, E> const& g, N const& src, N const& dst)
+	   -> std::optional<weighted_path<N, E>> {
+		auto const source = detail::source_id(g, src);
+		auto const target = detail::source_id(g, dst);
+		if (not g.has_in_edges()) {
+			throw std::runtime_error("Cannot call gdwg::bidirectional_shortest_path on a csr_graph "
+			                         "without in-edges");
+		}
+
+		auto const n = g.node_count();
+		auto forward = detail::search_side<E>(n, source);
+		auto backward = detail::search_side<E>(n, target);
+		auto best = std::optional<E>(source == target ? std::optional<E>(E{}) : std::nullopt);
+		auto meet = source == target ? source : no_node;
+		auto settled = std::size_t{0};
+
+		// Settle one node of this side, relaxing the lightest edge of every parallel run
+		auto step = [&](detail::search_side<E>& self, detail::search_side<E> const& other, bool out) {
+			auto const [d, u] = self.heap.pop();
+			self.done[u] = true;
+			++settled;
+
+			auto const neighbours = out ? g.targets(u) : g.sources(u);
+			auto const weights = out ? g.weights(u) : g.in_weights(u);
+			for (auto i = std::size_t{0}; i < neighbours.size(); ++i) {
+				// Checked before the skip, so a negative edge into a settled node still throws
+				if (weights[i] < E{}) {
+					throw std::runtime_error("Cannot call gdwg::bidirectional_shortest_path on a graph "
+					                         "with negative weights");
+				}
+
+				auto const v = neighbours[i];
+				if ((i > 0 and neighbours[i - 1] == v) or self.done[v]) {
+					continue;
+				}
+
+				auto const candidate = static_cast<E>(d + weights[i]);
+				if (self.distance[v] and not(candidate < *self.distance[v])) {
+					continue;
+				}
+
+				self.distance[v] = candidate;
+				self.link[v] = u;
+				self.heap.push(candidate, v);
+				if (other.distance[v]) {
+					auto const through = static_cast<E>(candidate + *other.distance[v]);
+					if (not best or through < *best) {
+						best = through;
+						meet = v;
+					}
+				}
+			}
+		};
+
+		while (true) {
+			forward.prune();
+			backward.prune();
+			if (forward.heap.empty() or backward.heap.empty()) {
+				break;
+			}
+
+			auto const& top_forward = forward.heap.top().first;
+			auto const& top_backward = backward.heap.top().first;
+			if (best and not(top_forward + top_backward < *best)) {
+				break;
+			}
+
+			if (not(top_backward < top_forward)) {
+				step(forward, backward, true);
+			}
+			else {
+				step(backward, forward, false);
+			}
+		}
+
+		if (not best) {
+			return std::nullopt;
+		}
+
+		auto path = weighted_path<N, E>{{}, *best, settled};
+		for (auto id = meet; id != no_node; id = forward.link[id]) {
+			path.nodes.push_back(g.node(id));
+		}
+		std::reverse(path.nodes.begin(), path.nodes.end());
+		for (auto id = backward.link[meet]; id != no_node; id = backward.link[id]) {
+			path.nodes.push_back(g.node(id));
+		}
+		return path;
+	}
+
+	/* Freezes g with in-edges, which graph itself doesn't index */
+	template<typename N, path_weight E>
+	auto bidirectional_shortest_path(graph<N, E> const& g, N const& src, N const& dst)
+	   -> std::optional<weighted_path<N, E>> {
+		return bidirectional_shortest_path(csr_graph<N, E>(g, adjacency::in_and_out), src, dst);
+	}
+
+	/* A* search: heuristic(n) estimates the remaining weight from n to dst and is called at most
+	 * once per node. Any admissible (never overestimating) heuristic gives a shortest path;
+	 * nodes are reopened if a shorter way to them turns up, so consistency isn't required. */
+	template<typename N, path_weight E, typename Heuristic>
+	requires std::invocable<Heuristic const&, N const&>
+	auto astar(csr_graph<N, E> const& g, N const& src, N const& dst, Heuristic const& heuristic)
+	   -> std::optional<weighted_path<N, E>> {
+		auto const source = detail::source_id(g, src);
+		auto const target = detail::source_id(g, dst);
+
+		auto const n = g.node_count();
+		auto distance = std::vector<std::optional<E>>(n);
+		auto estimate = std::vector<std::optional<E>>(n);
+		auto parent = std::vector<node_id>(n, no_node);
+		auto heap = dary_heap<E, node_id>(4);
+		auto settled = std::size_t{0};
+
+		auto estimate_of = [&](node_id id) -> E {
+			if (not estimate[id]) {
+				estimate[id] = static_cast<E>(heuristic(g.node(id)));
+			}
+			return *estimate[id];
+		};
+
+		distance[source] = E{};
+		heap.push(estimate_of(source), source);
+		while (not heap.empty()) {
+			auto const [f, u] = heap.pop();
+			if (*distance[u] + estimate_of(u) < f) {
+				continue;
+			}
+			++settled;
+			if (u == target) {
+				break;
+			}
+
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				auto const v = targets[i];
+				if (i > 0 and targets[i - 1] == v) {
+					continue;
+				}
+
+				if (weights[i] < E{}) {
+					throw std::runtime_error("Cannot call gdwg::astar on a graph with negative weights");
+				}
+
+				auto const candidate = static_cast<E>(*distance[u] + weights[i]);
+				if (not distance[v] or candidate < *distance[v]) {
+					distance[v] = candidate;
+					parent[v] = u;
+					heap.push(static_cast<E>(candidate + estimate_of(v)), v);
+				}
+			}
+		}
+
+		if (not distance[target]) {
+			return std::nullopt;
+		}
+
+		auto path = weighted_path<N, E>{{}, *distance[target], settled};
+		for (auto id = target; id != no_node; id = parent[id]) {
+			path.nodes.push_back(g.node(id));
+		}
+		std::reverse(path.nodes.begin(), path.nodes.end());
+		return path;
+	}
+
+	template<typename N, path_weight E, typename Heuristic>
+	requires std::invocable<Heuristic const&, N const&>
+	auto astar(graph<N, E> const& g, N const& src, N const& dst, Heuristic const& heuristic)
+	   -> std::optional<weighted_path<N, E>> {
+		return astar(csr_graph<N, E>(g), src, dst, heuristic);
+	}
+} // namespace gdwg
+
+#endif // GDWG_SHORTEST_PATHS_HPP
@@ -0,0 +1,262 @@
+#ifndef GDWG_THREAD_POOL_HPP
+#define GDWG_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	/* A work-stealing pool: every worker owns a deque, pops its own work LIFO and steals FIFO from
+	 * the others when it runs dry. Threads outside the pool share an injection queue and help run
+	 * tasks while they wait, so a pool with zero workers simply runs everything on the caller. */
+	class thread_pool {
+	public:
+		explicit thread_pool(std::size_t workers = default_worker_count()) {
+			queues_.reserve(workers + 1);
+			for (auto i = std::size_t{0}; i <= workers; ++i) {
+				queues_.push_back(std::make_unique<task_queue>());
+			}
+
+			threads_.reserve(workers);
+			for (auto i = std::size_t{1}; i <= workers; ++i) {
+				threads_.emplace_back([this, i] { worker_loop(i); });
+			}
+		}
+
+		thread_pool(thread_pool const&) = delete;
+		auto operator=(thread_pool const&) -> thread_pool& = delete;
+
+		~thread_pool() {
+			{
+				auto lock = std::scoped_lock(mutex_);
+				stop_ = true;
+			}
+			wake_.notify_all();
+
+			for (auto& t : threads_) {
+				t.join();
+			}
+		}
+
+		/* Shared pool sized to the machine, created on first use */
+		[[nodiscard]] static auto default_pool() -> thread_pool& {
+			static auto pool = thread_pool();
+			return pool;
+		}
+
+		/* The calling thread also runs tasks, so leave one core for it */
+		[[nodiscard]] static auto default_worker_count() -> std::size_t {
+			return std::max(std::thread::hardware_concurrency(), 1U) - 1;
+		}
+
+		/* Number of worker threads, not counting the caller */
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return threads_.size();
+		}
+
+		/* A chunk size giving every thread several pieces of [0, count) to balance with */
+		[[nodiscard]] auto grain_for(std::size_t count) const noexcept -> std::size_t {
+			return std::max(count / ((size() + 1) * 8), std::size_t{1});
+		}
+
+		/* Call f(i) for every i in [first, last). Ranges larger than grain are split in half
+		 * recursively and the halves left for idle workers to steal. Blocks until done and rethrows
+		 * the first exception thrown by f. */
+		template<typename F>
+		auto parallel_for(std::size_t first, std::size_t last, std::size_t grain, F const& f) -> void {
+			if (first >= last) {
+				return;
+			}
+
+			grain = std::max(grain, std::size_t{1});
+			if (threads_.empty() or last - first <= grain) {
+				for (; first != last; ++first) {
+					f(first);
+				}
+				return;
+			}
+
+			auto group = task_group{};
+			run_range(group, first, last, grain, f);
+			wait(group);
+
+			if (group.error) {
+				std::rethrow_exception(group.error);
+			}
+		}
+
+	private:
+		struct alignas(64) task_queue {
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		struct task_group {
+			std::atomic<std::size_t> pending{0};
+			std::atomic<bool> failed{false};
+			std::exception_ptr error;
+			std::mutex error_mutex;
+
+			auto fail(std::exception_ptr e) -> void {
+				auto lock = std::scoped_lock(error_mutex);
+				if (not error) {
+					error = std::move(e);
+				}
+				failed.store(true, std::memory_order_release);
+			}
+		};
+
+		std::vector<std::unique_ptr<task_queue>> queues_;
+		std::vector<std::thread> threads_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::atomic<std::ptrdiff_t> queued_{0};
+		bool stop_ = false;
+
+		/* Which queue the current thread owns: its worker index, or 0 for outside threads */
+		static auto current() -> std::pair<thread_pool const*, std::size_t>& {
+			thread_local auto self = std::pair<thread_pool const*, std::size_t>{nullptr, 0};
+			return self;
+		}
+
+		[[nodiscard]] auto local_index() const -> std::size_t {
+			auto const& [pool, index] = current();
+			return pool == this ? index : 0;
+		}
+
+		template<typename F>
+		auto run_range(task_group& group,
+		               std::size_t first,
+		               std::size_t last,
+		               std::size_t grain,
+		               F const& f) -> void {
+			// Keep the left half, publish the right half for thieves
+			while (last - first > grain) {
+				auto const mid = first + (last - first) / 2;
+				spawn(group, [this, &group, mid, last, grain, &f] {
+					run_range(group, mid, last, grain, f);
+				});
+				last = mid;
+			}
+
+			if (group.failed.load(std::memory_order_acquire)) {
+				return;
+			}
+
+			try {
+				for (; first != last; ++first) {
+					f(first);
+				}
+			} catch (...) {
+				group.fail(std::current_exception());
+			}
+		}
+
+		template<typename Task>
+		auto spawn(task_group& group, Task task) -> void {
+			group.pending.fetch_add(1, std::memory_order_relaxed);
+			{
+				auto lock = std::scoped_lock(mutex_);
+				queued_.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			auto& queue = *queues_[local_index()];
+			{
+				auto lock = std::scoped_lock(queue.mutex);
+				queue.tasks.emplace_back([&group, task = std::move(task)] {
+					task();
+					group.pending.fetch_sub(1, std::memory_order_acq_rel);
+				});
+			}
+			wake_.notify_one();
+		}
+
+		/* Pop from our own queue first, then steal from the others */
+		auto run_one() -> bool {
+			auto const self = local_index();
+			auto task = std::function<void()>();
+
+			for (auto i = std::size_t{0}; i < queues_.size() and not task; ++i) {
+				auto& queue = *queues_[(self + i) % queues_.size()];
+				auto lock = std::scoped_lock(queue.mutex);
+				if (queue.tasks.empty()) {
+					continue;
+				}
+
+				if (i == 0) {
+					task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+				}
+				else {
+					task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+				}
+			}
+
+			if (not task) {
+				return false;
+			}
+
+			queued_.fetch_sub(1, std::memory_order_relaxed);
+			task();
+			return true;
+		}
+
+		/* Help out until every task of the group has finished */
+		auto wait(task_group& group) -> void {
+			while (group.pending.load(std::memory_order_acquire) != 0) {
+				if (not run_one()) {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		auto worker_loop(std::size_t index) -> void {
+			current() = {this, index};
+
+			while (true) {
+				if (run_one()) {
+					continue;
+				}
+
+				auto lock = std::unique_lock(mutex_);
+				wake_.wait(lock, [this] {
+					return stop_ or queued_.load(std::memory_order_relaxed) > 0;
+				});
+				if (stop_ and queued_.load(std::memory_order_relaxed) <= 0) {
+					return;
+				}
+			}
+		}
+	};
+
+	namespace detail {
+		/* parallel_for on pool, or a plain loop when there is no pool */
+		template<typename F>
+		auto for_range(thread_pool* pool,
+		               std::size_t first,
+		               std::size_t last,
+		               std::size_t grain,
+		               F const& f) -> void {
+			if (pool == nullptr) {
+				for (; first < last; ++first) {
+					f(first);
+				}
+				return;
+			}
+
+			pool->parallel_for(first, last, grain, f);
+		}
+	} // namespace detail
+} // namespace gdwg
+
+#endif // GDWG_THREAD_POOL_HPP
@@ -0,0 +1,408 @@
+#ifndef GDWG_TRIANGLES_HPP
+#define GDWG_TRIANGLES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+namespace gdwg {
+	enum class triangle_kind {
+		// Three nodes pairwise joined by an edge in either direction
+		undirected,
+		// u -> v -> w -> u
+		cycle,
+		// u -> v, v -> w and u -> w; counted once per such ordered triple
+		transitive,
+	};
+
+	struct triangle_options {
+		// nullptr runs on the calling thread
+		thread_pool* pool = nullptr;
+
+		triangle_kind kind = triangle_kind::undirected;
+	};
+
+	template<typename N>
+	struct triangle_counts {
+		std::shared_ptr<std::vector<N> const> nodes;
+
+		std::uint64_t total = 0;
+
+		// Triangles each node is part of, indexed by node id
+		std::vector<std::uint64_t> per_node;
+
+		[[nodiscard]] auto count(N const& value) const -> std::uint64_t {
+			auto const id = detail::find_node(*nodes, value);
+			if (id == no_node) {
+				throw std::runtime_error("Cannot call gdwg::triangle_counts<N>::count on a node that "
+				                         "doesn't exist in the graph");
+			}
+			return per_node[id];
+		}
+	};
+
+	namespace detail {
+		/* Elements common to two ascending lists without duplicates. AVX2 compares blocks of 8
+		 * against all 8 rotations of the other block; the tails are merged. */
+		inline auto intersect_count(std::span<node_id const> a, std::span<node_id const> b)
+		   -> std::size_t {
+			auto i = std::size_t{0};
+			auto j = std::size_t{0};
+			auto count = std::size_t{0};
+#if defined(__AVX2__)
+			auto const rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+			while (i + 8 <= a.size() and j + 8 <= b.size()) {
+				auto const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a.data() + i));
+				auto vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b.data() + j));
+				auto match = _mm256_cmpeq_epi32(va, vb);
+				for (auto r = 1; r < 8; ++r) {
+					vb = _mm256_permutevar8x32_epi32(vb, rotate);
+					match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+				}
+				count += static_cast<std::size_t>(std::popcount(
+				   static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(match)))));
+
+				auto const a_last = a[i + 7];
+				auto const b_last = b[j + 7];
+				i += a_last <= b_last ? 8 : 0;
+				j += b_last <= a_last ? 8 : 0;
+			}
+#endif
+			while (i < a.size() and j < b.size()) {
+				if (a[i] < b[j]) {
+					++i;
+				}
+				else if (b[j] < a[i]) {
+					++j;
+				}
+				else {
+					++count;
+					++i;
+					++j;
+				}
+			}
+			return count;
+		}
+
+		/* Call f(i, j) for every a[i] == b[j], with the same blocking as intersect_count */
+		template<typename F>
+		auto intersect_for_each(std::span<node_id const> a, std::span<node_id const> b, F const& f)
+		   -> void {
+			auto i = std::size_t{0};
+			auto j = std::size_t{0};
+#if defined(__AVX2__)
+			auto const rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+			while (i + 8 <= a.size() and j + 8 <= b.size()) {
+				auto const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a.data() + i));
+				auto vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b.data() + j));
+				auto match = _mm256_cmpeq_epi32(va, vb);
+				for (auto r = 1; r < 8; ++r) {
+					vb = _mm256_permutevar8x32_epi32(vb, rotate);
+					match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+				}
+				auto lanes = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+				for (; lanes != 0; lanes &= lanes - 1) {
+					auto const ai = i + static_cast<std::size_t>(std::countr_zero(lanes));
+					auto bj = j;
+					while (b[bj] != a[ai]) {
+						++bj;
+					}
+					f(ai, bj);
+				}
+
+				auto const a_last = a[i + 7];
+				auto const b_last = b[j + 7];
+				i += a_last <= b_last ? 8 : 0;
+				j += b_last <= a_last ? 8 : 0;
+			}
+#endif
+			while (i < a.size() and j < b.size()) {
+				if (a[i] < b[j]) {
+					++i;
+				}
+				else if (b[j] < a[i]) {
+					++j;
+				}
+				else {
+					f(i, j);
+					++i;
+					++j;
+				}
+			}
+		}
+
+		// Edge directions between two nodes: x -> y, y -> x, relative to the lower ranked x
+		inline constexpr auto forward_edge = std::uint8_t{1};
+		inline constexpr auto backward_edge = std::uint8_t{2};
+
+		/* The graph without direction, self loops or parallel edges, renumbered by ascending
+		 * degree and each edge kept only at its lower ranked end. Every triangle then shows up
+		 * exactly once, as x < v < w with v and w in x's list and w in v's, and no list is longer
+		 * than about sqrt(2E). */
+		struct oriented_graph {
+			// rank -> original id
+			std::vector<node_id> original;
+			std::vector<std::size_t> offsets;
+			std::vector<node_id> targets;
+			std::vector<std::uint8_t> directions;
+
+			[[nodiscard]] auto out(node_id x) const -> std::span<node_id const> {
+				return std::span<node_id const>(targets).subspan(offsets[x], offsets[x + 1] - offsets[x]);
+			}
+
+			[[nodiscard]] auto direction(node_id x, std::size_t i) const -> std::uint8_t {
+				return directions[offsets[x] + i];
+			}
+		};
+
+		template<typename N, typename E>
+		auto orient(csr_graph<N, E> const& g, thread_pool* pool) -> oriented_graph {
+			auto const n = g.node_count();
+
+			// Both ends of every edge, packed as (neighbour << 2) | direction
+			auto offsets = std::vector<std::size_t>(n + 1, 0);
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto const v : g.targets(u)) {
+					if (u != v) {
+						++offsets[u + 1];
+						++offsets[v + 1];
+					}
+				}
+			}
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+			auto ends = std::vector<std::uint64_t>(offsets.back());
+			auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+			for (auto u = node_id{0}; u < n; ++u) {
+				for (auto const v : g.targets(u)) {
+					if (u != v) {
+						ends[fill[u]++] = (std::uint64_t{v} << 2U) | forward_edge;
+						ends[fill[v]++] = (std::uint64_t{u} << 2U) | backward_edge;
+					}
+				}
+			}
+
+			// Sort each list and fold repeated neighbours into one entry
+			auto degree = std::vector<std::size_t>(n, 0);
+			detail::for_range(pool, 0, n, 256, [&](std::size_t u) {
+				auto const first = ends.begin() + static_cast<std::ptrdiff_t>(offsets[u]);
+				auto const last = ends.begin() + static_cast<std::ptrdiff_t>(offsets[u + 1]);
+				std::sort(first, last);
+				auto out = first;
+				for (auto it = first; it != last; ++it) {
+					if (out != first and (*(out - 1) >> 2U) == (*it >> 2U)) {
+						*(out - 1) |= *it & 3U;
+					}
+					else {
+						*out++ = *it;
+					}
+				}
+				degree[u] = static_cast<std::size_t>(out - first);
+			});
+
+			auto result = oriented_graph{};
+			result.original.resize(n);
+			std::iota(result.original.begin(), result.original.end(), node_id{0});
+			std::stable_sort(result.original.begin(), result.original.end(), [&](node_id a, node_id b) {
+				return degree[a] < degree[b];
+			});
+			auto rank = std::vector<node_id>(n);
+			for (auto x = node_id{0}; x < n; ++x) {
+				rank[result.original[x]] = x;
+			}
+
+			result.offsets.assign(n + 1, 0);
+			for (auto x = node_id{0}; x < n; ++x) {
+				auto const u = result.original[x];
+				for (auto e = offsets[u]; e < offsets[u] + degree[u]; ++e) {
+					if (rank[ends[e] >> 2U] > x) {
+						++result.offsets[x + 1];
+					}
+				}
+			}
+			std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+			result.targets.resize(result.offsets.back());
+			result.directions.resize(result.offsets.back());
+
+			detail::for_range(pool, 0, n, 256, [&](std::size_t x) {
+				auto const u = result.original[x];
+				auto entries = std::vector<std::uint64_t>();
+				for (auto e = offsets[u]; e < offsets[u] + degree[u]; ++e) {
+					auto const y = rank[ends[e] >> 2U];
+					if (y > x) {
+						entries.push_back((std::uint64_t{y} << 2U) | (ends[e] & 3U));
+					}
+				}
+				std::sort(entries.begin(), entries.end());
+				for (auto i = std::size_t{0}; i < entries.size(); ++i) {
+					result.targets[result.offsets[x] + i] = static_cast<node_id>(entries[i] >> 2U);
+					result.directions[result.offsets[x] + i] = static_cast<std::uint8_t>(entries[i] & 3U);
+				}
+			});
+			return result;
+		}
+
+		/* Directed triangles on x < v < w of the given kind, from the direction of each side */
+		inline auto
+		directed_triangles(triangle_kind kind, std::uint8_t xv, std::uint8_t xw, std::uint8_t vw)
+		   -> std::uint64_t {
+			auto const edge = [&](int from, int to) {
+				// 0 = x, 1 = v, 2 = w; lower index is the lower rank
+				auto const side = from + to == 1 ? xv : from + to == 2 ? xw : vw;
+				return (side & (from < to ? forward_edge : backward_edge)) != 0;
+			};
+
+			if (kind == triangle_kind::cycle) {
+				return std::uint64_t{edge(0, 1) and edge(1, 2) and edge(2, 0)}
+				       + std::uint64_t{edge(0, 2) and edge(2, 1) and edge(1, 0)};
+			}
+
+			auto count = std::uint64_t{0};
+			constexpr int orders[6][3] = {
+			   {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+			for (auto const& [a, b, c] : orders) {
+				count += std::uint64_t{edge(a, b) and edge(b, c) and edge(a, c)};
+			}
+			return count;
+		}
+
+		/* Split [0, n) into pieces of about equal intersection work. Ranks grow with degree, so
+		 * the expensive nodes cluster at the end and equal-sized index ranges would be unbalanced. */
+		inline auto split_by_work(oriented_graph const& g, std::size_t pieces) -> std::vector<node_id> {
+			auto const n = g.original.size();
+			auto work = std::vector<std::size_t>(n + 1, 0);
+			for (auto x = node_id{0}; x < n; ++x) {
+				auto cost = std::size_t{1};
+				for (auto const v : g.out(x)) {
+					cost += g.out(x).size() + g.out(v).size();
+				}
+				work[x + 1] = work[x] + cost;
+			}
+
+			auto bounds = std::vector<node_id>{0};
+			for (auto p = std::size_t{1}; p < pieces; ++p) {
+				auto const target = work.back() / pieces * p;
+				auto const at =
+				   static_cast<node_id>(std::lower_bound(work.begin(), work.end(), target) - work.begin());
+				if (at > bounds.back() and at < n) {
+					bounds.push_back(at);
+				}
+			}
+			bounds.push_back(static_cast<node_id>(n));
+			return bounds;
+		}
+
+		template<typename F>
+		auto for_each_piece(oriented_graph const& g, thread_pool* pool, F const& f) -> void {
+			auto const bounds = split_by_work(g, pool == nullptr ? 1 : (pool->size() + 1) * 8);
+			detail::for_range(pool, 0, bounds.size() - 1, 1, [&](std::size_t p) {
+				for (auto x = bounds[p]; x < bounds[p + 1]; ++x) {
+					f(p, x);
+				}
+			});
+		}
+	} // namespace detail
+
+	/* Number of triangles of the given kind. Undirected counting only needs intersection sizes;
+	 * the directed kinds also look at which way each side points. */
+	template<typename N, typename E>
+	auto count_triangles(csr_graph<N, E> const& g, triangle_options const& options = {})
+	   -> std::uint64_t {
+		auto const oriented = detail::orient(g, options.pool);
+		auto const pieces = options.pool == nullptr ? 1 : (options.pool->size() + 1) * 8;
+		auto totals = std::vector<std::uint64_t>(pieces, 0);
+
+		detail::for_each_piece(oriented, options.pool, [&](std::size_t p, node_id x) {
+			auto const out = oriented.out(x);
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				auto const v = out[i];
+				if (options.kind == triangle_kind::undirected) {
+					totals[p] += detail::intersect_count(out.subspan(i + 1), oriented.out(v));
+					continue;
+				}
+				auto const later = out.subspan(i + 1);
+				detail::intersect_for_each(later, oriented.out(v), [&](std::size_t a, std::size_t b) {
+					totals[p] += detail::directed_triangles(options.kind,
+					                                        oriented.direction(x, i),
+					                                        oriented.direction(x, i + 1 + a),
+					                                        oriented.direction(v, b));
+				});
+			}
+		});
+		return std::accumulate(totals.begin(), totals.end(), std::uint64_t{0});
+	}
+
+	template<typename N, typename E>
+	auto count_triangles(graph<N, E> const& g, triangle_options const& options = {}) -> std::uint64_t {
+		return count_triangles(csr_graph<N, E>(g), options);
+	}
+
+	/* Triangles of the given kind through every node, plus the total */
+	template<typename N, typename E>
+	auto triangles_per_node(csr_graph<N, E> const& g, triangle_options const& options = {})
+	   -> triangle_counts<N> {
+		auto const oriented = detail::orient(g, options.pool);
+		auto result =
+		   triangle_counts<N>{g.node_table(), 0, std::vector<std::uint64_t>(g.node_count(), 0)};
+
+		auto const add = [&](node_id x, std::uint64_t count) {
+			std::atomic_ref<std::uint64_t>(result.per_node[oriented.original[x]])
+			   .fetch_add(count, std::memory_order_relaxed);
+		};
+		detail::for_each_piece(oriented, options.pool, [&](std::size_t, node_id x) {
+			auto const out = oriented.out(x);
+			auto own = std::uint64_t{0};
+			for (auto i = std::size_t{0}; i < out.size(); ++i) {
+				auto const v = out[i];
+				auto through_v = std::uint64_t{0};
+				auto const later = out.subspan(i + 1);
+				detail::intersect_for_each(later, oriented.out(v), [&](std::size_t a, std::size_t b) {
+					auto const count = options.kind == triangle_kind::undirected
+					                      ? std::uint64_t{1}
+					                      : detail::directed_triangles(options.kind,
+					                                                   oriented.direction(x, i),
+					                                                   oriented.direction(x, i + 1 + a),
+					                                                   oriented.direction(v, b));
+					if (count != 0) {
+						through_v += count;
+						add(out[i + 1 + a], count);
+					}
+				});
+				if (through_v != 0) {
+					own += through_v;
+					add(v, through_v);
+				}
+			}
+			if (own != 0) {
+				add(x, own);
+			}
+		});
+
+		// Every triangle was added to each of its three nodes
+		result.total =
+		   std::accumulate(result.per_node.begin(), result.per_node.end(), std::uint64_t{0}) / 3;
+		return result;
+	}
+
+	template<typename N, typename E>
+	auto triangles_per_node(graph<N, E> const& g, triangle_options const& options = {})
+	   -> triangle_counts<N> {
+		return triangles_per_node(csr_graph<N, E>(g), options);
+	}
+} // namespace gdwg
+
+#endif // GDWG_TRIANGLES_HPP
@@ -0,0 +1,271 @@
+#include "gdwg/contraction_hierarchy.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_paths.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Directed grid with different weights in each direction and a few one-way streets
+	auto make_grid(int side, int salt) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < side * side; ++i) {
+			g.insert_node(i);
+		}
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				auto const u = r * side + c;
+				auto const weight = [&](int v) { return (u * 31 + v * 17 + salt) % 23 + 1; };
+				if (c + 1 < side) {
+					g.insert_edge(u, u + 1, weight(u + 1));
+					if (u % 7 != 0) {
+						g.insert_edge(u + 1, u, weight(u + 100));
+					}
+				}
+				if (r + 1 < side) {
+					g.insert_edge(u, u + side, weight(u + side));
+					g.insert_edge(u + side, u, weight(u + 200));
+				}
+			}
+		}
+		return g;
+	}
+
+	auto make_random(int nodes, int degree) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < degree; ++d) {
+				g.insert_edge(i, (i * 37 + d * d * 11 + 5) % nodes, (i * 13 + d * 7) % 41);
+			}
+		}
+		return g;
+	}
+
+	// Every query from a handful of sources must agree with Dijkstra, paths included
+	auto check_against_dijkstra(gdwg::graph<int, int> const& g,
+	                            gdwg::contraction_hierarchy<int, int> const& ch) -> void {
+		auto const csr = gdwg::csr_graph<int, int>(g);
+		auto query = gdwg::contraction_hierarchy<int, int>::query(ch);
+		for (auto const src : {0, 3, static_cast<int>(csr.node_count()) / 2}) {
+			auto const expected = gdwg::shortest_paths(csr, src);
+			for (auto dst = 0; dst < static_cast<int>(csr.node_count()); ++dst) {
+				auto const distance = query.distance(src, dst);
+				REQUIRE(distance == expected.distance_to(dst));
+
+				auto const path = query.path(src, dst);
+				REQUIRE(path.has_value() == distance.has_value());
+				if (not path) {
+					continue;
+				}
+				CHECK(path->weight == *distance);
+				CHECK(path->nodes.front() == src);
+				CHECK(path->nodes.back() == dst);
+
+				auto total = 0;
+				for (auto i = std::size_t{1}; i < path->nodes.size(); ++i) {
+					auto const weights = g.weights(path->nodes[i - 1], path->nodes[i]);
+					REQUIRE_FALSE(weights.empty());
+					total += weights.front();
+				}
+				CHECK(total == *distance);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("contraction_hierarchy") {
+	SECTION("Throws on negative weights and unknown nodes") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -1);
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>(g)), std::runtime_error);
+
+		g.replace_node(2, 3);
+		g.erase_edge(1, 3, -1);
+		auto const ch = gdwg::contraction_hierarchy<int, int>(g);
+		auto query = gdwg::contraction_hierarchy<int, int>::query(ch);
+		CHECK_THROWS_AS(query.distance(1, 2), std::runtime_error);
+	}
+
+	SECTION("Small graph with parallel edges, self loops and unreachable nodes") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 10);
+		g.insert_edge("a", "b", 4);
+		g.insert_edge("b", "b", 0);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("a", "c", 6);
+
+		auto const ch = gdwg::contraction_hierarchy<std::string, int>(g);
+		auto query = gdwg::contraction_hierarchy<std::string, int>::query(ch);
+		CHECK(query.distance("a", "c") == 5);
+		CHECK(query.distance("a", "a") == 0);
+		CHECK_FALSE(query.distance("c", "a").has_value());
+		CHECK_FALSE(query.distance("a", "d").has_value());
+		CHECK(query.path("a", "c")->nodes == std::vector<std::string>{"a", "b", "c"});
+	}
+
+	SECTION("Grid and random graphs match Dijkstra") {
+		auto const grid = make_grid(20, 0);
+		check_against_dijkstra(grid, gdwg::contraction_hierarchy<int, int>(grid));
+
+		auto const random = make_random(400, 3);
+		check_against_dijkstra(random, gdwg::contraction_hierarchy<int, int>(random));
+	}
+
+	SECTION("Parallel preprocessing builds the same hierarchy") {
+		auto pool = gdwg::thread_pool(3);
+		auto const g = make_grid(30, 5);
+		auto const sequential = gdwg::contraction_hierarchy<int, int>(g);
+		auto const parallel = gdwg::contraction_hierarchy<int, int>(g, {.pool = &pool});
+		CHECK(parallel.arc_count() == sequential.arc_count());
+		CHECK(parallel.level_count() == sequential.level_count());
+
+		auto lhs = std::ostringstream();
+		auto rhs = std::ostringstream();
+		sequential.save(lhs);
+		parallel.save(rhs);
+		CHECK(lhs.str() == rhs.str());
+	}
+
+	SECTION("Queries settle far fewer nodes than Dijkstra") {
+		auto const g = make_grid(40, 0);
+		auto const ch = gdwg::contraction_hierarchy<int, int>(g);
+		auto query = gdwg::contraction_hierarchy<int, int>::query(ch);
+		CHECK(query.distance(0, 40 * 40 - 1) == gdwg::shortest_path(g, 0, 40 * 40 - 1)->weight);
+		CHECK(query.settled() < gdwg::shortest_path(g, 0, 40 * 40 - 1)->settled);
+	}
+
+	SECTION("Save and load round trip") {
+		auto const g = make_grid(15, 3);
+		auto const ch = gdwg::contraction_hierarchy<int, int>(g);
+		auto buffer = std::stringstream();
+		ch.save(buffer);
+
+		auto const loaded = gdwg::contraction_hierarchy<int, int>::load(buffer);
+		CHECK(loaded.node_count() == ch.node_count());
+		CHECK(loaded.arc_count() == ch.arc_count());
+		check_against_dijkstra(g, loaded);
+
+		auto bad = std::stringstream("not a hierarchy");
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>::load(bad)), std::runtime_error);
+
+		auto const bytes = buffer.str();
+		auto truncated = std::stringstream(bytes.substr(0, bytes.size() / 2));
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>::load(truncated)), std::runtime_error);
+
+		// middle_down_ ends the stream, one node id per arc; corrupt only those
+		auto const middles = bytes.size() - ch.arc_count() * sizeof(gdwg::node_id);
+
+		// A length prefix far beyond what the stream holds isn't allocated up front
+		auto long_prefix = bytes;
+		auto const forged = std::uint64_t{1} << 40U;
+		std::memcpy(long_prefix.data() + middles - sizeof(forged), &forged, sizeof(forged));
+		auto forged_stream = std::stringstream(long_prefix);
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>::load(forged_stream)), std::runtime_error);
+		auto const with_middles = [&](auto const& replace) {
+			auto corrupt = bytes;
+			for (auto at = middles; at < corrupt.size(); at += sizeof(gdwg::node_id)) {
+				auto middle = gdwg::node_id{0};
+				std::memcpy(&middle, corrupt.data() + at, sizeof(middle));
+				middle = replace(middle);
+				std::memcpy(corrupt.data() + at, &middle, sizeof(middle));
+			}
+			return std::stringstream(corrupt);
+		};
+		auto untouched = with_middles([](gdwg::node_id middle) { return middle; });
+		CHECK(gdwg::contraction_hierarchy<int, int>::load(untouched).arc_count() == ch.arc_count());
+
+		// One shortcut through a node that doesn't exist
+		auto replaced = false;
+		auto out_of_range = with_middles([&](gdwg::node_id middle) {
+			if (middle == gdwg::no_node or std::exchange(replaced, true)) {
+				return middle;
+			}
+			return static_cast<gdwg::node_id>(ch.node_count() + 5);
+		});
+		REQUIRE(replaced);
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>::load(out_of_range)), std::runtime_error);
+
+		// Every arc through node 0, including node 0's own arcs, which unpack would recurse on
+		auto through_zero = with_middles([](gdwg::node_id) { return gdwg::node_id{0}; });
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>::load(through_zero)), std::runtime_error);
+	}
+
+	SECTION("Load rejects fill-in that isn't chordal") {
+		// 2 and 3 are both above 0, so customizing 2 closes the triangle 2 -> 0 -> 3 through an
+		// arc 2 -> 3 that isn't there
+		auto stream = std::stringstream();
+		stream.write("GDWGCH01", 8);
+		gdwg::serializer<std::uint64_t>::write(stream, 4);
+		for (auto i = 0; i < 4; ++i) {
+			gdwg::serializer<int>::write(stream, i);
+		}
+		gdwg::detail::write_array(stream, std::vector<std::uint32_t>{0, 0, 1, 2});
+		gdwg::detail::write_array(stream, std::vector<std::size_t>{0, 2, 3, 3, 3});
+		gdwg::detail::write_array(stream, std::vector<gdwg::node_id>{2, 3, 3});
+		for (auto i = 0; i < 4; ++i) {
+			gdwg::detail::write_array(stream, std::vector<int>{1, 1, 100});
+		}
+		gdwg::detail::write_array(stream, std::vector<gdwg::node_id>(3, gdwg::no_node));
+		gdwg::detail::write_array(stream, std::vector<gdwg::node_id>(3, gdwg::no_node));
+		CHECK_THROWS_AS((gdwg::contraction_hierarchy<int, int>::load(stream)), std::runtime_error);
+	}
+
+	SECTION("Recustomize after weight changes") {
+		auto pool = gdwg::thread_pool(3);
+		auto g = make_grid(20, 0);
+		auto ch = gdwg::contraction_hierarchy<int, int>(g);
+
+		CHECK(ch.recustomize(g) == 0);
+
+		// Make one street very expensive and another free
+		auto const old_weight = g.weights(5, 6).front();
+		g.erase_edge(5, 6, old_weight);
+		g.insert_edge(5, 6, 500);
+		g.insert_edge(210, 230, 0);
+		CHECK(ch.recustomize(g, &pool) > 0);
+		check_against_dijkstra(g, ch);
+
+		// Dropping the only edge of a pair is a weight change to infinity
+		g.erase_edge(5, 6, 500);
+		CHECK(ch.recustomize(g) > 0);
+		check_against_dijkstra(g, ch);
+	}
+
+	SECTION("Recustomize rejects new node pairs and different nodes") {
+		// Leaves of a star go first and have only the centre as neighbour, so there's no fill-in
+		auto g = gdwg::graph<int, int>{0, 1, 2, 3, 4};
+		for (auto i = 1; i < 5; ++i) {
+			g.insert_edge(0, i, i);
+		}
+		auto ch = gdwg::contraction_hierarchy<int, int>(g);
+		CHECK(ch.arc_count() == 4);
+
+		auto extra = g;
+		extra.insert_node(100);
+		CHECK_THROWS_AS(ch.recustomize(extra), std::runtime_error);
+
+		auto shortcut = g;
+		shortcut.insert_edge(1, 4, 1);
+		CHECK_THROWS_AS(ch.recustomize(shortcut), std::runtime_error);
+
+		// Reversing an edge keeps the same pair
+		auto reversed = g;
+		reversed.erase_edge(0, 2, 2);
+		reversed.insert_edge(2, 0, 2);
+		CHECK(ch.recustomize(reversed) > 0);
+		check_against_dijkstra(reversed, ch);
+	}
+}
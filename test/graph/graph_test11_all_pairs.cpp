@@ -0,0 +1,139 @@
+#include "gdwg/all_pairs.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	template<typename E>
+	auto make_graph(int nodes, int degree, E offset) -> gdwg::graph<int, E> {
+		auto g = gdwg::graph<int, E>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < degree; ++d) {
+				auto const dst = (i * 37 + d * d * 11 + 5) % nodes;
+				g.insert_edge(i, dst, static_cast<E>(static_cast<E>((i * 13 + d * 7) % 29) + offset));
+			}
+		}
+		return g;
+	}
+
+	// Textbook Floyd-Warshall through the public iterator
+	template<typename E>
+	auto reference(gdwg::graph<int, E> const& g, int nodes) -> std::vector<std::optional<E>> {
+		auto d = std::vector<std::optional<E>>(static_cast<std::size_t>(nodes * nodes));
+		for (auto i = 0; i < nodes; ++i) {
+			d[static_cast<std::size_t>(i * nodes + i)] = E{};
+		}
+		for (auto const& [src, dst, weight] : g) {
+			auto& cell = d[static_cast<std::size_t>(src * nodes + dst)];
+			if (not cell or weight < *cell) {
+				cell = weight;
+			}
+		}
+		for (auto k = 0; k < nodes; ++k) {
+			for (auto i = 0; i < nodes; ++i) {
+				auto const& ik = d[static_cast<std::size_t>(i * nodes + k)];
+				for (auto j = 0; j < nodes and ik; ++j) {
+					auto const& kj = d[static_cast<std::size_t>(k * nodes + j)];
+					auto& ij = d[static_cast<std::size_t>(i * nodes + j)];
+					if (kj and (not ij or static_cast<E>(*ik + *kj) < *ij)) {
+						ij = static_cast<E>(*ik + *kj);
+					}
+				}
+			}
+		}
+		return d;
+	}
+
+	template<typename E>
+	auto check(gdwg::graph<int, E> const& g, int nodes, gdwg::all_pairs_options const& options)
+	   -> void {
+		auto const expected = reference(g, nodes);
+		auto const result = gdwg::all_pairs_shortest_paths(g, options);
+		REQUIRE(result.node_count() == static_cast<std::size_t>(nodes));
+		for (auto i = gdwg::node_id{0}; i < result.node_count(); ++i) {
+			for (auto j = gdwg::node_id{0}; j < result.node_count(); ++j) {
+				REQUIRE(result.distance(i, j) == expected[i * result.node_count() + j]);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("all_pairs_shortest_paths") {
+	SECTION("Parallel edges, self loops and unreachable pairs") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 10);
+		g.insert_edge("a", "b", 4);
+		g.insert_edge("b", "b", 3);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("a", "c", 6);
+
+		auto const result = gdwg::all_pairs_shortest_paths(g);
+		CHECK(result.distance("a", "c") == 5);
+		CHECK(result.distance("b", "b") == 0);
+		CHECK_FALSE(result.distance("c", "a").has_value());
+		CHECK_FALSE(result.distance("a", "d").has_value());
+		CHECK(result.row(0)[3] == gdwg::distance_matrix<std::string, int>::unreachable);
+		CHECK_THROWS_AS(result.distance("a", "e"), std::runtime_error);
+	}
+
+	SECTION("Empty graph") {
+		auto const result = gdwg::all_pairs_shortest_paths(gdwg::graph<int, int>{});
+		CHECK(result.node_count() == 0);
+		CHECK(result.distances.empty());
+	}
+
+	SECTION("Negative cycles throw") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 2);
+		g.insert_edge(2, 3, -4);
+		g.insert_edge(3, 1, 1);
+		CHECK_THROWS_AS(gdwg::all_pairs_shortest_paths(g), std::runtime_error);
+
+		auto loop = gdwg::graph<int, int>{1};
+		loop.insert_edge(1, 1, -1);
+		CHECK_THROWS_AS(gdwg::all_pairs_shortest_paths(loop), std::runtime_error);
+	}
+
+	auto pool = gdwg::thread_pool(3);
+
+	SECTION("Every tile size and thread count matches the textbook algorithm") {
+		auto const g = make_graph<int>(150, 3, 0);
+		for (auto const block : {std::size_t{1}, std::size_t{7}, std::size_t{64}, std::size_t{512}}) {
+			check(g, 150, {.block = block});
+			check(g, 150, {.pool = &pool, .block = block});
+		}
+	}
+
+	SECTION("Negative weights without negative cycles") {
+		// Edges only go from lower to higher ids, so there are no cycles at all
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 100; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 100; ++i) {
+			for (auto d = 1; d < 4 and i + d * d < 100; ++d) {
+				g.insert_edge(i, i + d * d, (i * 7 + d) % 11 - 5);
+			}
+		}
+		check(g, 100, {.pool = &pool, .block = 16});
+	}
+
+	SECTION("Other weight types") {
+		check(make_graph<double>(90, 3, 0.25), 90, {.pool = &pool, .block = 32});
+		check(make_graph<float>(90, 3, 0.5F), 90, {.block = 24});
+		check(make_graph<std::uint32_t>(90, 3, 1U), 90, {.pool = &pool, .block = 16});
+		check(make_graph<std::int64_t>(90, 3, 0), 90, {.block = 16});
+		check(make_graph<short>(40, 2, 0), 40, {.block = 8});
+	}
+}
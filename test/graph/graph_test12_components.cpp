@@ -0,0 +1,160 @@
+#include "gdwg/bfs.hpp"
+#include "gdwg/components.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// Cycles of varying length linked by forward edges, plus a few backward edges that merge some
+	// of them into bigger components
+	auto make_graph(int nodes) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto first = 0; first < nodes;) {
+			auto const last = std::min(nodes, first + 1 + (first * 31) % 60);
+			for (auto i = first; i + 1 < last; ++i) {
+				g.insert_edge(i, i + 1, i % 5);
+			}
+			g.insert_edge(last - 1, first, 1);
+			first = last;
+		}
+		for (auto i = 0; i + 1 < nodes; i += 3) {
+			g.insert_edge(i, i + 1 + (i * 7919 + 13) % std::min(nodes - i - 1, 500), 2);
+		}
+		for (auto i = 999; i < nodes; i += 1000) {
+			g.insert_edge(i, i - 150, 3);
+		}
+		return g;
+	}
+
+	// u and v share a component iff each reaches the other
+	auto same_component(gdwg::graph<int, int> const& g, int nodes) -> std::vector<std::vector<bool>> {
+		auto const csr = gdwg::csr_graph<int, int>(g);
+		auto reaches = std::vector<std::vector<bool>>(static_cast<std::size_t>(nodes));
+		for (auto u = 0; u < nodes; ++u) {
+			auto const result = gdwg::bfs(csr, u, {.direction_optimizing = false});
+			for (auto v = 0; v < nodes; ++v) {
+				reaches[static_cast<std::size_t>(u)].push_back(result.distance_to(v)
+				                                               != gdwg::bfs_result<int>::unreachable);
+			}
+		}
+		return reaches;
+	}
+} // namespace
+
+TEST_CASE("strongly_connected_components") {
+	SECTION("Small graph") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("d", "c", 1);
+		g.insert_edge("e", "e", 1);
+
+		auto const result = gdwg::strongly_connected_components(g);
+		CHECK(result.count == 3);
+		CHECK(result.component == std::vector<std::size_t>{0, 0, 1, 1, 2});
+		CHECK(result.component_of("d") == 1);
+		CHECK(result.members(0) == std::vector<std::string>{"a", "b"});
+		CHECK_THROWS_AS(result.component_of("z"), std::runtime_error);
+	}
+
+	SECTION("Empty graph") {
+		auto const result = gdwg::strongly_connected_components(gdwg::graph<int, int>{});
+		CHECK(result.count == 0);
+		CHECK(result.component.empty());
+	}
+
+	SECTION("Deep graphs don't overflow the stack") {
+		auto g = gdwg::graph<int, int>{};
+		auto constexpr nodes = 200000;
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i + 1 < nodes; ++i) {
+			g.insert_edge(i, i + 1, 0);
+		}
+		CHECK(gdwg::strongly_connected_components(g).count == nodes);
+
+		g.insert_edge(nodes - 1, 0, 0);
+		CHECK(gdwg::strongly_connected_components(g).count == 1);
+	}
+
+	SECTION("Matches mutual reachability") {
+		auto constexpr nodes = 400;
+		auto const g = make_graph(nodes);
+		auto const reaches = same_component(g, nodes);
+		auto const result = gdwg::strongly_connected_components(g);
+		for (auto u = std::size_t{0}; u < nodes; ++u) {
+			for (auto v = std::size_t{0}; v < nodes; ++v) {
+				REQUIRE((result.component[u] == result.component[v]) == (reaches[u][v] and reaches[v][u]));
+			}
+		}
+	}
+
+	auto pool = gdwg::thread_pool(3);
+
+	SECTION("Parallel matches Tarjan") {
+		// Large enough to go through trimming, forward-backward and colouring before Tarjan
+		for (auto const nodes : {300, 20000, 60000}) {
+			auto const g = make_graph(nodes);
+			auto const expected = gdwg::strongly_connected_components(g);
+			auto const parallel = gdwg::strongly_connected_components(g, {.pool = &pool});
+			CHECK(parallel.count == expected.count);
+			CHECK(parallel.component == expected.component);
+		}
+
+		// Long chains in both id directions are peeled by trimming
+		auto chain = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 30000; ++i) {
+			chain.insert_node(i);
+		}
+		for (auto i = 0; i + 1 < 15000; ++i) {
+			chain.insert_edge(i + 1, i, 0);
+			chain.insert_edge(15000 + i, 15001 + i, 0);
+		}
+		CHECK(gdwg::strongly_connected_components(chain, {.pool = &pool}).count == 30000);
+	}
+
+	SECTION("Parallel needs in-edges") {
+		auto const csr = gdwg::csr_graph<int, int>(make_graph(10));
+		CHECK_THROWS_AS(gdwg::strongly_connected_components(csr, {.pool = &pool}), std::runtime_error);
+	}
+}
+
+TEST_CASE("condensation") {
+	SECTION("Component ids, weights and parallel edges") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 2);
+		g.insert_edge("a", "c", 3);
+		g.insert_edge("b", "c", 3);
+		g.insert_edge("b", "c", 4);
+		g.insert_edge("c", "c", 5);
+
+		auto const dag = gdwg::condensation(g);
+		CHECK(dag.nodes() == std::vector<std::size_t>{0, 1, 2});
+		CHECK(dag.weights(0, 1) == std::vector<int>{3, 4});
+		CHECK(dag.connections(1).empty());
+		CHECK(dag.connections(2).empty());
+	}
+
+	SECTION("Is acyclic") {
+		auto pool = gdwg::thread_pool(3);
+		auto const g = make_graph(5000);
+		auto const components = gdwg::strongly_connected_components(g);
+		auto const dag = gdwg::condensation(g, {.pool = &pool});
+		CHECK(dag.nodes().size() == components.count);
+		CHECK(gdwg::strongly_connected_components(dag).count == components.count);
+	}
+}
@@ -0,0 +1,204 @@
+#include "gdwg/graph.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Every node appears once and every edge points forward
+	template<typename N, typename E>
+	auto check_order(gdwg::graph<N, E> const& g) -> void {
+		auto const order = g.topological_order();
+		REQUIRE(order.size() == g.nodes().size());
+
+		auto position = std::map<N, std::size_t>();
+		for (auto i = std::size_t{0}; i < order.size(); ++i) {
+			position.emplace(order[i], i);
+		}
+		REQUIRE(position.size() == order.size());
+		for (auto const& [from, to, weight] : g) {
+			REQUIRE(position.at(from) < position.at(to));
+		}
+	}
+
+	auto reaches(gdwg::graph<int, int> const& g, int from, int to) -> bool {
+		auto seen = std::vector<int>{from};
+		for (auto i = std::size_t{0}; i < seen.size(); ++i) {
+			if (seen[i] == to) {
+				return true;
+			}
+			for (auto const next : g.connections(seen[i])) {
+				if (std::find(seen.begin(), seen.end(), next) == seen.end()) {
+					seen.push_back(next);
+				}
+			}
+		}
+		return false;
+	}
+} // namespace
+
+TEST_CASE("Topological order is opt-in") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	CHECK_FALSE(g.maintains_topological_order());
+	CHECK_THROWS_AS(g.topological_order(), std::runtime_error);
+	CHECK_THROWS_AS(g.would_create_cycle(1, 2), std::runtime_error);
+
+	// Cycles are still allowed while disabled, and then stop it being enabled
+	g.insert_edge(1, 2, 0);
+	g.insert_edge(2, 1, 0);
+	CHECK_THROWS_AS(g.enable_topological_order(), std::runtime_error);
+	CHECK_FALSE(g.maintains_topological_order());
+
+	g.erase_edge(2, 1, 0);
+	g.enable_topological_order();
+	CHECK(g.maintains_topological_order());
+	CHECK(g.topological_order() == std::vector<int>{1, 2});
+
+	g.disable_topological_order();
+	CHECK_NOTHROW(g.insert_edge(2, 1, 0));
+}
+
+TEST_CASE("insert_edge keeps the order and rejects cycles") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.enable_topological_order();
+	g.insert_edge("d", "c", 1);
+	g.insert_edge("c", "b", 1);
+	g.insert_edge("b", "a", 1);
+	CHECK(g.topological_order() == std::vector<std::string>{"d", "c", "b", "a"});
+
+	CHECK(g.would_create_cycle("a", "d"));
+	CHECK(g.would_create_cycle("a", "a"));
+	CHECK_FALSE(g.would_create_cycle("d", "a"));
+	CHECK_THROWS_AS(g.would_create_cycle("a", "z"), std::runtime_error);
+
+	// A rejected edge leaves the graph as it was
+	auto const before = g;
+	CHECK_THROWS_AS(g.insert_edge("a", "d", 1), std::runtime_error);
+	CHECK_THROWS_AS(g.insert_edge("b", "b", 1), std::runtime_error);
+	CHECK(g == before);
+	check_order(g);
+
+	// Parallel edges and duplicates don't disturb anything
+	CHECK(g.insert_edge("d", "c", 2));
+	CHECK_FALSE(g.insert_edge("d", "c", 2));
+	check_order(g);
+
+	g.insert_node("e");
+	CHECK(g.topological_order().back() == "e");
+	g.insert_edge("e", "d", 1);
+	check_order(g);
+}
+
+TEST_CASE("Random insertions match brute-force reachability") {
+	auto constexpr nodes = 60;
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < nodes; ++i) {
+		g.insert_node(i);
+	}
+	g.enable_topological_order();
+
+	auto random = gdwg::test::lcg(7U);
+	auto next = [&random] { return (random() >> 8) % nodes; };
+	for (auto i = 0; i < 1500; ++i) {
+		auto const src = next();
+		auto const dst = next();
+		auto const cycle = src == dst or reaches(g, dst, src);
+		REQUIRE(g.would_create_cycle(src, dst) == cycle);
+		if (cycle) {
+			CHECK_THROWS_AS(g.insert_edge(src, dst, i), std::runtime_error);
+		}
+		else {
+			g.insert_edge(src, dst, i);
+		}
+
+		// Erasing now and then opens up edges that used to close a cycle
+		if (i % 10 == 9) {
+			auto it = g.begin();
+			std::advance(it, next() % 3);
+			if (it != g.end()) {
+				g.erase_edge(it);
+			}
+		}
+	}
+	check_order(g);
+}
+
+TEST_CASE("Other modifiers keep the order") {
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4, 5};
+	g.enable_topological_order();
+	g.insert_edge(5, 4, 0);
+	g.insert_edge(4, 3, 0);
+	g.insert_edge(3, 2, 0);
+	g.insert_edge(2, 1, 0);
+
+	SECTION("erase_edge in all its forms") {
+		CHECK(g.erase_edge(4, 3, 0));
+		CHECK_FALSE(g.would_create_cycle(3, 5));
+		g.insert_edge(3, 5, 0);
+		check_order(g);
+
+		g.erase_edge(g.begin(), g.end());
+		CHECK_FALSE(g.would_create_cycle(1, 5));
+		g.insert_edge(1, 5, 0);
+		check_order(g);
+	}
+
+	SECTION("erase_node") {
+		CHECK(g.erase_node(3));
+		CHECK_FALSE(g.would_create_cycle(2, 4));
+		g.insert_edge(2, 4, 0);
+		check_order(g);
+
+		// Enough erasures to compact the order
+		for (auto i = 10; i < 40; ++i) {
+			g.insert_node(i);
+			g.insert_edge(i, 5, 0);
+		}
+		for (auto i = 10; i < 39; ++i) {
+			g.erase_node(i);
+		}
+		check_order(g);
+		CHECK(g.would_create_cycle(4, 39));
+		CHECK_FALSE(g.would_create_cycle(1, 39));
+	}
+
+	SECTION("replace_node keeps its place") {
+		CHECK(g.replace_node(3, 30));
+		CHECK(g.topological_order() == std::vector<int>{5, 4, 30, 2, 1});
+		CHECK(g.would_create_cycle(1, 30));
+		CHECK_THROWS_AS(g.insert_edge(2, 30, 1), std::runtime_error);
+		g.insert_edge(30, 1, 1);
+		check_order(g);
+	}
+
+	SECTION("merge_replace_node") {
+		g.insert_node(6);
+		g.insert_edge(6, 2, 0);
+		CHECK_THROWS_AS(g.merge_replace_node(5, 1), std::runtime_error);
+		CHECK(g.nodes().size() == 6);
+
+		g.merge_replace_node(6, 4);
+		check_order(g);
+		CHECK(g.would_create_cycle(2, 4));
+	}
+
+	SECTION("Copies, moves and clear") {
+		auto copy = g;
+		CHECK(copy.maintains_topological_order());
+		CHECK_THROWS_AS(copy.insert_edge(1, 5, 0), std::runtime_error);
+
+		auto moved = std::move(copy);
+		CHECK(moved.maintains_topological_order());
+		check_order(moved);
+
+		moved.clear();
+		CHECK(moved.topological_order().empty());
+		moved.insert_node(1);
+		CHECK(moved.topological_order() == std::vector<int>{1});
+	}
+}
@@ -0,0 +1,144 @@
+#include "gdwg/bfs.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/reachability.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// Mostly forward edges, so the condensation is deep, plus backward edges that make cycles
+	auto make_graph(int nodes) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i + 1 < nodes; ++i) {
+			auto const span = std::min(nodes - i - 1, 40);
+			g.insert_edge(i, i + 1 + (i * 7919 + 13) % span, 1);
+			if (i % 3 == 0) {
+				g.insert_edge(i, i + 1 + (i * 104729 + 7) % span, 1);
+			}
+		}
+		for (auto i = 50; i < nodes; i += 97) {
+			g.insert_edge(i, i - 5, 1);
+		}
+		return g;
+	}
+
+	auto reachable_from(gdwg::graph<int, int> const& g, int nodes) -> std::vector<std::vector<bool>> {
+		auto const csr = gdwg::csr_graph<int, int>(g);
+		auto reaches = std::vector<std::vector<bool>>(static_cast<std::size_t>(nodes));
+		for (auto u = 0; u < nodes; ++u) {
+			auto const result = gdwg::bfs(csr, u, {.direction_optimizing = false});
+			for (auto v = 0; v < nodes; ++v) {
+				reaches[static_cast<std::size_t>(u)].push_back(result.distance_to(v)
+				                                               != gdwg::bfs_result<int>::unreachable);
+			}
+		}
+		return reaches;
+	}
+
+	auto matches(gdwg::reachability_index<int> const& index,
+	             std::vector<std::vector<bool>> const& expected) -> bool {
+		auto const nodes = static_cast<int>(expected.size());
+		for (auto u = 0; u < nodes; ++u) {
+			for (auto v = 0; v < nodes; ++v) {
+				auto const want = expected[static_cast<std::size_t>(u)][static_cast<std::size_t>(v)];
+				if (index.is_reachable(u, v) != want) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+} // namespace
+
+TEST_CASE("reachability_index") {
+	SECTION("Small graph") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("c", "d", 1);
+
+		auto const index = gdwg::reachability_index<std::string>(g);
+		CHECK(index.component_count() == 4);
+		CHECK(index.exact());
+		CHECK(index.is_reachable("a", "d"));
+		CHECK(index.is_reachable("b", "a"));
+		CHECK(index.is_reachable("e", "e"));
+		CHECK_FALSE(index.is_reachable("d", "a"));
+		CHECK_FALSE(index.is_reachable("a", "e"));
+		CHECK_THROWS_AS(index.is_reachable("a", "z"), std::runtime_error);
+		CHECK_THROWS_AS(index.is_reachable("z", "a"), std::runtime_error);
+	}
+
+	SECTION("Empty graph") {
+		auto const index = gdwg::reachability_index<int>(gdwg::graph<int, int>{});
+		CHECK(index.component_count() == 0);
+		CHECK(index.landmark_count() == 0);
+	}
+
+	auto constexpr nodes = 600;
+	auto const g = make_graph(nodes);
+	auto const expected = reachable_from(g, nodes);
+
+	SECTION("A generous budget labels every component") {
+		auto const index = gdwg::reachability_index<int>(g);
+		CHECK(index.exact());
+		CHECK(matches(index, expected));
+	}
+
+	SECTION("Small budgets fall back to pruned search") {
+		for (auto const budget : {std::size_t{0}, std::size_t{1} << 10U, std::size_t{20} << 10U}) {
+			for (auto const intervals : {std::size_t{0}, std::size_t{1}, std::size_t{3}}) {
+				auto const index =
+				   gdwg::reachability_index<int>(g, {.label_budget = budget, .intervals = intervals});
+				CHECK_FALSE(index.exact());
+				CHECK(index.landmark_count() <= budget * 8 / (2 * index.component_count()));
+				CHECK(matches(index, expected));
+			}
+		}
+	}
+
+	SECTION("Memory stays within the label budget plus the condensation") {
+		auto const small = gdwg::reachability_index<int>(g, {.label_budget = std::size_t{32} << 10U});
+		auto const large = gdwg::reachability_index<int>(g);
+		CHECK(small.memory_bytes() < large.memory_bytes());
+		CHECK(large.memory_bytes() - small.memory_bytes() <= std::size_t{64} << 20U);
+		CHECK(small.landmark_count() > 0);
+		CHECK(small.landmark_count() * 2 * small.component_count() <= (std::size_t{32} << 10U) * 8);
+	}
+
+	SECTION("Parallel build answers the same") {
+		auto pool = gdwg::thread_pool(4);
+		auto const index =
+		   gdwg::reachability_index<int>(g, {.pool = &pool, .label_budget = std::size_t{8} << 10U});
+		CHECK(matches(index, expected));
+
+		auto const csr = gdwg::csr_graph<int, int>(g, gdwg::adjacency::in_and_out);
+		CHECK(matches(gdwg::reachability_index<int>(csr, {.pool = &pool}), expected));
+	}
+
+	SECTION("Queries from many threads") {
+		auto pool = gdwg::thread_pool(4);
+		auto const index = gdwg::reachability_index<int>(g, {.label_budget = 0});
+		auto wrong = std::vector<int>(static_cast<std::size_t>(nodes), 0);
+		gdwg::detail::for_range(&pool, 0, nodes, 1, [&](std::size_t u) {
+			for (auto v = 0; v < nodes; ++v) {
+				auto const reached =
+				   index.is_reachable(static_cast<gdwg::node_id>(u), static_cast<gdwg::node_id>(v));
+				if (reached != expected[u][static_cast<std::size_t>(v)]) {
+					++wrong[u];
+				}
+			}
+		});
+		CHECK(std::count(wrong.begin(), wrong.end(), 0) == nodes);
+	}
+}
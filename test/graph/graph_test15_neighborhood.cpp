@@ -0,0 +1,150 @@
+#include "gdwg/bfs.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/neighborhood.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 1; d <= 3; ++d) {
+				g.insert_edge(i, (i * 7919 + d * 104729) % nodes, d);
+			}
+			if (i % 5 == 0) {
+				g.insert_edge(i, (i + 1) % nodes, 4);
+				g.insert_edge(i, (i + 1) % nodes, 5);
+			}
+		}
+		return g;
+	}
+
+	// Nodes at exactly h hops from seed, from a plain BFS
+	auto expected_hops(gdwg::csr_graph<int, int> const& g, int seed, std::size_t k)
+	   -> std::vector<std::vector<gdwg::node_id>> {
+		auto const result = gdwg::bfs(g, seed, {.direction_optimizing = false});
+		auto hops = std::vector<std::vector<gdwg::node_id>>(k + 1);
+		for (auto v = gdwg::node_id{0}; v < g.node_count(); ++v) {
+			if (result.distance[v] <= k) {
+				hops[result.distance[v]].push_back(v);
+			}
+		}
+		return hops;
+	}
+
+	auto matches_bfs(gdwg::k_hop_result<int> const& result, gdwg::csr_graph<int, int> const& g)
+	   -> bool {
+		for (auto i = std::size_t{0}; i < result.seed_count(); ++i) {
+			auto const expected = expected_hops(g, g.node(result.seeds[i]), result.k);
+			for (auto h = std::size_t{0}; h <= result.k; ++h) {
+				auto const hop = result.hop(i, h);
+				if (std::vector<gdwg::node_id>(hop.begin(), hop.end()) != expected[h]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+} // namespace
+
+TEST_CASE("k_hop_neighbors") {
+	SECTION("Small graph") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("a", "c", 1);
+		g.insert_edge("b", "d", 1);
+		g.insert_edge("c", "d", 2);
+		g.insert_edge("d", "a", 1);
+
+		auto const result = gdwg::k_hop_neighbors(g, {"a", "e", "d"}, 2);
+		CHECK(result.seed_count() == 3);
+		CHECK(result.hop_nodes(0, 0) == std::vector<std::string>{"a"});
+		CHECK(result.hop_nodes(0, 1) == std::vector<std::string>{"b", "c"});
+		CHECK(result.hop_nodes(0, 2) == std::vector<std::string>{"d"});
+		CHECK(result.neighborhood(1).size() == 1);
+		CHECK(result.hop(1, 1).empty());
+		CHECK(result.hop_nodes(2, 1) == std::vector<std::string>{"a"});
+		CHECK(result.hop_nodes(2, 2) == std::vector<std::string>{"b", "c"});
+		CHECK(result.neighborhood(2).size() == 4);
+		CHECK_THROWS_AS(gdwg::k_hop_neighbors(g, {"a", "z"}, 1), std::runtime_error);
+	}
+
+	SECTION("No seeds, zero hops") {
+		auto const g = make_graph(50);
+		CHECK(gdwg::k_hop_neighbors(g, {}, 3).members.empty());
+
+		auto const result = gdwg::k_hop_neighbors(g, {4, 7}, 0);
+		CHECK(result.members == std::vector<gdwg::node_id>{4, 7});
+	}
+
+	auto constexpr nodes = 2000;
+	auto const g = make_graph(nodes);
+	auto const csr = gdwg::csr_graph<int, int>(g);
+
+	// Several batches, a partial last batch, and repeated seeds in the same batch
+	auto seeds = std::vector<int>();
+	for (auto i = 0; i < 150; ++i) {
+		seeds.push_back((i * 37) % nodes);
+	}
+	seeds.push_back(seeds.front());
+
+	SECTION("Every hop matches a BFS from the seed") {
+		for (auto const k : {std::size_t{1}, std::size_t{3}, std::size_t{6}}) {
+			auto const result = gdwg::k_hop_neighbors(csr, seeds, k);
+			CHECK(result.seed_count() == seeds.size());
+			CHECK(matches_bfs(result, csr));
+		}
+	}
+
+	SECTION("Parallel matches sequential") {
+		auto pool = gdwg::thread_pool(4);
+		auto const sequential = gdwg::k_hop_neighbors(csr, seeds, 4);
+		auto const parallel = gdwg::k_hop_neighbors(csr, seeds, 4, {.pool = &pool});
+		CHECK(parallel.offsets == sequential.offsets);
+		CHECK(parallel.members == sequential.members);
+	}
+}
+
+TEST_CASE("ego_graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 2);
+	g.insert_edge("b", "c", 3);
+	g.insert_edge("c", "a", 4);
+	g.insert_edge("c", "d", 5);
+	g.insert_edge("e", "a", 6);
+
+	SECTION("Induced subgraph keeps every edge between its nodes") {
+		auto const ego = gdwg::ego_graph(g, std::string("a"), 2);
+		CHECK(ego.nodes() == std::vector<std::string>{"a", "b", "c"});
+		CHECK(ego.weights("a", "b") == std::vector<int>{1, 2});
+		CHECK(ego.weights("c", "a") == std::vector<int>{4});
+		CHECK(ego.weights("b", "c") == std::vector<int>{3});
+	}
+
+	SECTION("Radius bounds") {
+		CHECK(gdwg::ego_graph(g, std::string("a"), 0).nodes() == std::vector<std::string>{"a"});
+		CHECK(gdwg::ego_graph(g, std::string("e"), 10) == g);
+		CHECK_THROWS_AS(gdwg::ego_graph(g, std::string("z"), 1), std::runtime_error);
+	}
+
+	SECTION("Matches the k-hop neighbourhood on a larger graph") {
+		auto const big = make_graph(500);
+		auto const csr = gdwg::csr_graph<int, int>(big);
+		auto const ego = gdwg::ego_graph(csr, 17, 3);
+		auto const hops = gdwg::k_hop_neighbors(csr, {17}, 3).neighborhood(0);
+		CHECK(ego.nodes().size() == hops.size());
+		for (auto const& [from, to, weight] : ego) {
+			CHECK(big.find(from, to, weight) != big.end());
+		}
+	}
+}
@@ -0,0 +1,180 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+#include "gdwg/triangles.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// Random edges with some reciprocated pairs, parallel edges and self loops; a few hubs make
+	// the degrees skewed
+	auto make_graph(int nodes, int edges) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto next = gdwg::test::lcg(7U);
+		for (auto e = 0; e < edges; ++e) {
+			auto const src = next() % 4 == 0 ? next() % 5 : next() % nodes;
+			auto const dst = next() % nodes;
+			g.insert_edge(src, dst, next() % 3);
+			if (next() % 4 == 0) {
+				g.insert_edge(dst, src, 1);
+			}
+		}
+		return g;
+	}
+
+	struct brute_counts {
+		std::uint64_t undirected = 0;
+		std::uint64_t cycle = 0;
+		std::uint64_t transitive = 0;
+		std::vector<std::uint64_t> per_node_undirected;
+		std::vector<std::uint64_t> per_node_cycle;
+		std::vector<std::uint64_t> per_node_transitive;
+	};
+
+	auto brute_force(gdwg::csr_graph<int, int> const& g) -> brute_counts {
+		auto const n = g.node_count();
+		auto edge = std::vector<std::vector<bool>>(n, std::vector<bool>(n, false));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			for (auto const v : g.targets(u)) {
+				edge[u][v] = true;
+			}
+		}
+
+		auto result = brute_counts{};
+		result.per_node_undirected.resize(n);
+		result.per_node_cycle.resize(n);
+		result.per_node_transitive.resize(n);
+		for (auto a = std::size_t{0}; a < n; ++a) {
+			for (auto b = a + 1; b < n; ++b) {
+				for (auto c = b + 1; c < n; ++c) {
+					auto const t = std::vector<std::size_t>{a, b, c};
+					auto const adjacent = [&](std::size_t x, std::size_t y) {
+						return edge[x][y] or edge[y][x];
+					};
+					if (not(adjacent(a, b) and adjacent(b, c) and adjacent(a, c))) {
+						continue;
+					}
+					auto const cycles = std::uint64_t{edge[a][b] and edge[b][c] and edge[c][a]}
+					              + std::uint64_t{edge[a][c] and edge[c][b] and edge[b][a]};
+					auto transitive = std::uint64_t{0};
+					for (auto const x : t) {
+						for (auto const y : t) {
+							for (auto const z : t) {
+								if (x != y and y != z and x != z and edge[x][y] and edge[y][z] and edge[x][z]) {
+									++transitive;
+								}
+							}
+						}
+					}
+
+					++result.undirected;
+					result.cycle += cycles;
+					result.transitive += transitive;
+					for (auto const x : t) {
+						++result.per_node_undirected[x];
+						result.per_node_cycle[x] += cycles;
+						result.per_node_transitive[x] += transitive;
+					}
+				}
+			}
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("count_triangles") {
+	SECTION("Small graph") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("c", "a", 1);
+		g.insert_edge("a", "c", 2);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("d", "d", 1);
+
+		CHECK(gdwg::count_triangles(g) == 1);
+		CHECK(gdwg::count_triangles(g, {.kind = gdwg::triangle_kind::cycle}) == 1);
+		CHECK(gdwg::count_triangles(g, {.kind = gdwg::triangle_kind::transitive}) == 1);
+
+		auto const counts = gdwg::triangles_per_node(g);
+		CHECK(counts.total == 1);
+		CHECK(counts.per_node == std::vector<std::uint64_t>{1, 1, 1, 0});
+		CHECK(counts.count("d") == 0);
+		CHECK_THROWS_AS(counts.count("z"), std::runtime_error);
+	}
+
+	SECTION("Empty graph") {
+		CHECK(gdwg::count_triangles(gdwg::graph<int, int>{}) == 0);
+		CHECK(gdwg::triangles_per_node(gdwg::graph<int, int>{}).per_node.empty());
+	}
+
+	auto const g = gdwg::csr_graph<int, int>(make_graph(120, 1500));
+	auto const expected = brute_force(g);
+	REQUIRE(expected.undirected > 0);
+	REQUIRE(expected.cycle > 0);
+
+	SECTION("Totals match brute force") {
+		CHECK(gdwg::count_triangles(g) == expected.undirected);
+		CHECK(gdwg::count_triangles(g, {.kind = gdwg::triangle_kind::cycle}) == expected.cycle);
+		CHECK(gdwg::count_triangles(g, {.kind = gdwg::triangle_kind::transitive})
+		      == expected.transitive);
+	}
+
+	SECTION("Per-node counts match brute force") {
+		auto const undirected = gdwg::triangles_per_node(g);
+		CHECK(undirected.total == expected.undirected);
+		CHECK(undirected.per_node == expected.per_node_undirected);
+
+		auto const cycle = gdwg::triangles_per_node(g, {.kind = gdwg::triangle_kind::cycle});
+		CHECK(cycle.total == expected.cycle);
+		CHECK(cycle.per_node == expected.per_node_cycle);
+
+		auto const transitive =
+		   gdwg::triangles_per_node(g, {.kind = gdwg::triangle_kind::transitive});
+		CHECK(transitive.total == expected.transitive);
+		CHECK(transitive.per_node == expected.per_node_transitive);
+	}
+
+	SECTION("Parallel matches sequential") {
+		auto pool = gdwg::thread_pool(4);
+		for (auto const kind : {gdwg::triangle_kind::undirected,
+		                        gdwg::triangle_kind::cycle,
+		                        gdwg::triangle_kind::transitive})
+		{
+			auto const sequential = gdwg::triangles_per_node(g, {.kind = kind});
+			auto const parallel = gdwg::triangles_per_node(g, {.pool = &pool, .kind = kind});
+			CHECK(parallel.per_node == sequential.per_node);
+			CHECK(gdwg::count_triangles(g, {.pool = &pool, .kind = kind}) == sequential.total);
+		}
+	}
+
+	SECTION("Cliques exercise long intersections") {
+		auto clique = gdwg::graph<int, int>{};
+		auto constexpr size = 40;
+		for (auto i = 0; i < size; ++i) {
+			clique.insert_node(i);
+		}
+		for (auto i = 0; i < size; ++i) {
+			for (auto j = i + 1; j < size; ++j) {
+				clique.insert_edge(i, j, 0);
+			}
+		}
+		auto constexpr triangles = std::uint64_t{size} * (size - 1) * (size - 2) / 6;
+		CHECK(gdwg::count_triangles(clique) == triangles);
+		CHECK(gdwg::count_triangles(clique, {.kind = gdwg::triangle_kind::transitive})
+		      == triangles);
+		CHECK(gdwg::count_triangles(clique, {.kind = gdwg::triangle_kind::cycle}) == 0);
+		CHECK(gdwg::triangles_per_node(clique).count(5)
+		      == std::uint64_t{size - 1} * (size - 2) / 2);
+	}
+}
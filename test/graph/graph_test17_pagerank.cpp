@@ -0,0 +1,192 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+#include "gdwg/thread_pool.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto next = gdwg::test::lcg(11U);
+		for (auto i = 0; i < nodes; ++i) {
+			// Every seventh node is dangling
+			if (i % 7 == 3) {
+				continue;
+			}
+			for (auto d = 0; d < 1 + i % 4; ++d) {
+				g.insert_edge(i, next() % nodes, 0.5 + next() % 4);
+			}
+		}
+		return g;
+	}
+
+	/* Textbook dense power iteration to compare against */
+	auto reference(gdwg::csr_graph<int, double> const& g,
+	               std::vector<double> const& teleport,
+	               bool weighted,
+	               double damping) -> std::vector<double> {
+		auto const n = g.node_count();
+		auto rank = teleport;
+		for (auto iteration = 0; iteration < 500; ++iteration) {
+			auto next = std::vector<double>(n, 0.0);
+			auto dangling = 0.0;
+			for (auto u = gdwg::node_id{0}; u < n; ++u) {
+				auto const targets = g.targets(u);
+				auto const weights = g.weights(u);
+				auto total = 0.0;
+				for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+					total += weighted ? weights[e] : 1.0;
+				}
+				if (total == 0.0) {
+					dangling += rank[u];
+					continue;
+				}
+				for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+					next[targets[e]] += damping * rank[u] * (weighted ? weights[e] : 1.0) / total;
+				}
+			}
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				next[v] += (1.0 - damping + damping * dangling) * teleport[v];
+			}
+			rank = next;
+		}
+		return rank;
+	}
+
+	auto close(std::vector<double> const& lhs, std::vector<double> const& rhs) -> bool {
+		for (auto i = std::size_t{0}; i < lhs.size(); ++i) {
+			if (std::abs(lhs[i] - rhs[i]) > 1e-9) {
+				return false;
+			}
+		}
+		return lhs.size() == rhs.size();
+	}
+
+	auto sum(std::vector<double> const& values) -> double {
+		return std::accumulate(values.begin(), values.end(), 0.0);
+	}
+} // namespace
+
+TEST_CASE("pagerank") {
+	SECTION("Small graph") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("c", "a", 1);
+
+		auto const result = gdwg::pagerank(g);
+		CHECK(result.converged);
+		CHECK(result.iterations == result.residuals.size());
+		CHECK(result.rank_of("a") == Approx(1.0 / 3));
+		CHECK(result.rank_of("c") == Approx(1.0 / 3));
+		CHECK_THROWS_AS(result.rank_of("z"), std::runtime_error);
+	}
+
+	SECTION("Weights decide the split") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+		g.insert_edge("a", "b", 3);
+		g.insert_edge("a", "c", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("c", "a", 1);
+
+		auto const weighted = gdwg::pagerank(g);
+		CHECK(weighted.rank_of("b") > 2 * weighted.rank_of("c"));
+		auto const plain = gdwg::pagerank(g, {.weighted = false});
+		CHECK(plain.rank_of("b") == Approx(plain.rank_of("c")));
+	}
+
+	SECTION("Non-arithmetic weights split evenly") {
+		auto g = gdwg::graph<int, std::string>{1, 2, 3};
+		g.insert_edge(1, 2, "x");
+		g.insert_edge(1, 3, "yyy");
+		auto const result = gdwg::pagerank(g);
+		CHECK(result.rank_of(2) == Approx(result.rank_of(3)));
+		CHECK(sum(result.rank) == Approx(1.0));
+	}
+
+	SECTION("Invalid input throws") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -1);
+		CHECK_THROWS_AS(gdwg::pagerank(g), std::runtime_error);
+		CHECK_NOTHROW(gdwg::pagerank(g, {.weighted = false}));
+		CHECK_THROWS_AS(gdwg::pagerank(g, {.damping = 1.5, .weighted = false}), std::runtime_error);
+		CHECK_THROWS_AS(gdwg::pagerank(gdwg::csr_graph<int, int>(g)), std::runtime_error);
+		CHECK(gdwg::pagerank(gdwg::graph<int, int>{}).rank.empty());
+	}
+
+	auto constexpr nodes = 3000;
+	auto const csr = gdwg::csr_graph<int, double>(make_graph(nodes), gdwg::adjacency::in_and_out);
+	auto const uniform = std::vector<double>(nodes, 1.0 / nodes);
+
+	SECTION("Matches dense power iteration, weighted and not") {
+		auto const weighted = gdwg::pagerank(csr, {.tolerance = 1e-13, .max_iterations = 500});
+		CHECK(weighted.converged);
+		CHECK(sum(weighted.rank) == Approx(1.0));
+		CHECK(close(weighted.rank, reference(csr, uniform, true, 0.85)));
+
+		auto const plain = gdwg::pagerank(
+		   csr,
+		   {.damping = 0.7, .tolerance = 1e-13, .max_iterations = 500, .weighted = false});
+		CHECK(close(plain.rank, reference(csr, uniform, false, 0.7)));
+	}
+
+	SECTION("Residuals shrink and the cap is reported") {
+		auto const capped = gdwg::pagerank(csr, {.tolerance = 0.0, .max_iterations = 5});
+		CHECK_FALSE(capped.converged);
+		CHECK(capped.iterations == 5);
+		REQUIRE(capped.residuals.size() == 5);
+		CHECK(capped.residuals.back() < capped.residuals.front());
+	}
+
+	SECTION("Parallel gives identical ranks") {
+		auto pool = gdwg::thread_pool(4);
+		auto const sequential = gdwg::pagerank(csr);
+		auto const parallel = gdwg::pagerank(csr, {.pool = &pool});
+		CHECK(parallel.rank == sequential.rank);
+		CHECK(parallel.residuals == sequential.residuals);
+	}
+}
+
+TEST_CASE("personalized_pagerank") {
+	SECTION("Rank stays within reach of the seeds") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("c", "d", 1);
+
+		auto const result = gdwg::personalized_pagerank(g, {"a"});
+		CHECK(result.rank_of("a") + result.rank_of("b") == Approx(1.0));
+		CHECK(result.rank_of("c") == 0.0);
+		CHECK(result.rank_of("a") > result.rank_of("b"));
+		CHECK_THROWS_AS(gdwg::personalized_pagerank(g, {"z"}), std::runtime_error);
+		CHECK_THROWS_AS(gdwg::personalized_pagerank(g, {}), std::runtime_error);
+	}
+
+	SECTION("Matches dense power iteration") {
+		auto const csr = gdwg::csr_graph<int, double>(make_graph(500), gdwg::adjacency::in_and_out);
+		auto teleport = std::vector<double>(500, 0.0);
+		teleport[3] = 0.5;
+		teleport[40] = 0.25;
+		teleport[41] = 0.25;
+
+		auto pool = gdwg::thread_pool(2);
+		auto const result = gdwg::personalized_pagerank(
+		   csr,
+		   {3, 40, 3, 41},
+		   {.pool = &pool, .tolerance = 1e-13, .max_iterations = 500});
+		CHECK(result.converged);
+		CHECK(close(result.rank, reference(csr, teleport, true, 0.85)));
+	}
+}
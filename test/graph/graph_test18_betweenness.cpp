@@ -0,0 +1,204 @@
+#include "gdwg/betweenness.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes, int max_weight) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto next = gdwg::test::lcg(23U);
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < 1 + i % 3; ++d) {
+				g.insert_edge(i, next() % nodes, 1 + next() % max_weight);
+			}
+		}
+		// A parallel edge and a self loop, neither of which adds paths
+		g.insert_edge(0, 1, 1);
+		g.insert_edge(0, 1, 2);
+		g.insert_edge(2, 2, 1);
+		return g;
+	}
+
+	/* Counts every pair's shortest paths by Floyd-Warshall, then adds up the fraction through
+	 * each middle node */
+	auto reference(gdwg::csr_graph<int, int> const& g, bool weighted) -> std::vector<double> {
+		auto const n = g.node_count();
+		auto constexpr unreached = std::numeric_limits<long>::max() / 4;
+		auto distance = std::vector<std::vector<long>>(n, std::vector<long>(n, unreached));
+		auto paths = std::vector<std::vector<double>>(n, std::vector<double>(n, 0.0));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			distance[u][u] = 0;
+			paths[u][u] = 1.0;
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				auto const v = targets[e];
+				auto const w = weighted ? long{weights[e]} : 1L;
+				if (v != u and w < distance[u][v]) {
+					distance[u][v] = w;
+					paths[u][v] = 1.0;
+				}
+			}
+		}
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					if (i == k or j == k or i == j) {
+						continue;
+					}
+					auto const through = distance[i][k] + distance[k][j];
+					if (through < distance[i][j]) {
+						distance[i][j] = through;
+						paths[i][j] = paths[i][k] * paths[k][j];
+					}
+					else if (through == distance[i][j] and through < unreached) {
+						paths[i][j] += paths[i][k] * paths[k][j];
+					}
+				}
+			}
+		}
+
+		auto centrality = std::vector<double>(n, 0.0);
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			for (auto t = std::size_t{0}; t < n; ++t) {
+				if (s == t or distance[s][t] >= unreached) {
+					continue;
+				}
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (v != s and v != t and distance[s][v] + distance[v][t] == distance[s][t]) {
+						centrality[v] += paths[s][v] * paths[v][t] / paths[s][t];
+					}
+				}
+			}
+		}
+		return centrality;
+	}
+
+	auto close(std::vector<double> const& lhs, std::vector<double> const& rhs) -> bool {
+		for (auto i = std::size_t{0}; i < lhs.size(); ++i) {
+			if (std::abs(lhs[i] - rhs[i]) > 1e-9 * std::max(1.0, std::abs(rhs[i]))) {
+				return false;
+			}
+		}
+		return lhs.size() == rhs.size();
+	}
+} // namespace
+
+TEST_CASE("betweenness_centrality") {
+	SECTION("Small graph") {
+		// Two equally short routes from a to d, and a longer one through e
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("a", "c", 1);
+		g.insert_edge("b", "d", 1);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("a", "e", 1);
+		g.insert_edge("e", "d", 5);
+
+		auto const plain = gdwg::betweenness_centrality(g, {.weighted = false});
+		CHECK(plain.exact());
+		CHECK(plain.centrality_of("b") == Approx(1.0 / 3));
+		CHECK(plain.centrality_of("e") == Approx(1.0 / 3));
+		CHECK(plain.centrality_of("a") == 0.0);
+		CHECK_THROWS_AS(plain.centrality_of("z"), std::runtime_error);
+
+		auto const weighted = gdwg::betweenness_centrality(g);
+		CHECK(weighted.centrality_of("b") == Approx(0.5));
+		CHECK(weighted.centrality_of("e") == 0.0);
+
+		auto const normalized = gdwg::betweenness_centrality(g, {.normalized = true});
+		CHECK(normalized.centrality_of("b") == Approx(0.5 / 12));
+	}
+
+	SECTION("Non-arithmetic weights count hops") {
+		auto g = gdwg::graph<int, std::string>{1, 2, 3};
+		g.insert_edge(1, 2, "x");
+		g.insert_edge(2, 3, "y");
+		CHECK(gdwg::betweenness_centrality(g).centrality_of(2) == 1.0);
+	}
+
+	SECTION("Invalid input throws") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, 0);
+		CHECK_THROWS_AS(gdwg::betweenness_centrality(g), std::runtime_error);
+		CHECK_NOTHROW(gdwg::betweenness_centrality(g, {.weighted = false}));
+		CHECK(gdwg::betweenness_centrality(gdwg::graph<int, int>{}).centrality.empty());
+
+		// Self loops are ignored, whatever their weight
+		auto looped = gdwg::graph<int, int>{1, 2, 3};
+		looped.insert_edge(1, 2, 1);
+		looped.insert_edge(2, 3, 1);
+		looped.insert_edge(2, 2, 0);
+		looped.insert_edge(3, 3, -4);
+		CHECK(gdwg::betweenness_centrality(looped).centrality_of(2) == 1.0);
+	}
+
+	auto const csr = gdwg::csr_graph<int, int>(make_graph(150, 4));
+
+	SECTION("Matches brute force, weighted and not") {
+		CHECK(close(gdwg::betweenness_centrality(csr).centrality, reference(csr, true)));
+		CHECK(close(gdwg::betweenness_centrality(csr, {.weighted = false}).centrality,
+		            reference(csr, false)));
+	}
+
+	SECTION("Parallel matches sequential") {
+		auto pool = gdwg::thread_pool(4);
+		auto const sequential = gdwg::betweenness_centrality(csr);
+		auto const parallel = gdwg::betweenness_centrality(csr, {.pool = &pool});
+		CHECK(close(parallel.centrality, sequential.centrality));
+		CHECK(parallel.sources == sequential.sources);
+	}
+
+	SECTION("Sampling is repeatable and scaled") {
+		auto pool = gdwg::thread_pool(3);
+		auto const first = gdwg::betweenness_centrality(csr, {.samples = 40, .seed = 7});
+		auto const again = gdwg::betweenness_centrality(csr, {.pool = &pool, .samples = 40, .seed = 7});
+		CHECK_FALSE(first.exact());
+		CHECK(first.sources.size() == 40);
+		CHECK(std::is_sorted(first.sources.begin(), first.sources.end()));
+		CHECK(std::adjacent_find(first.sources.begin(), first.sources.end()) == first.sources.end());
+		CHECK(again.sources == first.sources);
+		CHECK(close(again.centrality, first.centrality));
+
+		auto const other = gdwg::betweenness_centrality(csr, {.samples = 40, .seed = 8});
+		CHECK(other.sources != first.sources);
+
+		// Searching every source once is the exact result
+		CHECK(gdwg::betweenness_centrality(csr, {.samples = 150}).exact());
+	}
+
+	SECTION("Sampled estimates track the exact ranking") {
+		auto const exact = gdwg::betweenness_centrality(csr);
+		auto const estimate = gdwg::betweenness_centrality(csr, {.samples = 100, .seed = 1});
+		auto exact_total = 0.0;
+		auto estimate_total = 0.0;
+		for (auto v = std::size_t{0}; v < exact.centrality.size(); ++v) {
+			exact_total += exact.centrality[v];
+			estimate_total += estimate.centrality[v];
+		}
+		CHECK(estimate_total == Approx(exact_total).epsilon(0.2));
+
+		auto const top = static_cast<std::size_t>(std::distance(
+		   exact.centrality.begin(),
+		   std::max_element(exact.centrality.begin(), exact.centrality.end())));
+		auto const above = std::count_if(estimate.centrality.begin(),
+		                                 estimate.centrality.end(),
+		                                 [&](double c) { return c > estimate.centrality[top]; });
+		CHECK(above < 5);
+	}
+}
@@ -0,0 +1,195 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes, int degree, unsigned seed) -> gdwg::graph<int, std::int64_t> {
+		auto g = gdwg::graph<int, std::int64_t>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto next = gdwg::test::lcg(seed);
+		for (auto i = 0; i < nodes * degree; ++i) {
+			g.insert_edge(next() % nodes, next() % nodes, next() % 20);
+		}
+		return g;
+	}
+
+	/* Edmonds-Karp over a dense capacity matrix to compare against */
+	auto reference(gdwg::csr_graph<int, std::int64_t> const& g, gdwg::node_id s, gdwg::node_id t)
+	   -> std::int64_t {
+		auto const n = g.node_count();
+		auto capacity = std::vector<std::vector<std::int64_t>>(n, std::vector<std::int64_t>(n, 0));
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			auto const targets = g.targets(u);
+			auto const weights = g.weights(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				if (targets[e] != u) {
+					capacity[u][targets[e]] += weights[e];
+				}
+			}
+		}
+
+		auto total = std::int64_t{0};
+		while (true) {
+			auto parent = std::vector<std::size_t>(n, n);
+			parent[s] = s;
+			auto queue = std::vector<std::size_t>{s};
+			for (auto i = std::size_t{0}; i < queue.size() and parent[t] == n; ++i) {
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (parent[v] == n and capacity[queue[i]][v] > 0) {
+						parent[v] = queue[i];
+						queue.push_back(v);
+					}
+				}
+			}
+			if (parent[t] == n) {
+				return total;
+			}
+
+			auto bottleneck = std::numeric_limits<std::int64_t>::max();
+			for (auto v = std::size_t{t}; v != s; v = parent[v]) {
+				bottleneck = std::min(bottleneck, capacity[parent[v]][v]);
+			}
+			for (auto v = std::size_t{t}; v != s; v = parent[v]) {
+				capacity[parent[v]][v] -= bottleneck;
+				capacity[v][parent[v]] += bottleneck;
+			}
+			total += bottleneck;
+		}
+	}
+
+	/* Every edge within capacity, and flow conserved everywhere but the terminals */
+	auto check_flow(gdwg::csr_graph<int, std::int64_t> const& g,
+	                gdwg::flow_result<int, std::int64_t> const& result,
+	                gdwg::node_id s,
+	                gdwg::node_id t) -> void {
+		auto const n = g.node_count();
+		REQUIRE(result.flow.size() == g.edge_count());
+		auto balance = std::vector<std::int64_t>(n, 0);
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			for (auto e = g.offsets()[u]; e < g.offsets()[u + 1]; ++e) {
+				auto const f = result.flow[e];
+				CHECK(f >= 0);
+				CHECK(f <= g.weights()[e]);
+				balance[u] -= f;
+				balance[g.targets()[e]] += f;
+			}
+		}
+		for (auto v = gdwg::node_id{0}; v < n; ++v) {
+			if (v == s) {
+				CHECK(balance[v] == -result.value);
+			}
+			else if (v == t) {
+				CHECK(balance[v] == result.value);
+			}
+			else {
+				CHECK(balance[v] == 0);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("max_flow") {
+	SECTION("Small network") {
+		auto g = gdwg::graph<std::string, std::int64_t>{"s", "a", "b", "t"};
+		g.insert_edge("s", "a", 3);
+		g.insert_edge("s", "b", 2);
+		g.insert_edge("a", "b", 5);
+		g.insert_edge("a", "t", 2);
+		g.insert_edge("b", "t", 3);
+
+		auto const result = gdwg::max_flow(g, std::string("s"), std::string("t"));
+		CHECK(result.value == 5);
+		CHECK(result.on_source_side("s"));
+		CHECK_FALSE(result.on_source_side("t"));
+		CHECK_THROWS_AS(result.on_source_side("z"), std::runtime_error);
+	}
+
+	SECTION("Parallel edges add up and fill in order") {
+		auto g = gdwg::graph<int, std::int64_t>{1, 2, 3};
+		g.insert_edge(1, 2, 4);
+		g.insert_edge(1, 2, 6);
+		g.insert_edge(1, 1, 9);
+		g.insert_edge(2, 3, 7);
+
+		auto const result = gdwg::max_flow(g, 1, 3);
+		CHECK(result.value == 7);
+		// Edge order: 1 -> 1, 1 -> 2 (4), 1 -> 2 (6), 2 -> 3
+		CHECK(result.flow == std::vector<std::int64_t>{0, 4, 3, 7});
+	}
+
+	SECTION("Floating-point capacities") {
+		auto g = gdwg::graph<int, double>{1, 2, 3, 4};
+		g.insert_edge(1, 2, 1.5);
+		g.insert_edge(1, 3, 0.25);
+		g.insert_edge(2, 4, 1.0);
+		g.insert_edge(3, 4, 2.0);
+		CHECK(gdwg::max_flow(g, 1, 4).value == Approx(1.25));
+	}
+
+	SECTION("Invalid input throws") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		CHECK(gdwg::max_flow(g, 1, 2).value == 0);
+		CHECK_THROWS_AS(gdwg::max_flow(g, 1, 1), std::runtime_error);
+		CHECK_THROWS_AS(gdwg::max_flow(g, 1, 5), std::runtime_error);
+		g.insert_edge(1, 2, -1);
+		CHECK_THROWS_AS(gdwg::max_flow(g, 1, 2), std::runtime_error);
+	}
+
+	SECTION("Random networks match Edmonds-Karp") {
+		for (auto seed = 1U; seed <= 6; ++seed) {
+			auto const csr = gdwg::csr_graph<int, std::int64_t>(make_graph(120, 1 + seed % 4, seed));
+			for (auto const& [s, t] : {std::pair{0, 119}, std::pair{7, 3}, std::pair{50, 51}}) {
+				auto const result = gdwg::max_flow(csr, s, t);
+				CHECK(result.value == reference(csr, csr.find(s), csr.find(t)));
+				check_flow(csr, result, csr.find(s), csr.find(t));
+			}
+		}
+	}
+}
+
+TEST_CASE("min_cut") {
+	SECTION("Cut edges are saturated and add up to the flow") {
+		for (auto seed = 1U; seed <= 4; ++seed) {
+			auto const csr = gdwg::csr_graph<int, std::int64_t>(make_graph(200, 3, seed + 10));
+			auto const cut = gdwg::min_cut(csr, 0, 199);
+			auto const flow = gdwg::max_flow(csr, 0, 199);
+			CHECK(cut.value == flow.value);
+			CHECK(cut.source_side == flow.source_side);
+			CHECK(cut.source_side[csr.find(0)]);
+			CHECK_FALSE(cut.source_side[csr.find(199)]);
+
+			auto total = std::int64_t{0};
+			for (auto const& e : cut.edges) {
+				CHECK(cut.source_side[csr.find(e.from)]);
+				CHECK_FALSE(cut.source_side[csr.find(e.to)]);
+				total += e.weight;
+			}
+			CHECK(total == cut.value);
+		}
+	}
+
+	SECTION("Bottleneck edge") {
+		auto g = gdwg::graph<std::string, int>{"s", "a", "b", "t"};
+		g.insert_edge("s", "a", 10);
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "t", 10);
+		auto const cut = gdwg::min_cut(g, std::string("s"), std::string("t"));
+		CHECK(cut.value == 1);
+		REQUIRE(cut.edges.size() == 1);
+		CHECK(cut.edges[0].from == "a");
+		CHECK(cut.edges[0].to == "b");
+	}
+}
@@ -0,0 +1,203 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/random_walk.hpp"
+#include "gdwg/thread_pool.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto next = gdwg::test::lcg(31U);
+		for (auto i = 0; i < nodes; ++i) {
+			// Every eleventh node is a dead end
+			if (i % 11 == 5) {
+				continue;
+			}
+			for (auto d = 0; d < 1 + i % 5; ++d) {
+				g.insert_edge(i, next() % nodes, 0.5 + next() % 3);
+			}
+		}
+		return g;
+	}
+
+	auto collect(gdwg::random_walker<int, double> const& walker, gdwg::walk_options const& options)
+	   -> std::vector<std::vector<gdwg::node_id>> {
+		auto walks = std::vector<std::vector<gdwg::node_id>>();
+		auto const count = walker.generate(options, [&](std::span<gdwg::node_id const> walk) {
+			walks.emplace_back(walk.begin(), walk.end());
+		});
+		CHECK(count == walks.size());
+		return walks;
+	}
+
+	/* Fraction of one-step walks from start that land on each node */
+	auto first_steps(gdwg::random_walker<int, double> const& walker, int start, int samples)
+	   -> std::vector<double> {
+		auto counts = std::vector<double>(walker.snapshot().node_count(), 0.0);
+		for (auto i = 0; i < samples; ++i) {
+			auto const walk = walker.walk(start, {.length = 2, .seed = 5}, static_cast<std::uint64_t>(i));
+			counts[static_cast<std::size_t>(walk.back())] += 1.0 / samples;
+		}
+		return counts;
+	}
+} // namespace
+
+TEST_CASE("random_walker") {
+	SECTION("Weighted successors follow the weights") {
+		auto g = gdwg::graph<int, double>{0, 1, 2, 3, 4};
+		g.insert_edge(0, 1, 1.0);
+		g.insert_edge(0, 2, 2.0);
+		g.insert_edge(0, 3, 3.0);
+		g.insert_edge(0, 4, 4.0);
+		// Parallel edges add up
+		g.insert_edge(0, 4, 0.0);
+
+		auto const walker = gdwg::random_walker<int, double>(g);
+		auto const weighted = first_steps(walker, 0, 40000);
+		for (auto v = 1; v <= 4; ++v) {
+			CHECK(weighted[static_cast<std::size_t>(v)] == Approx(v / 10.0).margin(0.01));
+		}
+
+		auto const plain = first_steps(gdwg::random_walker<int, double>(g, {.weighted = false}), 0, 40000);
+		CHECK(plain[4] == Approx(0.4).margin(0.01));
+		CHECK(plain[1] == Approx(0.2).margin(0.01));
+	}
+
+	SECTION("Walks follow edges and stop at dead ends") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "c", 1);
+		auto const walker = gdwg::random_walker<std::string, int>(g);
+		CHECK(walker.walk("a") == std::vector<std::string>{"a", "b", "c"});
+		CHECK(walker.walk("a", {.length = 2}) == std::vector<std::string>{"a", "b"});
+		CHECK(walker.walk("a", {.length = 0}).empty());
+		CHECK_THROWS_AS(walker.walk("z"), std::runtime_error);
+
+		g.insert_edge("c", "a", 0);
+		CHECK(gdwg::random_walker<std::string, int>(g).walk("a", {.length = 6}).size() == 3);
+		CHECK(gdwg::random_walker<std::string, int>(g, {.weighted = false}).walk("a", {.length = 6}).size()
+		      == 6);
+	}
+
+	SECTION("Non-arithmetic weights walk uniformly") {
+		auto g = gdwg::graph<int, std::string>{1, 2};
+		g.insert_edge(1, 2, "x");
+		g.insert_edge(2, 1, "y");
+		CHECK(gdwg::random_walker<int, std::string>(g).walk(1, {.length = 4}) == std::vector<int>{1, 2, 1, 2});
+	}
+
+	SECTION("Invalid input throws") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -1);
+		CHECK_THROWS_AS((gdwg::random_walker<int, int>(g)), std::runtime_error);
+		auto const walker = gdwg::random_walker<int, int>(g, {.weighted = false});
+		CHECK_THROWS_AS(walker.walk(1, {.p = 0.0}), std::runtime_error);
+		CHECK_THROWS_AS(walker.generate({.q = -1.0}, [](auto) {}), std::runtime_error);
+	}
+
+	SECTION("node2vec return bias") {
+		// From 2 after coming from 1, the walk returns to 1 or moves on to 3
+		auto g = gdwg::graph<int, double>{1, 2, 3};
+		g.insert_edge(1, 2, 1.0);
+		g.insert_edge(2, 1, 1.0);
+		g.insert_edge(2, 3, 1.0);
+		auto const walker = gdwg::random_walker<int, double>(g);
+
+		auto const returns = [&](double p, double q) {
+			auto count = 0;
+			for (auto i = 0; i < 20000; ++i) {
+				auto const walk = walker.walk(1, {.length = 3, .p = p, .q = q}, static_cast<std::uint64_t>(i));
+				count += walk.back() == 1 ? 1 : 0;
+			}
+			return count / 20000.0;
+		};
+		CHECK(returns(1.0, 1.0) == Approx(0.5).margin(0.015));
+		CHECK(returns(0.25, 1.0) == Approx(0.8).margin(0.015));
+		CHECK(returns(1.0, 0.5) == Approx(1.0 / 3).margin(0.015));
+		CHECK(returns(1e9, 1.0) == 0.0);
+	}
+
+	SECTION("node2vec in-out bias prefers neighbours of the previous node") {
+		// After 0 -> 1, node 2 is next to 0 and node 3 isn't
+		auto g = gdwg::graph<int, double>{0, 1, 2, 3};
+		g.insert_edge(0, 1, 1.0);
+		g.insert_edge(0, 2, 1.0);
+		g.insert_edge(1, 2, 1.0);
+		g.insert_edge(1, 3, 1.0);
+		auto const walker = gdwg::random_walker<int, double>(g);
+		auto stayed = 0;
+		for (auto i = 0; i < 20000; ++i) {
+			auto const walk = walker.walk(0, {.length = 3, .q = 4.0}, static_cast<std::uint64_t>(i));
+			if (walk.size() == 3 and walk[1] == 1) {
+				stayed += walk[2] == 2 ? 1 : 0;
+			}
+		}
+		auto via_one = 0;
+		for (auto i = 0; i < 20000; ++i) {
+			via_one += walker.walk(0, {.length = 3, .q = 4.0}, static_cast<std::uint64_t>(i))[1] == 1 ? 1 : 0;
+		}
+		CHECK(static_cast<double>(stayed) / via_one == Approx(0.8).margin(0.02));
+	}
+
+	auto const walker = gdwg::random_walker<int, double>(make_graph(500));
+	auto const& csr = walker.snapshot();
+
+	SECTION("Generated walks are valid and ordered") {
+		auto const walks =
+		   collect(walker, {.length = 12, .walks_per_node = 3, .p = 0.5, .q = 2.0, .batch = 77});
+		REQUIRE(walks.size() == 1500);
+		for (auto i = std::size_t{0}; i < walks.size(); ++i) {
+			auto const& walk = walks[i];
+			REQUIRE(not walk.empty());
+			CHECK(walk.size() <= 12);
+			CHECK(walk.front() == i % 500);
+			for (auto s = std::size_t{1}; s < walk.size(); ++s) {
+				auto const targets = csr.targets(walk[s - 1]);
+				CHECK(std::binary_search(targets.begin(), targets.end(), walk[s]));
+			}
+			if (walk.size() < 12) {
+				CHECK(csr.out_degree(walk.back()) == 0);
+			}
+		}
+	}
+
+	SECTION("Output depends only on the seed") {
+		auto pool = gdwg::thread_pool(4);
+		auto const options = gdwg::walk_options{.length = 20, .walks_per_node = 2, .q = 0.5, .seed = 9};
+		auto const sequential = collect(walker, options);
+
+		auto parallel_options = options;
+		parallel_options.pool = &pool;
+		parallel_options.batch = 100;
+		CHECK(collect(walker, parallel_options) == sequential);
+
+		auto reseeded = options;
+		reseeded.seed = 10;
+		CHECK(collect(walker, reseeded) != sequential);
+
+		auto const single = walker.walk(csr.node(7), options, 500 + 7);
+		REQUIRE(single.size() == sequential[507].size());
+		for (auto s = std::size_t{0}; s < single.size(); ++s) {
+			CHECK(single[s] == csr.node(sequential[507][s]));
+		}
+	}
+
+	SECTION("Parallel alias tables walk the same") {
+		auto pool = gdwg::thread_pool(3);
+		auto const built = gdwg::random_walker<int, double>(csr, {.pool = &pool});
+		auto const options = gdwg::walk_options{.length = 10, .walks_per_node = 1};
+		CHECK(collect(built, options) == collect(walker, options));
+	}
+}
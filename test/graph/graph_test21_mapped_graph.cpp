@@ -0,0 +1,184 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i * 3);
+		}
+
+		auto next = gdwg::test::lcg(41U);
+		for (auto i = 0; i < nodes * 4; ++i) {
+			g.insert_edge(next() % nodes * 3, next() % nodes * 3, next() % 7 * 0.5);
+		}
+		return g;
+	}
+
+	template<typename N, typename E>
+	auto same_rows(gdwg::csr_graph<N, E> const& csr, gdwg::mapped_graph<N, E> const& mapped) -> void {
+		REQUIRE(mapped.node_count() == csr.node_count());
+		REQUIRE(mapped.edge_count() == csr.edge_count());
+		for (auto id = gdwg::node_id{0}; id < csr.node_count(); ++id) {
+			CHECK(mapped.node(id) == csr.node(id));
+			CHECK(mapped.find(csr.node(id)) == id);
+			auto const expected = csr.targets(id);
+			auto const actual = mapped.targets(id);
+			CHECK(std::vector<gdwg::node_id>(actual.begin(), actual.end())
+			      == std::vector<gdwg::node_id>(expected.begin(), expected.end()));
+		}
+		for (auto e = std::size_t{0}; e < csr.edge_count(); ++e) {
+			CHECK(mapped.weight(e) == csr.weights()[e]);
+		}
+	}
+} // namespace
+
+TEST_CASE("mapped_graph") {
+	SECTION("Round trip of trivially copyable types") {
+		auto const file = gdwg::test::temporary_file("test21_numbers.bin");
+		auto const g = make_graph(300);
+		gdwg::save_binary(g, file.path);
+
+		auto const mapped = gdwg::mapped_graph<int, double>(file.path);
+		same_rows(gdwg::csr_graph<int, double>(g), mapped);
+		CHECK(mapped.verify());
+		CHECK(mapped.to_graph() == g);
+		CHECK(mapped.mapped_bytes() == std::filesystem::file_size(file.path));
+
+		CHECK(mapped.is_node(3));
+		CHECK_FALSE(mapped.is_node(4));
+		CHECK(mapped.find(4) == gdwg::no_node);
+		CHECK(mapped.find(-1) == gdwg::no_node);
+		CHECK(mapped.find(300 * 3) == gdwg::no_node);
+		CHECK_THROWS_AS(mapped.is_connected(0, 4), std::runtime_error);
+
+		auto const row = mapped.weights(0);
+		CHECK(row.size() == mapped.out_degree(0));
+		CHECK(row.data() == &mapped.weight(mapped.offsets()[0]));
+	}
+
+	SECTION("Serialized node and weight types") {
+		auto const file = gdwg::test::temporary_file("test21_strings.bin");
+		auto g = gdwg::graph<std::string, std::string>{"a", "bb", "ccc", ""};
+		g.insert_edge("a", "bb", "x");
+		g.insert_edge("a", "bb", "");
+		g.insert_edge("ccc", "a", "weight");
+		g.insert_edge("", "", "loop");
+		gdwg::save_binary(g, file.path);
+
+		auto const mapped = gdwg::mapped_graph<std::string, std::string>(file.path);
+		same_rows(gdwg::csr_graph<std::string, std::string>(g), mapped);
+		CHECK(mapped.verify());
+		CHECK(mapped.is_connected("ccc", "a"));
+		CHECK_FALSE(mapped.is_connected("a", "ccc"));
+		CHECK_FALSE(mapped.is_node("dd"));
+		CHECK(mapped.to_graph() == g);
+	}
+
+	SECTION("Empty graphs") {
+		auto const file = gdwg::test::temporary_file("test21_empty.bin");
+		gdwg::save_binary(gdwg::graph<int, int>{}, file.path);
+		auto const mapped = gdwg::mapped_graph<int, int>(file.path);
+		CHECK(mapped.empty());
+		CHECK(mapped.edge_count() == 0);
+		CHECK(mapped.find(1) == gdwg::no_node);
+		CHECK(mapped.verify());
+
+		gdwg::save_binary(gdwg::graph<int, int>{1, 2}, file.path);
+		auto const edgeless = gdwg::mapped_graph<int, int>(file.path);
+		CHECK(edgeless.node_count() == 2);
+		CHECK(edgeless.targets(1).empty());
+	}
+
+	SECTION("Bad files throw") {
+		auto const file = gdwg::test::temporary_file("test21_bad.bin");
+		CHECK_THROWS_AS((gdwg::mapped_graph<int, int>(file.path)), std::runtime_error);
+
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 5);
+		gdwg::save_binary(g, file.path);
+		CHECK_NOTHROW(gdwg::mapped_graph<int, int>(file.path));
+		CHECK_THROWS_AS((gdwg::mapped_graph<int, double>(file.path)), std::runtime_error);
+		CHECK_THROWS_AS((gdwg::mapped_graph<std::string, int>(file.path)), std::runtime_error);
+
+		// Edge counts whose byte sizes wrap around to something that fits
+		for (auto const forged : {std::uint64_t{1} << 62U, ~std::uint64_t{0}}) {
+			gdwg::save_binary(g, file.path);
+			{
+				auto os = std::fstream(file.path, std::ios::binary | std::ios::in | std::ios::out);
+				os.seekp(static_cast<std::streamoff>(offsetof(gdwg::binary_header, edge_count)));
+				os.write(reinterpret_cast<char const*>(&forged), sizeof(forged));
+			}
+			CHECK_THROWS_AS((gdwg::mapped_graph<int, int>(file.path)), std::runtime_error);
+		}
+
+		// A serialized column whose last index entry wraps past its end
+		auto strings = gdwg::graph<std::string, int>{"a", "b"};
+		gdwg::save_binary(strings, file.path);
+		{
+			auto header = gdwg::binary_header{};
+			auto os = std::fstream(file.path, std::ios::binary | std::ios::in | std::ios::out);
+			os.read(reinterpret_cast<char*>(&header), sizeof(header));
+			auto const forged = ~std::uint64_t{0};
+			os.seekp(static_cast<std::streamoff>(header.node_index + 2 * sizeof(std::uint64_t)));
+			os.write(reinterpret_cast<char const*>(&forged), sizeof(forged));
+		}
+		CHECK_THROWS_AS((gdwg::mapped_graph<std::string, int>(file.path)), std::runtime_error);
+
+		gdwg::save_binary(g, file.path);
+		auto const size = std::filesystem::file_size(file.path);
+		std::filesystem::resize_file(file.path, size - 1);
+		CHECK_THROWS_AS((gdwg::mapped_graph<int, int>(file.path)), std::runtime_error);
+
+		{
+			auto os = std::ofstream(file.path, std::ios::binary | std::ios::trunc);
+			os << "not a graph at all, just some text that is long enough to hold a header, "
+			      "as long as it keeps going for a while";
+		}
+		CHECK_THROWS_AS((gdwg::mapped_graph<int, int>(file.path)), std::runtime_error);
+	}
+
+	SECTION("verify catches corrupt rows") {
+		auto const file = gdwg::test::temporary_file("test21_corrupt.bin");
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 3, 1);
+		g.insert_edge(1, 2, 1);
+		gdwg::save_binary(g, file.path);
+		CHECK(gdwg::mapped_graph<int, int>(file.path).verify());
+
+		// Swap the two targets of node 1 so its row is out of order
+		auto header = gdwg::binary_header{};
+		{
+			auto is = std::ifstream(file.path, std::ios::binary);
+			is.read(reinterpret_cast<char*>(&header), sizeof(header));
+		}
+		auto targets = std::vector<gdwg::node_id>{2, 1};
+		{
+			auto os = std::fstream(file.path, std::ios::binary | std::ios::in | std::ios::out);
+			os.seekp(static_cast<std::streamoff>(header.targets));
+			os.write(reinterpret_cast<char const*>(targets.data()), sizeof(gdwg::node_id) * 2);
+		}
+		CHECK_FALSE(gdwg::mapped_graph<int, int>(file.path).verify());
+
+		// A row that ends past the last edge is rejected before it is read
+		gdwg::save_binary(g, file.path);
+		{
+			auto const forged = std::uint64_t{1} << 40U;
+			auto os = std::fstream(file.path, std::ios::binary | std::ios::in | std::ios::out);
+			os.seekp(static_cast<std::streamoff>(header.offsets + sizeof(std::uint64_t)));
+			os.write(reinterpret_cast<char const*>(&forged), sizeof(forged));
+		}
+		CHECK_FALSE(gdwg::mapped_graph<int, int>(file.path).verify());
+	}
+}
@@ -0,0 +1,217 @@
+#include "gdwg/edge_list.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <compare>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+	/* A node type read through a text_parser specialisation */
+	struct cell {
+		int row = 0;
+		int column = 0;
+
+		auto operator<=>(cell const&) const = default;
+	};
+} // namespace
+
+template<>
+struct gdwg::text_parser<cell> {
+	static auto parse(std::string_view field) -> std::optional<cell> {
+		auto const colon = field.find(':');
+		if (colon == field.npos) {
+			return std::nullopt;
+		}
+		auto const row = text_parser<int>::parse(field.substr(0, colon));
+		auto const column = text_parser<int>::parse(field.substr(colon + 1));
+		if (not row or not column) {
+			return std::nullopt;
+		}
+		return cell{*row, *column};
+	}
+};
+
+namespace {
+	auto make_text(int lines) -> std::string {
+		auto text = std::string("# generated\n");
+		auto next = gdwg::test::lcg(47U);
+		for (auto i = 0; i < lines; ++i) {
+			if (i % 97 == 0) {
+				text += "broken line " + std::to_string(i) + "\n";
+				continue;
+			}
+			text += std::to_string(next() % 500) + "\t" + std::to_string(next() % 500) + "  "
+			        + std::to_string(next() % 9) + (i % 5 == 0 ? "\r\n" : "\n");
+		}
+		return text;
+	}
+
+	/* The same edges inserted one by one, and where the broken lines are */
+	auto reference(std::string const& text)
+	   -> std::pair<gdwg::graph<int, int>, std::vector<std::size_t>> {
+		auto g = gdwg::graph<int, int>{};
+		auto broken = std::vector<std::size_t>();
+		auto is = std::istringstream(text);
+		auto line = std::string();
+		for (auto number = std::size_t{1}; std::getline(is, line); ++number) {
+			if (line.rfind("broken", 0) == 0) {
+				broken.push_back(number);
+				continue;
+			}
+			auto fields = std::istringstream(line);
+			auto src = 0;
+			auto dst = 0;
+			auto weight = 0;
+			if (fields >> src >> dst >> weight) {
+				g.insert_node(src);
+				g.insert_node(dst);
+				g.insert_edge(src, dst, weight);
+			}
+		}
+		return {g, broken};
+	}
+} // namespace
+
+TEST_CASE("parse_edge_list") {
+	SECTION("Whitespace edge list") {
+		auto const result = gdwg::parse_edge_list<std::string, double>("a b 1.5\n"
+		                                                               "\n"
+		                                                               "  # comment\n"
+		                                                               "b\tc   -2\n"
+		                                                               "a b 1.5\n"
+		                                                               "c a +3e2");
+		CHECK(result.lines == 6);
+		CHECK(result.edges == 4);
+		CHECK(result.malformed == 0);
+
+		auto expected = gdwg::graph<std::string, double>{"a", "b", "c"};
+		expected.insert_edge("a", "b", 1.5);
+		expected.insert_edge("b", "c", -2);
+		expected.insert_edge("c", "a", 300);
+		CHECK(result.g == expected);
+	}
+
+	SECTION("CSV with a header and quotes") {
+		auto const result = gdwg::parse_edge_list<std::string, int>(
+		   "from,to,weight\r\n"
+		   "\"Sydney, NSW\",Perth,3290\r\n"
+		   " \"say \"\"hi\"\"\" , Perth , 7\r\n"
+		   "Perth,\"\",1\r\n",
+		   {.format = gdwg::edge_list_format::csv, .header = true});
+		CHECK(result.malformed == 0);
+		CHECK(result.g.is_connected("Sydney, NSW", "Perth"));
+		CHECK(result.g.is_connected("say \"hi\"", "Perth"));
+		CHECK(result.g.is_connected("Perth", ""));
+		CHECK_FALSE(result.g.is_node("from"));
+	}
+
+	SECTION("Quoted TSV") {
+		auto const result = gdwg::parse_edge_list<std::string, int>("\"a\"\t\"b\"\t1\n"
+		                                                            " \"b c\" \t\"a\"\t2\n"
+		                                                            "c\t\t3\n",
+		                                                            {.format = gdwg::edge_list_format::csv,
+		                                                             .delimiter = '\t'});
+		CHECK(result.malformed == 0);
+		CHECK(result.edges == 3);
+		CHECK(result.g.is_connected("a", "b"));
+		CHECK(result.g.is_connected("b c", "a"));
+		CHECK(result.g.is_connected("c", ""));
+	}
+
+	SECTION("Malformed lines are reported and skipped") {
+		auto const result = gdwg::parse_edge_list<int, int>("1 2 3\n"
+		                                                    "1 2\n"
+		                                                    "1 2 3 4\n"
+		                                                    "x 2 3\n"
+		                                                    "1 y 3\n"
+		                                                    "1 2 3.5\n"
+		                                                    "2 1 1\n",
+		                                                    {.max_errors = 4});
+		CHECK(result.edges == 2);
+		CHECK(result.malformed == 5);
+		REQUIRE(result.errors.size() == 4);
+		CHECK(result.errors[0].line == 2);
+		CHECK(result.errors[0].reason == "expected 3 fields");
+		CHECK(result.errors[1].line == 3);
+		CHECK(result.errors[2].reason == "bad source");
+		CHECK(result.errors[3].reason == "bad destination");
+		CHECK(result.errors[3].text == "1 y 3");
+	}
+
+	SECTION("CSV errors") {
+		auto const result = gdwg::parse_edge_list<std::string, int>("a,b\n"
+		                                                            "\"a,b,1\n"
+		                                                            "\"a\"x,b,1\n"
+		                                                            "a,b,\n",
+		                                                            {.format = gdwg::edge_list_format::csv});
+		REQUIRE(result.errors.size() == 4);
+		CHECK(result.errors[0].reason == "expected 3 fields");
+		CHECK(result.errors[1].reason == "unterminated quote");
+		CHECK(result.errors[2].reason == "text after a closing quote");
+		CHECK(result.errors[3].reason == "bad weight");
+	}
+
+	SECTION("Strict mode throws with the line number") {
+		auto const text = std::string("1 2 3\n2 3 4\noops\n4 5 6\n");
+		auto const options = gdwg::edge_list_options{.strict = true, .chunk_bytes = 4};
+		CHECK_THROWS_WITH((gdwg::parse_edge_list<int, int>(text, options)), Catch::Contains("line 3"));
+		CHECK_THROWS_WITH((gdwg::parse_edge_list<int, int>(text, options)),
+		                  Catch::StartsWith("Cannot call gdwg::parse_edge_list"));
+	}
+
+	SECTION("Custom parsers") {
+		auto const result = gdwg::parse_edge_list<cell, int>("0:0 0:1 5\n0:1 1:1 2\n1:1 x 1\n");
+		CHECK(result.malformed == 1);
+		CHECK(result.g.is_connected(cell{0, 0}, cell{0, 1}));
+		CHECK(result.g.weights(cell{0, 1}, cell{1, 1}) == std::vector<int>{2});
+	}
+
+	SECTION("Chunked and parallel parsing match one by one inserts") {
+		auto const text = make_text(5000);
+		auto const [expected, broken] = reference(text);
+		auto pool = gdwg::thread_pool(3);
+		for (auto const chunk : {std::size_t{1}, std::size_t{100}, std::size_t{1} << 20U}) {
+			auto const result =
+			   gdwg::parse_edge_list<int, int>(text, {.pool = &pool, .max_errors = 1000, .chunk_bytes = chunk});
+			CHECK(result.g == expected);
+			CHECK(result.lines == 5001);
+			REQUIRE(result.errors.size() == broken.size());
+			for (auto i = std::size_t{0}; i < broken.size(); ++i) {
+				CHECK(result.errors[i].line == broken[i]);
+			}
+		}
+	}
+}
+
+TEST_CASE("load_edge_list") {
+	auto const file = gdwg::test::temporary_file("test22_edges.txt");
+	auto const& path = file.path;
+	auto const text = make_text(2000);
+	{
+		auto os = std::ofstream(path, std::ios::binary);
+		os << text;
+	}
+
+	auto const result = gdwg::load_edge_list<int, int>(path, {.chunk_bytes = 1000});
+	CHECK(result.g == reference(text).first);
+	{
+		auto os = std::ofstream(path, std::ios::binary | std::ios::app);
+		os << "oops\n";
+	}
+	CHECK_THROWS_WITH((gdwg::load_edge_list<int, int>(path, {.strict = true})),
+	                  Catch::StartsWith("Cannot call gdwg::load_edge_list"));
+	std::filesystem::remove(path);
+
+	CHECK_THROWS_AS((gdwg::load_edge_list<int, int>(path)), std::runtime_error);
+}
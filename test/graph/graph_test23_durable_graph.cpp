@@ -0,0 +1,327 @@
+#include "gdwg/durable_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/graph_delta.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if GDWG_HAS_MMAP
+#include <sys/resource.h>
+#endif
+
+namespace {
+	auto files(std::filesystem::path const& directory) -> std::vector<std::string> {
+		auto names = std::vector<std::string>();
+		for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+			names.push_back(entry.path().filename().string());
+		}
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	/* Runs every kind of modifier on both graphs */
+	auto edit(gdwg::durable_graph<std::string, int>& durable, gdwg::graph<std::string, int>& plain) -> void {
+		auto const both = [&](auto const& f) {
+			f(durable);
+			f(plain);
+		};
+		both([](auto& g) {
+			g.insert_node("a");
+			g.insert_node("b");
+			g.insert_node("");
+			auto const more = std::vector<std::string>{"c", "d", "e", "a"};
+			g.insert_nodes(more.begin(), more.end());
+			g.insert_edge("a", "b", 1);
+			g.insert_edge("a", "b", 2);
+			g.insert_edge("", "a", 3);
+			auto const edges = std::vector<gdwg::graph<std::string, int>::value_type>{
+			   {"c", "d", 4},
+			   {"d", "e", 5},
+			   {"e", "c", 6},
+			   {"a", "e", 7},
+			};
+			g.insert_edges(edges.begin(), edges.end());
+			g.replace_node("b", "bee");
+			g.merge_replace_node("d", "c");
+			g.erase_node("e");
+			g.erase_edge("a", "bee", 2);
+			g.insert_edge("c", "c", 8);
+
+			auto const gone_edges = std::vector<gdwg::graph<std::string, int>::value_type>{
+			   {"", "a", 3},
+			   {"a", "c", 100},
+			   {"", "a", 3},
+			};
+			g.erase_edges(gone_edges.begin(), gone_edges.end());
+			g.insert_nodes(more.begin(), more.end());
+			g.insert_edge("e", "a", 9);
+			auto const gone_nodes = std::vector<std::string>{"", "e", "zed", "e"};
+			g.erase_nodes(gone_nodes.begin(), gone_nodes.end());
+		});
+		durable.erase_edge(durable.get().find("a", "bee", 1));
+		plain.erase_edge(plain.find("a", "bee", 1));
+	}
+} // namespace
+
+TEST_CASE("durable_graph") {
+	SECTION("Reopening replays the log") {
+		auto const dir = gdwg::test::temporary_directory("test23_replay");
+		auto expected = gdwg::graph<std::string, int>{};
+		{
+			auto g = gdwg::durable_graph<std::string, int>(dir.path, {.sync = false});
+			edit(g, expected);
+			CHECK(g.get() == expected);
+
+			// Edits that change nothing aren't logged
+			auto const pending = g.pending_records();
+			CHECK_FALSE(g.insert_node("a"));
+			CHECK_FALSE(g.erase_edge("a", "bee", 100));
+			auto const absent = std::vector<std::string>{"zed"};
+			CHECK(g.erase_nodes(absent.begin(), absent.end()) == 0);
+			auto const unknown = std::vector<gdwg::graph<std::string, int>::value_type>{{"zed", "a", 1}};
+			CHECK_THROWS_AS(g.erase_edges(unknown.begin(), unknown.end()), std::runtime_error);
+			CHECK(g.erase_edge(g.get().end()) == g.get().end());
+			CHECK(g.erase_edge(gdwg::graph<std::string, int>::iterator{}) == g.get().end());
+			CHECK(g.pending_records() == pending);
+		}
+
+		auto const g = gdwg::durable_graph<std::string, int>(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.recovery().checkpoint == 0);
+		CHECK(g.recovery().records == 18);
+		CHECK(g.recovery().truncated_bytes == 0);
+	}
+
+	SECTION("A delta applied with the bulk modifiers replays") {
+		auto const dir = gdwg::test::temporary_directory("test23_delta");
+		auto before = gdwg::graph<std::string, int>{};
+		auto after = gdwg::graph<std::string, int>{};
+		{
+			auto g = gdwg::durable_graph<std::string, int>(dir.path, {.sync = false});
+			edit(g, before);
+			after = before;
+			after.erase_node("a");
+			after.insert_node("f");
+			after.insert_edge("f", "c", 10);
+			after.erase_edge("c", "c", 8);
+
+			// The steps patch takes, through the durable graph's own modifiers
+			auto const delta = gdwg::diff(before, after);
+			g.erase_edges(delta.erased_edges.begin(), delta.erased_edges.end());
+			g.erase_nodes(delta.erased_nodes.begin(), delta.erased_nodes.end());
+			g.insert_nodes(delta.inserted_nodes.begin(), delta.inserted_nodes.end());
+			g.insert_edges(delta.inserted_edges.begin(), delta.inserted_edges.end());
+			CHECK(g.get() == after);
+		}
+
+		auto const g = gdwg::durable_graph<std::string, int>(dir.path);
+		CHECK(g.get() == after);
+		CHECK(g.recovery().records == 22);
+	}
+
+	SECTION("Records are written a group at a time") {
+		auto const dir = gdwg::test::temporary_directory("test23_group");
+		auto g = gdwg::durable_graph<int, int>(dir.path, {.group_records = 3, .sync = false});
+		g.insert_node(1);
+		g.insert_node(2);
+		CHECK(g.pending_records() == 2);
+		CHECK(g.wal_bytes() == 0);
+		g.insert_edge(1, 2, 3);
+		CHECK(g.pending_records() == 0);
+		auto const written = g.wal_bytes();
+		CHECK(written == std::filesystem::file_size(dir.path / "wal-0.log"));
+
+		g.clear();
+		g.commit();
+		CHECK(g.wal_bytes() > written);
+	}
+
+	SECTION("Recovery starts from the newest checkpoint") {
+		auto const dir = gdwg::test::temporary_directory("test23_checkpoint");
+		auto expected = gdwg::graph<std::string, int>{};
+		{
+			auto g = gdwg::durable_graph<std::string, int>(dir.path, {.sync = false});
+			edit(g, expected);
+			g.checkpoint();
+			CHECK(g.generation() == 1);
+			CHECK(g.wal_bytes() == 0);
+			CHECK(files(dir.path) == std::vector<std::string>{"checkpoint-1.gdwg", "wal-1.log"});
+
+			g.insert_edge("a", "a", 9);
+			expected.insert_edge("a", "a", 9);
+		}
+
+		// A snapshot that was never renamed into place is ignored
+		std::ofstream(dir.path / "checkpoint-2.gdwg.tmp") << "partial";
+
+		auto const g = gdwg::durable_graph<std::string, int>(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.recovery().checkpoint == 1);
+		CHECK(g.recovery().records == 1);
+		CHECK(files(dir.path) == std::vector<std::string>{"checkpoint-1.gdwg", "wal-1.log"});
+	}
+
+	SECTION("A checkpoint that can't be written in full keeps the old state") {
+		if (not std::filesystem::exists("/dev/full")) {
+			return;
+		}
+		auto const dir = gdwg::test::temporary_directory("test23_full");
+		auto expected = gdwg::graph<std::string, int>{};
+		{
+			auto g = gdwg::durable_graph<std::string, int>(dir.path, {.sync = false});
+			edit(g, expected);
+			g.commit();
+
+			// The snapshot is small enough to sit in the stream's buffer until it is closed, and
+			// every write to /dev/full fails with ENOSPC
+			std::filesystem::create_symlink("/dev/full", dir.path / "checkpoint-1.gdwg.tmp");
+			CHECK_THROWS_AS(g.checkpoint(), std::runtime_error);
+			CHECK(g.generation() == 0);
+			CHECK(files(dir.path) == std::vector<std::string>{"wal-0.log"});
+
+			g.insert_edge("a", "a", 9);
+			expected.insert_edge("a", "a", 9);
+		}
+		auto const g = gdwg::durable_graph<std::string, int>(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.recovery().checkpoint == 0);
+	}
+
+	SECTION("A snapshot that can't be renamed into place keeps the buffered records") {
+		auto const dir = gdwg::test::temporary_directory("test23_rename");
+		auto expected = gdwg::graph<std::string, int>{};
+		{
+			auto g = gdwg::durable_graph<std::string, int>(dir.path, {.sync = false});
+			edit(g, expected);
+			auto const pending = g.pending_records();
+			REQUIRE(pending != 0);
+
+			// A non-empty directory where the snapshot should go makes the rename fail
+			std::filesystem::create_directories(dir.path / "checkpoint-1.gdwg" / "in-the-way");
+			CHECK_THROWS(g.checkpoint());
+			CHECK(g.generation() == 0);
+			CHECK(g.pending_records() == pending);
+			CHECK_FALSE(std::filesystem::exists(dir.path / "checkpoint-1.gdwg.tmp"));
+
+			std::filesystem::remove_all(dir.path / "checkpoint-1.gdwg");
+			g.commit();
+		}
+		auto const g = gdwg::durable_graph<std::string, int>(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.recovery().checkpoint == 0);
+	}
+
+#if GDWG_HAS_MMAP
+	SECTION("A group that is only partly written is cut off and written again") {
+		// 5 tears the first record's header; 17 ends the first record, so a retried group would
+		// replay replace_node twice
+		for (auto const tear : {std::uintmax_t{5}, std::uintmax_t{17}}) {
+			auto const dir = gdwg::test::temporary_directory("test23_short");
+			auto expected = gdwg::graph<int, int>{};
+			{
+				auto g = gdwg::durable_graph<int, int>(dir.path, {.sync = false});
+				g.insert_node(1);
+				g.insert_node(2);
+				g.commit();
+				auto const committed = g.wal_bytes();
+				g.replace_node(2, 3);
+				g.insert_edge(1, 3, 5);
+				expected = g.get();
+				auto const pending = g.pending_records();
+
+				// Writes past the file size limit fail with EFBIG once the bytes under it are in
+				auto const handler = std::signal(SIGXFSZ, SIG_IGN);
+				auto limit = ::rlimit{};
+				REQUIRE(::getrlimit(RLIMIT_FSIZE, &limit) == 0);
+				auto lowered = limit;
+				lowered.rlim_cur = static_cast<rlim_t>(committed + tear);
+				REQUIRE(::setrlimit(RLIMIT_FSIZE, &lowered) == 0);
+				CHECK_THROWS_AS(g.commit(), std::runtime_error);
+				REQUIRE(::setrlimit(RLIMIT_FSIZE, &limit) == 0);
+				std::signal(SIGXFSZ, handler);
+
+				CHECK(std::filesystem::file_size(dir.path / "wal-0.log") == committed);
+				CHECK(g.wal_bytes() == committed);
+				CHECK(g.pending_records() == pending);
+				g.commit();
+			}
+			auto const g = gdwg::durable_graph<int, int>(dir.path);
+			CHECK(g.get() == expected);
+			CHECK(g.recovery().records == 4);
+			CHECK(g.recovery().truncated_bytes == 0);
+		}
+	}
+#endif
+
+	SECTION("Checkpoints happen when the log grows") {
+		auto const dir = gdwg::test::temporary_directory("test23_automatic");
+		auto expected = gdwg::graph<int, int>{};
+		{
+			auto g = gdwg::durable_graph<int, int>(dir.path,
+			                                       {.group_records = 10, .sync = false, .checkpoint_bytes = 1000});
+			for (auto i = 0; i < 500; ++i) {
+				g.insert_node(i);
+				expected.insert_node(i);
+				if (i != 0) {
+					g.insert_edge(i - 1, i, i);
+					expected.insert_edge(i - 1, i, i);
+				}
+			}
+			CHECK(g.generation() > 10);
+			CHECK(g.wal_bytes() < 1000);
+		}
+		auto const g = gdwg::durable_graph<int, int>(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(files(dir.path).size() == 2);
+	}
+
+	SECTION("A torn tail is cut off") {
+		auto const dir = gdwg::test::temporary_directory("test23_torn");
+		auto expected = gdwg::graph<int, int>{};
+		{
+			auto g = gdwg::durable_graph<int, int>(dir.path, {.sync = false});
+			g.insert_node(1);
+			g.insert_node(2);
+			g.insert_edge(1, 2, 5);
+			g.commit();
+			expected = g.get();
+			g.insert_edge(2, 1, 6);
+		}
+
+		// Lose half of the last record, as a crash during the write would
+		auto const log = dir.path / "wal-0.log";
+		auto const size = std::filesystem::file_size(log);
+		std::filesystem::resize_file(log, size - 5);
+		{
+			auto g = gdwg::durable_graph<int, int>(dir.path);
+			CHECK(g.get() == expected);
+			CHECK(g.recovery().records == 3);
+			CHECK(g.recovery().truncated_bytes > 0);
+			CHECK(g.wal_bytes() < size - 5);
+
+			// Appending after the cut works
+			g.insert_edge(2, 2, 7);
+			expected.insert_edge(2, 2, 7);
+		}
+
+		// Corrupt bytes inside a record are caught by its checksum
+		{
+			auto os = std::fstream(log, std::ios::binary | std::ios::in | std::ios::out);
+			os.seekp(-1, std::ios::end);
+			os.put('\x7f');
+		}
+		expected.erase_edge(2, 2, 7);
+		auto const g = gdwg::durable_graph<int, int>(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.recovery().records == 3);
+	}
+}
@@ -0,0 +1,162 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "gdwg/paged_graph.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		// Every third node is left without out-edges
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i * 2);
+		}
+
+		auto next = gdwg::test::lcg(29U);
+		for (auto i = 0; i < nodes * 6; ++i) {
+			auto const src = next() % nodes;
+			if (src % 3 != 0) {
+				g.insert_edge(src * 2, next() % nodes * 2, next() % 4 * 0.5);
+			}
+		}
+		return g;
+	}
+
+	template<typename Graph>
+	auto all_edges(Graph const& g) {
+		auto edges = std::vector<std::tuple<int, int, double>>();
+		for (auto const& [from, to, weight] : g) {
+			edges.emplace_back(from, to, weight);
+		}
+		return edges;
+	}
+} // namespace
+
+TEST_CASE("paged_graph") {
+	SECTION("Accessors match the graph it was saved from") {
+		auto const file = gdwg::test::temporary_file("test24_numbers.bin");
+		auto const g = make_graph(2000);
+		gdwg::save_binary(g, file.path);
+
+		// One page per segment and two segments cached, so nearly every row crosses a boundary
+		auto const paged =
+		   gdwg::paged_graph<int, double>(file.path, {.segment_bytes = 1, .cache_segments = 2});
+		CHECK(paged.node_count() == 2000);
+		CHECK(paged.nodes() == g.nodes());
+		CHECK(all_edges(paged) == all_edges(g));
+
+		for (auto const n : {0, 2, 4, 1998}) {
+			CHECK(paged.is_node(n));
+			CHECK(paged.connections(n) == g.connections(n));
+			for (auto const m : {0, 6, 1000, 3998}) {
+				CHECK(paged.is_connected(n, m) == g.is_connected(n, m));
+				CHECK(paged.weights(n, m) == g.weights(n, m));
+			}
+		}
+		CHECK_FALSE(paged.is_node(1));
+		CHECK_FALSE(paged.is_node(-2));
+		CHECK_FALSE(paged.is_node(4000));
+		CHECK_THROWS_AS(paged.connections(1), std::runtime_error);
+		CHECK_THROWS_AS(paged.weights(0, 1), std::runtime_error);
+		CHECK_THROWS_AS(paged.is_connected(1, 0), std::runtime_error);
+
+		auto const [from, to, weight] = *g.begin();
+		auto const it = paged.find(from, to, weight);
+		REQUIRE(it != paged.end());
+		CHECK((*it).to == to);
+		CHECK(paged.find(from, to, weight + 0.25) == paged.end());
+		CHECK(paged.find(1, to, weight) == paged.end());
+	}
+
+	SECTION("Iteration runs both ways") {
+		auto const file = gdwg::test::temporary_file("test24_reverse.bin");
+		auto const g = make_graph(300);
+		gdwg::save_binary(g, file.path);
+		auto const paged = gdwg::paged_graph<int, double>(file.path);
+
+		auto forward = all_edges(paged);
+		auto backward = std::vector<std::tuple<int, int, double>>();
+		for (auto it = paged.end(); it != paged.begin();) {
+			auto const [from, to, weight] = *--it;
+			backward.emplace_back(from, to, weight);
+		}
+		std::reverse(backward.begin(), backward.end());
+		CHECK(backward == forward);
+		CHECK(std::distance(paged.begin(), paged.end()) == static_cast<std::ptrdiff_t>(paged.edge_count()));
+	}
+
+	SECTION("The cache is bounded and counted") {
+		auto const file = gdwg::test::temporary_file("test24_cache.bin");
+		gdwg::save_binary(make_graph(4000), file.path);
+		auto const pages = (std::filesystem::file_size(file.path) + 4095) / 4096;
+
+		auto const paged =
+		   gdwg::paged_graph<int, double>(file.path, {.segment_bytes = 4096, .cache_segments = 8});
+		paged.reset_io_stats();
+		auto count = std::size_t{0};
+		for (auto const& e : paged) {
+			count += e.weight >= 0 ? 1 : 0;
+		}
+		CHECK(count == paged.edge_count());
+
+		auto const& stats = paged.io_stats();
+		CHECK(stats.misses >= pages / 2);
+		CHECK(stats.evictions > 0);
+		CHECK(stats.hits > stats.misses * 10);
+		CHECK(stats.bytes_mapped <= stats.misses * 4096);
+
+		// The four column streams plus the node values fit, so a scan maps each segment about once
+		CHECK(stats.misses < pages * 2);
+
+		paged.reset_io_stats();
+		CHECK(paged.io_stats().misses == 0);
+		CHECK(paged.is_node(2));
+		CHECK(paged.io_stats().hits + paged.io_stats().misses > 0);
+	}
+
+	SECTION("Serialized values and empty graphs") {
+		auto const file = gdwg::test::temporary_file("test24_strings.bin");
+		auto g = gdwg::graph<std::string, std::string>{"a", "bb", "ccc", ""};
+		g.insert_edge("a", "bb", "x");
+		g.insert_edge("a", "bb", "");
+		g.insert_edge("ccc", "a", std::string(10000, 'w'));
+		g.insert_edge("", "", "loop");
+		gdwg::save_binary(g, file.path);
+
+		auto const paged = gdwg::paged_graph<std::string, std::string>(file.path, {.segment_bytes = 4096});
+		CHECK(paged.nodes() == g.nodes());
+		CHECK(paged.weights("a", "bb") == g.weights("a", "bb"));
+		CHECK(paged.weights("ccc", "a") == g.weights("ccc", "a"));
+		CHECK(paged.connections("") == std::vector<std::string>{""});
+		CHECK(paged.find("a", "bb", "") != paged.end());
+
+		gdwg::save_binary(gdwg::graph<std::string, std::string>{}, file.path);
+		auto const empty = gdwg::paged_graph<std::string, std::string>(file.path);
+		CHECK(empty.empty());
+		CHECK(empty.begin() == empty.end());
+		CHECK_FALSE(empty.is_node("a"));
+	}
+
+	SECTION("Bad files throw") {
+		auto const file = gdwg::test::temporary_file("test24_bad.bin");
+		CHECK_THROWS_AS((gdwg::paged_graph<int, int>(file.path)), std::runtime_error);
+
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 5);
+		gdwg::save_binary(g, file.path);
+		CHECK_NOTHROW(gdwg::paged_graph<int, int>(file.path));
+		CHECK_THROWS_AS((gdwg::paged_graph<int, double>(file.path)), std::runtime_error);
+
+		std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 1);
+		CHECK_THROWS_AS((gdwg::paged_graph<int, int>(file.path)), std::runtime_error);
+	}
+}
@@ -0,0 +1,165 @@
+#include "gdwg/compressed_graph.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	/* Rows with degrees that aren't multiples of four, parallel edges, self loops, targets either
+	 * side of the source and gaps needing every byte length */
+	auto make_graph(int nodes) -> gdwg::graph<int, double> {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+
+		auto next = gdwg::test::lcg(31U);
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < i % 11; ++d) {
+				auto const near = (i + next() % 20 - 10 + nodes) % nodes;
+				g.insert_edge(i, d % 3 == 0 ? next() % nodes : near, next() % 100 * 0.125 - 3);
+			}
+			if (i % 5 == 0) {
+				g.insert_edge(i, i, 1.5);
+				g.insert_edge(i, i, 2.5);
+			}
+		}
+		return g;
+	}
+
+	template<typename N, typename E>
+	auto same_rows(gdwg::csr_graph<N, E> const& csr, gdwg::compressed_graph<N, E> const& compressed) -> void {
+		REQUIRE(compressed.node_count() == csr.node_count());
+		REQUIRE(compressed.edge_count() == csr.edge_count());
+		for (auto id = gdwg::node_id{0}; id < csr.node_count(); ++id) {
+			auto const expected = csr.targets(id);
+			CHECK(compressed.out_degree(id) == expected.size());
+			CHECK(compressed.targets(id) == std::vector<gdwg::node_id>(expected.begin(), expected.end()));
+		}
+	}
+} // namespace
+
+TEST_CASE("compressed_graph") {
+	SECTION("Rows and weights match the snapshot") {
+		auto const g = make_graph(30000);
+		auto const csr = gdwg::csr_graph<int, double>(g);
+		auto const compressed = gdwg::compressed_graph<int, double>(csr);
+		same_rows(csr, compressed);
+
+		CHECK_FALSE(compressed.weights_quantised());
+		CHECK(compressed.max_weight_error() == 0);
+		auto edges = std::size_t{0};
+		for (auto id = gdwg::node_id{0}; id < compressed.node_count(); ++id) {
+			auto e = csr.offsets()[id];
+			compressed.for_each_edge(id, [&](gdwg::node_id dst, double weight) {
+				CHECK(dst == csr.targets()[e]);
+				CHECK(weight == csr.weights()[e]);
+				++e;
+				++edges;
+			});
+		}
+		CHECK(edges == csr.edge_count());
+
+		CHECK(compressed.find(29999) == 29999);
+		CHECK(compressed.find(30000) == gdwg::no_node);
+		CHECK(compressed.node(7) == 7);
+
+		// Mostly one-byte gaps against csr_graph's four, and half the offset bytes per row
+		auto const csr_bytes = static_cast<double>(csr.edge_count() * (sizeof(gdwg::node_id) + sizeof(double))
+		                                           + csr.offsets().size_bytes());
+		CHECK(compressed.bytes_per_edge() < 0.85 * csr_bytes / static_cast<double>(csr.edge_count()));
+	}
+
+	SECTION("Ids far apart and the largest gaps") {
+		auto g = gdwg::graph<long, int>{};
+		auto const values = std::vector<long>{0, 1, 2, 3, 4};
+		g.insert_nodes(values.begin(), values.end());
+		for (auto src = 0L; src < 5; ++src) {
+			for (auto dst = 0L; dst < 5; ++dst) {
+				g.insert_edge(src, dst, static_cast<int>(src * 5 + dst));
+			}
+		}
+		auto const csr = gdwg::csr_graph<long, int>(g);
+		same_rows(csr, gdwg::compressed_graph<long, int>(csr));
+
+		for (auto const& [from, to] : {std::pair<gdwg::node_id, gdwg::node_id>{0, 0xffffffffU},
+		                               {0xffffffffU, 0},
+		                               {5, 3},
+		                               {0x80000000U, 0x7fffffffU},
+		                               {0x7fffffffU, 0x80000000U}})
+		{
+			CHECK(gdwg::detail::unzigzag_gap(from, gdwg::detail::zigzag_gap(from, to)) == to);
+		}
+		CHECK(gdwg::detail::zigzag_gap(5, 4) == 1);
+		CHECK(gdwg::detail::zigzag_gap(5, 6) == 2);
+	}
+
+	SECTION("Quantised weights") {
+		auto const g = make_graph(3000);
+		auto const csr = gdwg::csr_graph<int, double>(g);
+		for (auto const bits : {8U, 16U}) {
+			auto const compressed = gdwg::compressed_graph<int, double>(csr, {.weight_bits = bits});
+			same_rows(csr, compressed);
+			CHECK(compressed.weights_quantised());
+			CHECK(compressed.max_weight_error() > 0);
+			for (auto e = std::size_t{0}; e < csr.edge_count(); ++e) {
+				CHECK(std::abs(compressed.weight(e) - csr.weights()[e])
+				      <= compressed.max_weight_error() * (1 + 1e-9));
+			}
+			// Codes replace the 8-byte doubles one for one
+			auto const exact = gdwg::compressed_graph<int, double>(csr).bytes_per_edge();
+			CHECK(compressed.bytes_per_edge() == Approx(exact - 8 + bits / 8));
+		}
+
+		// Integers with a small range are exact even in 8 bits
+		auto small = gdwg::graph<int, int>{1, 2, 3};
+		small.insert_edge(1, 2, -100);
+		small.insert_edge(1, 3, 154);
+		small.insert_edge(3, 3, 0);
+		auto const quantised = gdwg::compressed_graph<int, int>(small, {.weight_bits = 8});
+		CHECK(quantised.max_weight_error() == 0);
+		CHECK(quantised.weight(0) == -100);
+		CHECK(quantised.weight(1) == 154);
+		CHECK(quantised.weight(2) == 0);
+
+		CHECK_THROWS_AS((gdwg::compressed_graph<int, int>(small, {.weight_bits = 4})), std::runtime_error);
+
+		// A range just past 8 bits is rounded twice, once to a code and again on decode, which
+		// takes some weights more than half a step away
+		auto wide = gdwg::graph<int, int>{};
+		for (auto i = 0; i <= 300; ++i) {
+			wide.insert_node(i);
+			wide.insert_edge(0, i, i);
+		}
+		auto const wide_csr = gdwg::csr_graph<int, int>(wide);
+		auto const rounded = gdwg::compressed_graph<int, int>(wide_csr, {.weight_bits = 8});
+		CHECK(rounded.max_weight_error() == Approx(300.0 / 255 / 2 + 0.5));
+		for (auto e = std::size_t{0}; e < wide_csr.edge_count(); ++e) {
+			CHECK(std::abs(rounded.weight(e) - wide_csr.weights()[e]) <= rounded.max_weight_error());
+		}
+		auto strings = gdwg::graph<int, std::string>{1};
+		strings.insert_edge(1, 1, "w");
+		CHECK_THROWS_AS((gdwg::compressed_graph<int, std::string>(strings, {.weight_bits = 8})),
+		                std::runtime_error);
+		CHECK(gdwg::compressed_graph<int, std::string>(strings).weight(0) == "w");
+	}
+
+	SECTION("Empty graphs") {
+		auto const none = gdwg::compressed_graph<int, int>(gdwg::graph<int, int>{});
+		CHECK(none.empty());
+		CHECK(none.find(1) == gdwg::no_node);
+		CHECK(none.bytes_per_edge() == 0);
+
+		auto const edgeless = gdwg::compressed_graph<int, int>(gdwg::graph<int, int>{1, 2}, {.weight_bits = 8});
+		CHECK(edgeless.node_count() == 2);
+		CHECK(edgeless.targets(1).empty());
+		CHECK_FALSE(edgeless.weights_quantised());
+	}
+}
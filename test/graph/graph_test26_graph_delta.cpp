@@ -0,0 +1,163 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/graph_delta.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph(int nodes, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		auto next = gdwg::test::lcg(seed);
+		for (auto i = 0; i < nodes * 5; ++i) {
+			g.insert_edge(next() % nodes, next() % nodes, next() % 3);
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("diff and patch") {
+	SECTION("Equal graphs have an empty delta") {
+		auto const g = make_graph(200, 3);
+		CHECK(gdwg::diff(g, g).empty());
+		CHECK(gdwg::diff(gdwg::graph<int, int>{}, gdwg::graph<int, int>{}).empty());
+	}
+
+	SECTION("Small changes give a small delta") {
+		auto const a = make_graph(2000, 5);
+		auto b = a;
+		b.erase_node(7);
+		b.erase_node(1999);
+		b.insert_node(5000);
+		b.insert_node(-1);
+		b.insert_edge(5000, -1, 9);
+		b.insert_edge(0, 5000, 9);
+		b.replace_node(10, 4000);
+		auto const to = a.connections(20).front();
+		auto const from = 20;
+		auto const weight = a.weights(from, to).front();
+		b.erase_edge(from, to, weight);
+		b.insert_edge(from, to, weight + 100);
+
+		auto const delta = gdwg::diff(a, b);
+		CHECK(delta.erased_nodes == std::vector<int>{7, 10, 1999});
+		CHECK(delta.inserted_nodes == std::vector<int>{-1, 4000, 5000});
+		REQUIRE(delta.erased_edges.size() == 1);
+		CHECK(delta.erased_edges[0].from == from);
+		CHECK(delta.erased_edges[0].weight == weight);
+
+		// The renamed node's edges come back; the erased nodes' edges are implied
+		CHECK(delta.inserted_edges.size() >= 3 + a.connections(10).size());
+		CHECK(delta.size() < 40);
+
+		auto patched = a;
+		gdwg::patch(patched, delta);
+		CHECK(patched == b);
+
+		auto reverse = b;
+		gdwg::patch(reverse, gdwg::diff(b, a));
+		CHECK(reverse == a);
+	}
+
+	SECTION("Unrelated graphs") {
+		auto const a = make_graph(300, 7);
+		auto const b = make_graph(250, 11);
+		auto patched = a;
+		gdwg::patch(patched, gdwg::diff(a, b));
+		CHECK(patched == b);
+
+		auto emptied = a;
+		gdwg::patch(emptied, gdwg::diff(a, gdwg::graph<int, int>{}));
+		CHECK(emptied.empty());
+	}
+
+	SECTION("Edits that don't fit are skipped") {
+		auto a = gdwg::graph<std::string, int>{"a", "b"};
+		a.insert_edge("a", "b", 1);
+		auto b = gdwg::graph<std::string, int>{"a", "c"};
+		b.insert_edge("a", "c", 2);
+		auto const delta = gdwg::diff(a, b);
+
+		// Already patched: erasures find nothing and inserts are duplicates
+		auto twice = b;
+		gdwg::patch(twice, delta);
+		CHECK(twice == b);
+
+		auto other = gdwg::graph<std::string, int>{"x"};
+		CHECK_THROWS_AS(gdwg::patch(other, delta), std::runtime_error);
+	}
+
+	SECTION("Topological order is kept") {
+		auto a = gdwg::graph<int, int>{1, 2, 3};
+		a.insert_edge(1, 2, 0);
+		a.enable_topological_order();
+		auto b = gdwg::graph<int, int>{1, 3, 4};
+		b.insert_edge(4, 1, 0);
+		b.insert_edge(3, 4, 0);
+		gdwg::patch(a, gdwg::diff(a, b));
+		CHECK(a == b);
+		CHECK(a.topological_order() == std::vector<int>{3, 4, 1});
+	}
+}
+
+TEST_CASE("Delta serialization") {
+	SECTION("Round trip") {
+		auto a = gdwg::graph<std::string, std::string>{"a", "b", "c", ""};
+		a.insert_edge("a", "b", "x");
+		a.insert_edge("c", "c", "y");
+		auto b = gdwg::graph<std::string, std::string>{"a", "b", "d", ""};
+		b.insert_edge("a", "b", "x");
+		b.insert_edge("a", "b", "z");
+		b.insert_edge("a", "d", "w");
+		b.insert_edge("", "a", "");
+
+		auto os = std::ostringstream();
+		gdwg::write_delta(os, gdwg::diff(a, b));
+		auto is = std::istringstream(os.str());
+		auto const delta = gdwg::read_delta<std::string, std::string>(is);
+		CHECK(delta.size() == gdwg::diff(a, b).size());
+		gdwg::patch(a, delta);
+		CHECK(a == b);
+	}
+
+	SECTION("A delta is the size of the change") {
+		auto const a = make_graph(5000, 13);
+		auto b = a;
+		b.insert_edge(1, 2, 50);
+		b.erase_node(3);
+
+		auto delta_bytes = std::ostringstream();
+		gdwg::write_delta(delta_bytes, gdwg::diff(a, b));
+		auto full_bytes = std::ostringstream();
+		gdwg::write_delta(full_bytes, gdwg::diff(gdwg::graph<int, int>{}, b));
+		CHECK(delta_bytes.str().size() < 100);
+		CHECK(full_bytes.str().size() > 100000);
+	}
+
+	SECTION("Bad input throws") {
+		auto is = std::istringstream("not a delta");
+		CHECK_THROWS_AS((gdwg::read_delta<int, int>(is)), std::runtime_error);
+
+		auto os = std::ostringstream();
+		gdwg::write_delta(os, gdwg::diff(gdwg::graph<int, int>{}, make_graph(10, 1)));
+		auto truncated = std::istringstream(os.str().substr(0, os.str().size() - 3));
+		CHECK_THROWS_AS((gdwg::read_delta<int, int>(truncated)), std::runtime_error);
+
+		// A string length far beyond what the stream holds isn't allocated up front
+		auto strings = std::ostringstream();
+		gdwg::write_delta(strings, gdwg::diff(gdwg::graph<std::string, int>{"x"}, {}));
+		auto bytes = strings.str();
+		auto const forged = std::uint64_t{1} << 40U;
+		std::memcpy(bytes.data() + 16, &forged, sizeof(forged));
+		auto long_string = std::istringstream(bytes);
+		CHECK_THROWS_AS((gdwg::read_delta<std::string, int>(long_string)), std::runtime_error);
+	}
+}
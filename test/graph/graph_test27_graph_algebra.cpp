@@ -0,0 +1,168 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/graph_algebra.hpp"
+#include "graph_test_helpers.hpp"
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	auto make_graph(int first, int last, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = first; i < last; ++i) {
+			g.insert_node(i);
+		}
+		auto next = gdwg::test::lcg(seed);
+		auto const span = last - first;
+		for (auto i = 0; i < span * 4; ++i) {
+			g.insert_edge(first + next() % span, first + next() % span, next() % 3);
+		}
+		return g;
+	}
+
+	// The same operations done element by element through the public interface
+	auto naive_union(gdwg::graph<int, int> a, gdwg::graph<int, int> const& b) -> gdwg::graph<int, int> {
+		for (auto const& n : b.nodes()) {
+			a.insert_node(n);
+		}
+		for (auto const& [from, to, weight] : b) {
+			a.insert_edge(from, to, weight);
+		}
+		return a;
+	}
+
+	auto naive_intersection(gdwg::graph<int, int> const& a, gdwg::graph<int, int> const& b)
+	   -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto const& n : a.nodes()) {
+			if (b.is_node(n)) {
+				g.insert_node(n);
+			}
+		}
+		for (auto const& [from, to, weight] : a) {
+			if (b.find(from, to, weight) != b.end()) {
+				g.insert_edge(from, to, weight);
+			}
+		}
+		return g;
+	}
+
+	auto naive_difference(gdwg::graph<int, int> a, gdwg::graph<int, int> const& b)
+	   -> gdwg::graph<int, int> {
+		for (auto const& [from, to, weight] : b) {
+			if (a.find(from, to, weight) != a.end()) {
+				a.erase_edge(from, to, weight);
+			}
+		}
+		return a;
+	}
+} // namespace
+
+TEST_CASE("Union, intersection and difference") {
+	// Overlapping node ranges, with edges drawn from the same generator over the shared part
+	auto const a = make_graph(0, 300, 3);
+	auto const b = make_graph(100, 400, 3);
+	auto const c = make_graph(0, 300, 7);
+
+	SECTION("Match element by element construction") {
+		for (auto const& [lhs, rhs] : {std::pair(&a, &b), std::pair(&b, &a), std::pair(&a, &c)}) {
+			CHECK(gdwg::graph_union(*lhs, *rhs) == naive_union(*lhs, *rhs));
+			CHECK(gdwg::graph_intersection(*lhs, *rhs) == naive_intersection(*lhs, *rhs));
+			CHECK(gdwg::graph_difference(*lhs, *rhs) == naive_difference(*lhs, *rhs));
+		}
+	}
+
+	SECTION("In place variants give the same graphs") {
+		for (auto const& [lhs, rhs] : {std::pair(&a, &b), std::pair(&b, &a), std::pair(&a, &c)}) {
+			auto g = *lhs;
+			CHECK(gdwg::graph_union(std::move(g), *rhs) == gdwg::graph_union(*lhs, *rhs));
+			g = *lhs;
+			CHECK(gdwg::graph_intersection(std::move(g), *rhs) == gdwg::graph_intersection(*lhs, *rhs));
+			g = *lhs;
+			CHECK(gdwg::graph_difference(std::move(g), *rhs) == gdwg::graph_difference(*lhs, *rhs));
+		}
+
+		auto g = a;
+		g = gdwg::graph_union(std::move(g), b);
+		CHECK(g == gdwg::graph_union(a, b));
+	}
+
+	SECTION("Set identities") {
+		CHECK(gdwg::graph_union(a, b) == gdwg::graph_union(b, a));
+		CHECK(gdwg::graph_intersection(a, b) == gdwg::graph_intersection(b, a));
+		CHECK(gdwg::graph_union(a, a) == a);
+		CHECK(gdwg::graph_intersection(a, a) == a);
+		auto const none = gdwg::graph_difference(a, a);
+		CHECK(none.nodes() == a.nodes());
+		CHECK(none.begin() == none.end());
+
+		// Difference keeps a's nodes, so its union with the intersection gives a back
+		for (auto const& rhs : {&b, &c}) {
+			auto const rebuilt =
+			   gdwg::graph_union(gdwg::graph_difference(a, *rhs), gdwg::graph_intersection(a, *rhs));
+			CHECK(rebuilt == a);
+		}
+	}
+
+	SECTION("Empty operands") {
+		auto const empty = gdwg::graph<int, int>{};
+		CHECK(gdwg::graph_union(a, empty) == a);
+		CHECK(gdwg::graph_union(empty, a) == a);
+		CHECK(gdwg::graph_intersection(a, empty).empty());
+		CHECK(gdwg::graph_difference(a, empty) == a);
+		CHECK(gdwg::graph_difference(empty, a).empty());
+
+		auto g = a;
+		CHECK(gdwg::graph_intersection(std::move(g), empty).empty());
+	}
+}
+
+TEST_CASE("Graph algebra with other types") {
+	auto a = gdwg::graph<std::string, double>{"a", "b", "c"};
+	a.insert_edge("a", "b", 1.5);
+	a.insert_edge("a", "b", 2.5);
+	a.insert_edge("c", "a", 0.5);
+	auto b = gdwg::graph<std::string, double>{"a", "b", "d"};
+	b.insert_edge("a", "b", 2.5);
+	b.insert_edge("d", "d", 1.0);
+
+	auto const both = gdwg::graph_intersection(a, b);
+	CHECK(both.nodes() == std::vector<std::string>{"a", "b"});
+	CHECK(both.weights("a", "b") == std::vector<double>{2.5});
+
+	auto const either = gdwg::graph_union(a, b);
+	CHECK(either.nodes() == std::vector<std::string>{"a", "b", "c", "d"});
+	CHECK(either.weights("a", "b") == std::vector<double>{1.5, 2.5});
+	CHECK(either.is_connected("d", "d"));
+
+	auto const only_a = gdwg::graph_difference(a, b);
+	CHECK(only_a.nodes() == a.nodes());
+	CHECK(only_a.weights("a", "b") == std::vector<double>{1.5});
+	CHECK(only_a.is_connected("c", "a"));
+}
+
+TEST_CASE("In place algebra keeps a topological order") {
+	auto a = gdwg::graph<int, int>{1, 2, 3};
+	a.insert_edge(1, 2, 0);
+	a.enable_topological_order();
+
+	auto b = gdwg::graph<int, int>{2, 3, 4};
+	b.insert_edge(2, 3, 0);
+	b.insert_edge(3, 4, 0);
+	a = gdwg::graph_union(std::move(a), b);
+	REQUIRE(a.maintains_topological_order());
+	CHECK(a.topological_order() == std::vector<int>{1, 2, 3, 4});
+
+	auto c = gdwg::graph<int, int>{2, 3, 5};
+	c.insert_edge(2, 3, 0);
+	a = gdwg::graph_intersection(std::move(a), c);
+	REQUIRE(a.maintains_topological_order());
+	CHECK(a.topological_order() == std::vector<int>{2, 3});
+
+	// A union that closes a cycle throws, as insert_edges does
+	auto cycle = gdwg::graph<int, int>{2, 3};
+	cycle.insert_edge(3, 2, 0);
+	CHECK_THROWS_AS(gdwg::graph_union(std::move(a), cycle), std::runtime_error);
+}
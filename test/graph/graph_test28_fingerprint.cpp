@@ -0,0 +1,184 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/graph_algebra.hpp"
+
+#include <catch2/catch.hpp>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+	// A graph rebuilt edge by edge from what g holds, so its fingerprint is computed afresh
+	template<typename N, typename E>
+	auto rebuilt(gdwg::graph<N, E> const& g) -> gdwg::graph<N, E> {
+		auto const nodes = g.nodes();
+		auto copy = gdwg::graph<N, E>{};
+		for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+			copy.insert_node(*it);
+		}
+		for (auto const& [from, to, weight] : g) {
+			copy.insert_edge(from, to, weight);
+		}
+		return copy;
+	}
+
+	struct no_hash {
+		int value;
+		auto operator<=>(no_hash const&) const = default;
+	};
+} // namespace
+
+TEST_CASE("Fingerprints follow every modifier") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	auto const check = [&] {
+		auto const fresh = rebuilt(g);
+		CHECK(g.fingerprint() == fresh.fingerprint());
+		CHECK(g.fingerprint().nodes == g.nodes().size());
+		CHECK(g.fingerprint().edges == static_cast<std::size_t>(std::distance(g.begin(), g.end())));
+	};
+	check();
+
+	SECTION("Inserts and erases") {
+		g.insert_node("e");
+		g.insert_node("a");
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("c", "c", 2);
+		check();
+
+		auto const nodes = std::vector<std::string>{"x", "y", "a"};
+		g.insert_nodes(nodes.begin(), nodes.end());
+		auto const edges = std::vector<gdwg::graph<std::string, int>::value_type>{
+		   {"x", "y", 3},
+		   {"y", "x", 4},
+		   {"a", "b", 1},
+		};
+		g.insert_edges(edges.begin(), edges.end());
+		check();
+
+		g.erase_edge("a", "b", 1);
+		g.erase_edge(g.find("c", "c", 2));
+		check();
+		g.erase_edge(g.begin(), g.find("y", "x", 4));
+		check();
+		g.erase_edges(edges.begin(), edges.end());
+		check();
+		g.erase_node("y");
+		check();
+		g.erase_nodes(nodes.begin(), nodes.end());
+		check();
+
+		g.clear();
+		CHECK(g.fingerprint() == gdwg::graph<std::string, int>{}.fingerprint());
+	}
+
+	SECTION("Replacing and merging nodes") {
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 2);
+		g.insert_edge("c", "a", 3);
+		g.insert_edge("c", "b", 3);
+		auto const before = g.fingerprint();
+
+		g.replace_node("a", "z");
+		check();
+		CHECK(g.fingerprint() != before);
+		g.replace_node("z", "a");
+		CHECK(g.fingerprint() == before);
+
+		// c -> a and c -> b collapse into one edge
+		g.merge_replace_node("a", "b");
+		check();
+		CHECK(g.fingerprint().edges == 3);
+	}
+
+	SECTION("Copies, moves and swaps") {
+		g.insert_edge("a", "d", 5);
+		auto copy = g;
+		CHECK(copy.fingerprint() == g.fingerprint());
+
+		auto moved = std::move(copy);
+		CHECK(moved.fingerprint() == g.fingerprint());
+		CHECK(copy.fingerprint() == gdwg::graph<std::string, int>{}.fingerprint());
+
+		auto other = gdwg::graph<std::string, int>{"q"};
+		auto const other_print = other.fingerprint();
+		other = std::move(moved);
+		CHECK(other.fingerprint() == g.fingerprint());
+		other = gdwg::graph<std::string, int>{"q"};
+		CHECK(other.fingerprint() == other_print);
+	}
+}
+
+TEST_CASE("Fingerprints identify content") {
+	SECTION("Insertion order doesn't matter") {
+		auto a = gdwg::graph<int, int>{3, 1, 2};
+		a.insert_edge(1, 2, 7);
+		a.insert_edge(2, 3, 8);
+		auto b = gdwg::graph<int, int>{2, 1, 3};
+		b.insert_edge(2, 3, 8);
+		b.insert_edge(1, 2, 7);
+		CHECK(a.fingerprint() == b.fingerprint());
+		CHECK(a == b);
+	}
+
+	SECTION("Small changes change the hash") {
+		auto base = gdwg::graph<int, int>{1, 2, 3};
+		base.insert_edge(1, 2, 7);
+		auto reversed = gdwg::graph<int, int>{1, 2, 3};
+		reversed.insert_edge(2, 1, 7);
+		auto reweighted = gdwg::graph<int, int>{1, 2, 3};
+		reweighted.insert_edge(1, 2, 8);
+		auto renamed = gdwg::graph<int, int>{1, 2, 4};
+		renamed.insert_edge(1, 2, 7);
+
+		for (auto const* other : {&reversed, &reweighted, &renamed}) {
+			CHECK(other->fingerprint().nodes == base.fingerprint().nodes);
+			CHECK(other->fingerprint().edges == base.fingerprint().edges);
+			CHECK(other->fingerprint().hash != base.fingerprint().hash);
+			CHECK(*other != base);
+		}
+	}
+
+	SECTION("Bulk construction and set algebra agree with a rebuild") {
+		auto a = gdwg::graph<int, int>{};
+		auto b = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 50; ++i) {
+			a.insert_node(i);
+			b.insert_node(i + 25);
+		}
+		for (auto i = 0; i < 200; ++i) {
+			a.insert_edge(i % 50, (i * 7) % 50, i % 3);
+			b.insert_edge(25 + (i * 3) % 50, 25 + i % 50, i % 4);
+		}
+		auto const u = gdwg::graph_union(a, b);
+		auto const n = gdwg::graph_intersection(a, b);
+		auto const d = gdwg::graph_difference(a, b);
+		CHECK(u.fingerprint() == rebuilt(u).fingerprint());
+		CHECK(n.fingerprint() == rebuilt(n).fingerprint());
+		CHECK(d.fingerprint() == rebuilt(d).fingerprint());
+		CHECK(gdwg::graph_union(b, a).fingerprint() == u.fingerprint());
+	}
+
+	SECTION("Keys a cache") {
+		auto cache = std::unordered_map<gdwg::graph_fingerprint, int>();
+		auto g = gdwg::graph<int, int>{1, 2};
+		cache[g.fingerprint()] = 1;
+		g.insert_edge(1, 2, 0);
+		cache[g.fingerprint()] = 2;
+		g.erase_edge(1, 2, 0);
+		CHECK(cache.size() == 2);
+		CHECK(cache.at(g.fingerprint()) == 1);
+		CHECK(std::hash<gdwg::graph_fingerprint>{}(g.fingerprint())
+		      != std::hash<gdwg::graph_fingerprint>{}(gdwg::graph<int, int>{}.fingerprint()));
+	}
+
+	SECTION("Types without std::hash only count") {
+		auto g = gdwg::graph<no_hash, int>{no_hash{1}, no_hash{2}};
+		g.insert_edge(no_hash{1}, no_hash{2}, 3);
+		CHECK(g.fingerprint().nodes == 2);
+		CHECK(g.fingerprint().edges == 1);
+		CHECK(g.fingerprint() == rebuilt(g).fingerprint());
+		CHECK((g == rebuilt(g)));
+	}
+}
@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <vector>
 
 TEST_CASE("Insert node") {
 	auto g = gdwg::graph<int, std::string>{1};
@@ -74,6 +75,59 @@ TEST_CASE("Insert edge") {
 	}
 }
 
+TEST_CASE("Insert nodes in bulk") {
+	auto g = gdwg::graph<int, std::string>{5, 1};
+
+	SECTION("New values go in once, existing ones are skipped") {
+		auto const values = std::vector<int>{9, 1, 3, 9, -2, 5, 7};
+		CHECK(g.insert_nodes(values.begin(), values.end()) == 4);
+		CHECK(g.nodes() == std::vector<int>{-2, 1, 3, 5, 7, 9});
+		CHECK(g.insert_nodes(values.begin(), values.end()) == 0);
+	}
+
+	SECTION("A small batch into a large graph") {
+		for (auto i = 100; i < 400; i += 2) {
+			g.insert_node(i);
+		}
+		auto const values = std::vector<int>{201, 200, 399};
+		CHECK(g.insert_nodes(values.begin(), values.end()) == 2);
+		CHECK(g.is_node(201));
+		CHECK(g.is_node(399));
+	}
+}
+
+TEST_CASE("Insert edges in bulk") {
+	using edge = gdwg::graph<std::string, int>::value_type;
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+
+	SECTION("Matches inserting one by one") {
+		auto const edges =
+		   std::vector<edge>{{"c", "a", 2}, {"a", "b", 1}, {"a", "a", 3}, {"c", "a", 2}, {"b", "c", 0}};
+		CHECK(g.insert_edges(edges.begin(), edges.end()) == 3);
+
+		auto expected = gdwg::graph<std::string, int>{"a", "b", "c"};
+		for (auto const& e : edges) {
+			expected.insert_edge(e.from, e.to, e.weight);
+		}
+		CHECK(g == expected);
+	}
+
+	SECTION("Missing nodes throw before anything changes") {
+		auto const edges = std::vector<edge>{{"a", "c", 1}, {"a", "z", 1}};
+		CHECK_THROWS_AS(g.insert_edges(edges.begin(), edges.end()), std::runtime_error);
+		CHECK_FALSE(g.is_connected("a", "c"));
+	}
+
+	SECTION("Cycles still throw with a topological order") {
+		g.enable_topological_order();
+		auto const edges = std::vector<edge>{{"b", "c", 1}, {"c", "a", 1}};
+		CHECK_THROWS_AS(g.insert_edges(edges.begin(), edges.end()), std::runtime_error);
+		CHECK(g.is_connected("b", "c"));
+		CHECK_FALSE(g.is_connected("c", "a"));
+	}
+}
+
 TEST_CASE("Replace Node") {
 	auto g = gdwg::graph<std::string, int>{"Yoona", "Taeyeon", "Tzuyu"};
 
@@ -371,4 +425,53 @@ TEST_CASE("Clear") {
 		g.clear();
 		CHECK(g.empty());
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("Erase nodes in bulk") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 2);
+	g.insert_edge("c", "a", 3);
+	g.insert_edge("d", "d", 4);
+
+	SECTION("Matches erasing one by one") {
+		auto const values = std::vector<std::string>{"c", "z", "a", "c"};
+		CHECK(g.erase_nodes(values.begin(), values.end()) == 2);
+
+		auto expected = gdwg::graph<std::string, int>{"b", "d"};
+		expected.insert_edge("d", "d", 4);
+		CHECK(g == expected);
+	}
+
+	SECTION("Keeps a topological order") {
+		g.erase_edge("c", "a", 3);
+		g.erase_edge("d", "d", 4);
+		g.enable_topological_order();
+		auto const values = std::vector<std::string>{"b"};
+		CHECK(g.erase_nodes(values.begin(), values.end()) == 1);
+		CHECK(g.topological_order().size() == 3);
+		CHECK_NOTHROW(g.insert_edge("c", "a", 3));
+		CHECK_THROWS_AS(g.insert_edge("a", "c", 3), std::runtime_error);
+	}
+}
+
+TEST_CASE("Erase edges in bulk") {
+	using edge = gdwg::graph<std::string, int>::value_type;
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 2);
+	g.insert_edge("b", "c", 1);
+
+	SECTION("Matches erasing one by one") {
+		auto const edges = std::vector<edge>{{"a", "b", 2}, {"b", "c", 1}, {"a", "b", 2}, {"c", "a", 1}};
+		CHECK(g.erase_edges(edges.begin(), edges.end()) == 2);
+		CHECK(g.weights("a", "b") == std::vector<int>{1});
+		CHECK_FALSE(g.is_connected("b", "c"));
+	}
+
+	SECTION("Missing nodes throw before anything changes") {
+		auto const edges = std::vector<edge>{{"a", "b", 1}, {"a", "z", 1}};
+		CHECK_THROWS_AS(g.erase_edges(edges.begin(), edges.end()), std::runtime_error);
+		CHECK(g.weights("a", "b") == std::vector<int>{1, 2});
+	}
+}
@@ -1,6 +1,7 @@
 #include "gdwg/graph.hpp"
 
 #include <catch2/catch.hpp>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
 #include <set>
@@ -198,4 +199,33 @@ Yoona (
 		out << g_const;
 		CHECK(out.str() == expected_output);
 	}
-}
\ No newline at end of file
+
+	SECTION("Output larger than the write buffer") {
+		auto g = gdwg::graph<int, double>{};
+		for (auto i = 0; i < 3000; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 3000; ++i) {
+			for (auto j = 1; j <= i % 7; ++j) {
+				g.insert_edge(i, (i + j * 31) % 3000, j * 0.25);
+			}
+		}
+		auto reference = std::ostringstream{};
+		for (auto i = 0; i < 3000; ++i) {
+			reference << i << " (\n";
+			for (auto const& e : g) {
+				if (e.from == i) {
+					reference << "  " << e.to << " | " << e.weight << "\n";
+				}
+			}
+			reference << ")\n";
+		}
+
+		// Formatting state on the target stream doesn't leak into the output
+		auto out = std::ostringstream{};
+		out << std::hex << std::fixed;
+		out << g;
+		CHECK(out.str().size() > std::size_t{1} << 16U);
+		CHECK(out.str() == reference.str());
+	}
+}
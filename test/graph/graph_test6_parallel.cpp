@@ -0,0 +1,136 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("thread_pool::parallel_for") {
+	auto pool = gdwg::thread_pool(3);
+	CHECK(pool.size() == 3);
+
+	SECTION("Every index is visited exactly once") {
+		auto hits = std::vector<std::atomic<int>>(10000);
+		pool.parallel_for(0, hits.size(), 7, [&](std::size_t i) { ++hits[i]; });
+
+		CHECK(std::all_of(hits.begin(), hits.end(), [](auto const& h) { return h == 1; }));
+	}
+
+	SECTION("Empty range does nothing") {
+		auto calls = std::atomic<int>{0};
+		pool.parallel_for(5, 5, 1, [&](std::size_t) { ++calls; });
+		CHECK(calls == 0);
+	}
+
+	SECTION("Nested loops do not deadlock") {
+		auto total = std::atomic<int>{0};
+		pool.parallel_for(0, 16, 1, [&](std::size_t) {
+			pool.parallel_for(0, 16, 1, [&](std::size_t) { ++total; });
+		});
+		CHECK(total == 256);
+	}
+
+	SECTION("Exceptions are rethrown on the caller") {
+		CHECK_THROWS_AS(pool.parallel_for(0,
+		                                  1000,
+		                                  1,
+		                                  [](std::size_t i) {
+			                                  if (i == 500) {
+				                                  throw std::runtime_error("boom");
+			                                  }
+		                                  }),
+		                std::runtime_error);
+	}
+
+	SECTION("Zero workers runs on the caller") {
+		auto inline_pool = gdwg::thread_pool(0);
+		auto sum = std::size_t{0};
+		inline_pool.parallel_for(0, 100, 1, [&](std::size_t i) { sum += i; });
+		CHECK(sum == 4950);
+	}
+}
+
+TEST_CASE("parallel_for_each_node") {
+	auto pool = gdwg::thread_pool(3);
+
+	SECTION("Empty graph") {
+		auto const g = gdwg::graph<int, int>{};
+		auto calls = std::atomic<int>{0};
+		g.parallel_for_each_node([&](int) { ++calls; }, pool);
+		CHECK(calls == 0);
+	}
+
+	SECTION("Every node is visited exactly once") {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 2000; ++i) {
+			g.insert_node(i);
+		}
+
+		auto mutex = std::mutex();
+		auto seen = std::multiset<int>();
+		g.parallel_for_each_node(
+		   [&](int const& n) {
+			   auto lock = std::scoped_lock(mutex);
+			   seen.insert(n);
+		   },
+		   pool);
+
+		CHECK(seen.size() == 2000);
+		CHECK(std::set<int>(seen.begin(), seen.end()).size() == 2000);
+	}
+}
+
+TEST_CASE("parallel_for_each_edge") {
+	auto pool = gdwg::thread_pool(3);
+
+	SECTION("Empty graph") {
+		auto const g = gdwg::graph<std::string, int>{"Yoona", "Tzuyu"};
+		auto calls = std::atomic<int>{0};
+		g.parallel_for_each_edge([&](auto const&, auto const&, int) { ++calls; }, pool);
+		CHECK(calls == 0);
+	}
+
+	SECTION("Every edge is visited exactly once") {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 300; ++i) {
+			g.insert_node(i);
+		}
+
+		// A hub node plus a sparse tail, so runs are very uneven
+		auto expected = std::multiset<std::tuple<int, int, int>>();
+		for (auto i = 0; i < 300; ++i) {
+			g.insert_edge(0, i, i);
+			expected.emplace(0, i, i);
+			g.insert_edge(i, (i * 7) % 300, 1);
+			expected.emplace(i, (i * 7) % 300, 1);
+		}
+
+		auto mutex = std::mutex();
+		auto seen = std::multiset<std::tuple<int, int, int>>();
+		g.parallel_for_each_edge(
+		   [&](int const& src, int const& dst, int const& weight) {
+			   auto lock = std::scoped_lock(mutex);
+			   seen.emplace(src, dst, weight);
+		   },
+		   pool);
+
+		CHECK(seen == expected);
+	}
+
+	SECTION("Works on the default pool") {
+		auto g = gdwg::graph<std::string, int>{"Yoona", "Tzuyu", "Taeyeon"};
+		g.insert_edge("Yoona", "Taeyeon", 818);
+		g.insert_edge("Yoona", "Yoona", 530);
+		g.insert_edge("Tzuyu", "Taeyeon", 1314);
+
+		auto total = std::atomic<int>{0};
+		g.parallel_for_each_edge([&](auto const&, auto const&, int w) { total += w; });
+		CHECK(total == 818 + 530 + 1314);
+	}
+}
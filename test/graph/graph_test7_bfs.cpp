@@ -0,0 +1,163 @@
+#include "gdwg/bfs.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// Reference BFS through the public accessors
+	auto naive_distances(gdwg::graph<int, int> const& g, int src) -> std::map<int, std::size_t> {
+		auto dist = std::map<int, std::size_t>{{src, 0}};
+		auto queue = std::deque<int>{src};
+		while (not queue.empty()) {
+			auto const u = queue.front();
+			queue.pop_front();
+			for (auto const v : g.connections(u)) {
+				if (dist.emplace(v, dist[u] + 1).second) {
+					queue.push_back(v);
+				}
+			}
+		}
+		return dist;
+	}
+
+	auto make_graph(int nodes, int degree) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < degree; ++d) {
+				g.insert_edge(i, (i * 37 + d * d * 11 + 5) % nodes, d);
+			}
+		}
+		return g;
+	}
+
+	auto check_against_naive(gdwg::graph<int, int> const& g,
+	                         gdwg::bfs_result<int> const& result,
+	                         int src) -> void {
+		auto const expected = naive_distances(g, src);
+		for (auto const n : g.nodes()) {
+			auto const it = expected.find(n);
+			if (it == expected.end()) {
+				CHECK(result.distance_to(n) == gdwg::bfs_result<int>::unreachable);
+				continue;
+			}
+			CHECK(result.distance_to(n) == it->second);
+
+			// Parents must form a shortest-path tree over real edges
+			if (n != src) {
+				auto const parent = result.nodes->at(result.parent[static_cast<std::size_t>(n)]);
+				CHECK(g.is_connected(parent, n));
+				CHECK(result.distance_to(parent) + 1 == it->second);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("csr_graph") {
+	auto g = gdwg::graph<std::string, int>{"Yoona", "Tzuyu", "Taeyeon", "Mina"};
+	g.insert_edge("Yoona", "Taeyeon", 818);
+	g.insert_edge("Yoona", "Yoona", 530);
+	g.insert_edge("Yoona", "Taeyeon", 17);
+	g.insert_edge("Tzuyu", "Taeyeon", 1314);
+
+	auto const csr = gdwg::csr_graph<std::string, int>(g, gdwg::adjacency::in_and_out);
+
+	SECTION("Nodes are numbered in ascending order") {
+		CHECK(csr.node_count() == 4);
+		CHECK(csr.edge_count() == 4);
+		CHECK(csr.node(0) == "Mina");
+		CHECK(csr.node(3) == "Yoona");
+		CHECK(csr.find("Tzuyu") == 2);
+		CHECK(csr.find("Jisoo") == gdwg::no_node);
+	}
+
+	SECTION("Out-edges follow edges_ order") {
+		auto const yoona = csr.find("Yoona");
+		auto const taeyeon = csr.find("Taeyeon");
+		REQUIRE(csr.out_degree(yoona) == 3);
+		CHECK(csr.targets(yoona)[0] == taeyeon);
+		CHECK(csr.weights(yoona)[0] == 17);
+		CHECK(csr.weights(yoona)[1] == 818);
+		CHECK(csr.targets(yoona)[2] == yoona);
+		CHECK(csr.out_degree(csr.find("Mina")) == 0);
+	}
+
+	SECTION("In-edges are sorted by source") {
+		auto const taeyeon = csr.find("Taeyeon");
+		REQUIRE(csr.in_degree(taeyeon) == 3);
+		CHECK(csr.sources(taeyeon)[0] == csr.find("Tzuyu"));
+		CHECK(csr.sources(taeyeon)[1] == csr.find("Yoona"));
+		CHECK(csr.in_weights(taeyeon)[1] == 17);
+	}
+}
+
+TEST_CASE("bfs") {
+	SECTION("Throws when src doesn't exist") {
+		auto const g = gdwg::graph<int, int>{1, 2};
+		CHECK_THROWS_AS(gdwg::bfs(g, 3), std::runtime_error);
+	}
+
+	SECTION("Distances, parents and paths") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("a", "c", 9);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("d", "a", 1);
+
+		auto const result = gdwg::bfs(g, std::string("a"));
+		CHECK(result.distance_to("a") == 0);
+		CHECK(result.distance_to("b") == 1);
+		CHECK(result.distance_to("c") == 1);
+		CHECK(result.distance_to("d") == 2);
+		CHECK(result.distance_to("e") == gdwg::bfs_result<std::string>::unreachable);
+		CHECK(result.path_to("d") == std::vector<std::string>{"a", "c", "d"});
+		CHECK(result.path_to("e").empty());
+		CHECK_THROWS_AS(result.distance_to("z"), std::runtime_error);
+	}
+
+	SECTION("Sequential top-down matches a naive BFS") {
+		auto const g = make_graph(500, 3);
+		auto const result = gdwg::bfs(g, 0, {.direction_optimizing = false});
+		CHECK(result.bottom_up_steps == 0);
+		check_against_naive(g, result, 0);
+	}
+
+	SECTION("Direction-optimizing switches to bottom-up") {
+		auto const g = make_graph(2000, 8);
+		auto const result = gdwg::bfs(g, 7, {.alpha = 1000.0, .beta = 2.0});
+		CHECK(result.bottom_up_steps > 0);
+		check_against_naive(g, result, 7);
+	}
+
+	SECTION("Parallel run on a frozen view") {
+		auto pool = gdwg::thread_pool(3);
+		auto const g = make_graph(3000, 6);
+		auto const csr = gdwg::csr_graph<int, int>(g, gdwg::adjacency::in_and_out);
+
+		auto const top_down = gdwg::bfs(csr, 11, {.pool = &pool, .direction_optimizing = false});
+		check_against_naive(g, top_down, 11);
+
+		auto const hybrid = gdwg::bfs(csr, 11, {.pool = &pool, .alpha = 1000.0, .beta = 2.0});
+		CHECK(hybrid.bottom_up_steps > 0);
+		CHECK(hybrid.distance == top_down.distance);
+	}
+
+	SECTION("A view without in-edges only runs top-down") {
+		auto const g = make_graph(200, 4);
+		auto const csr = gdwg::csr_graph<int, int>(g);
+		auto const result = gdwg::bfs(csr, 0, {.alpha = 1000.0});
+		CHECK(result.bottom_up_steps == 0);
+		check_against_naive(g, result, 0);
+	}
+}
@@ -0,0 +1,308 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/heap.hpp"
+#include "gdwg/shortest_paths.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Bellman-Ford through the public accessors
+	template<typename E>
+	auto naive_distances(gdwg::graph<int, E> const& g, int src) -> std::map<int, E> {
+		auto dist = std::map<int, E>{{src, E{}}};
+		for (auto round = std::size_t{0}; round < g.nodes().size(); ++round) {
+			for (auto const& [from, to, weight] : g) {
+				auto const it = dist.find(from);
+				if (it == dist.end()) {
+					continue;
+				}
+				auto const candidate = it->second + weight;
+				auto const [old, inserted] = dist.emplace(to, candidate);
+				if (not inserted and candidate < old->second) {
+					old->second = candidate;
+				}
+			}
+		}
+		return dist;
+	}
+
+	template<typename E>
+	auto make_graph(int nodes, int degree) -> gdwg::graph<int, E> {
+		auto g = gdwg::graph<int, E>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < degree; ++d) {
+				auto const dst = (i * 37 + d * d * 11 + 5) % nodes;
+				g.insert_edge(i, dst, static_cast<E>((i * 13 + d * 7) % 50 + 1));
+			}
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("Heaps") {
+	auto const keys = std::vector<std::int64_t>{5, 3, 9, 3, 0, 12, 7, 7, 1, 64, 2};
+	auto sorted = keys;
+	std::sort(sorted.begin(), sorted.end());
+
+	SECTION("d-ary heaps pop in key order") {
+		for (auto const arity : {2, 3, 4, 8}) {
+			auto heap = gdwg::dary_heap<std::int64_t, int>(static_cast<std::size_t>(arity));
+			for (auto const k : keys) {
+				heap.push(k, 0);
+			}
+			for (auto const k : sorted) {
+				CHECK(heap.pop().first == k);
+			}
+			CHECK(heap.empty());
+		}
+	}
+
+	SECTION("Radix heap pops in key order and rejects non-monotone keys") {
+		auto heap = gdwg::radix_heap<std::int64_t, int>();
+		for (auto const k : keys) {
+			heap.push(k, 0);
+		}
+		for (auto const k : sorted) {
+			CHECK(heap.pop().first == k);
+		}
+		CHECK(heap.empty());
+		CHECK_THROWS_AS(heap.push(10, 0), std::runtime_error);
+		CHECK_THROWS_AS(heap.push(-1, 0), std::runtime_error);
+	}
+}
+
+TEST_CASE("shortest_paths") {
+	SECTION("Throws when src doesn't exist") {
+		auto const g = gdwg::graph<int, int>{1, 2};
+		CHECK_THROWS_AS(gdwg::shortest_paths(g, 3), std::runtime_error);
+		CHECK_THROWS_AS(gdwg::shortest_path(g, 1, 3), std::runtime_error);
+	}
+
+	SECTION("Parallel edges use their minimum weight") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 10);
+		g.insert_edge("a", "b", 4);
+		g.insert_edge("a", "b", 7);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("a", "c", 6);
+
+		auto const result = gdwg::shortest_paths(g, std::string("a"));
+		CHECK(result.distance_to("b") == 4);
+		CHECK(result.distance_to("c") == 5);
+		CHECK(result.distance_to("d") == std::nullopt);
+		CHECK(result.path_to("c")->nodes == std::vector<std::string>{"a", "b", "c"});
+		CHECK_FALSE(result.path_to("d").has_value());
+	}
+
+	SECTION("Every heap agrees with Bellman-Ford") {
+		auto const g = make_graph<int>(400, 4);
+		auto const expected = naive_distances(g, 0);
+		auto const csr = gdwg::csr_graph<int, int>(g);
+
+		for (auto const heap : {gdwg::heap_kind::binary, gdwg::heap_kind::d_ary, gdwg::heap_kind::radix}) {
+			auto const result = gdwg::shortest_paths(csr, 0, {.heap = heap});
+			for (auto const n : g.nodes()) {
+				auto const it = expected.find(n);
+				CHECK(result.distance_to(n) == (it == expected.end() ? std::nullopt : std::optional(it->second)));
+			}
+		}
+	}
+
+	SECTION("Floating point weights") {
+		auto const g = make_graph<double>(200, 3);
+		auto const expected = naive_distances(g, 5);
+		auto const result = gdwg::shortest_paths(g, 5, {.heap = gdwg::heap_kind::d_ary, .arity = 8});
+		for (auto const& [n, d] : expected) {
+			CHECK(result.distance_to(n) == Approx(d));
+		}
+		CHECK_THROWS_AS(gdwg::shortest_paths(g, 5, {.heap = gdwg::heap_kind::radix}), std::runtime_error);
+	}
+
+	SECTION("Negative weights are rejected") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -3);
+		CHECK_THROWS_AS(gdwg::shortest_paths(g, 1), std::runtime_error);
+
+		// The negative edge leads into a node that is already settled
+		auto settled = gdwg::graph<std::string, int>{"s", "a", "b"};
+		settled.insert_edge("s", "a", 1);
+		settled.insert_edge("s", "b", 5);
+		settled.insert_edge("b", "a", -10);
+		auto const source = std::string("s");
+		for (auto const heap : {gdwg::heap_kind::binary, gdwg::heap_kind::d_ary, gdwg::heap_kind::radix}) {
+			CHECK_THROWS_AS(gdwg::shortest_paths(settled, source, {.heap = heap}), std::runtime_error);
+		}
+	}
+}
+
+TEST_CASE("shortest_path") {
+	auto const g = make_graph<int>(400, 4);
+	auto const csr = gdwg::csr_graph<int, int>(g);
+	auto const full = gdwg::shortest_paths(csr, 0);
+
+	SECTION("Stops early and matches the full tree") {
+		auto const path = gdwg::shortest_path(csr, 0, 42);
+		REQUIRE(path.has_value());
+		CHECK(path->weight == full.distance_to(42));
+		CHECK(path->nodes.front() == 0);
+		CHECK(path->nodes.back() == 42);
+		CHECK(path->settled <= full.settled);
+
+		// Path weight is the sum of its lightest edges
+		auto total = 0;
+		for (auto i = std::size_t{1}; i < path->nodes.size(); ++i) {
+			auto const w = g.weights(path->nodes[i - 1], path->nodes[i]);
+			total += *std::min_element(w.begin(), w.end());
+		}
+		CHECK(total == path->weight);
+	}
+
+	SECTION("Source to itself") {
+		auto const path = gdwg::shortest_path(g, 3, 3);
+		REQUIRE(path.has_value());
+		CHECK(path->weight == 0);
+		CHECK(path->nodes == std::vector<int>{3});
+	}
+
+	SECTION("Unreachable destination") {
+		auto h = gdwg::graph<int, int>{1, 2};
+		CHECK_FALSE(gdwg::shortest_path(h, 1, 2).has_value());
+	}
+}
+
+namespace {
+	using cell = std::pair<int, int>;
+
+	// side x side grid, every cell linked both ways to its neighbours with weights >= 1
+	auto make_grid(int side) -> gdwg::graph<cell, int> {
+		auto g = gdwg::graph<cell, int>{};
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				g.insert_node({r, c});
+			}
+		}
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				auto const w = (r * 7 + c * 3) % 5 + 1;
+				if (c + 1 < side) {
+					g.insert_edge({r, c}, {r, c + 1}, w);
+					g.insert_edge({r, c + 1}, {r, c}, w + 1);
+				}
+				if (r + 1 < side) {
+					g.insert_edge({r, c}, {r + 1, c}, w + 2);
+					g.insert_edge({r + 1, c}, {r, c}, w);
+				}
+			}
+		}
+		return g;
+	}
+
+	auto path_weight_of(gdwg::graph<cell, int> const& g, std::vector<cell> const& nodes) -> int {
+		auto total = 0;
+		for (auto i = std::size_t{1}; i < nodes.size(); ++i) {
+			auto const w = g.weights(nodes[i - 1], nodes[i]);
+			total += *std::min_element(w.begin(), w.end());
+		}
+		return total;
+	}
+} // namespace
+
+TEST_CASE("bidirectional_shortest_path") {
+	auto const g = make_grid(30);
+	auto const csr = gdwg::csr_graph<cell, int>(g, gdwg::adjacency::in_and_out);
+	auto const src = cell{2, 3};
+	auto const dst = cell{27, 25};
+
+	SECTION("Same weight as Dijkstra while settling fewer nodes") {
+		auto const expected = gdwg::shortest_path(csr, src, dst);
+		auto const path = gdwg::bidirectional_shortest_path(csr, src, dst);
+		REQUIRE(path.has_value());
+		CHECK(path->weight == expected->weight);
+		CHECK(path->nodes.front() == src);
+		CHECK(path->nodes.back() == dst);
+		CHECK(path_weight_of(g, path->nodes) == path->weight);
+		CHECK(path->settled < expected->settled);
+	}
+
+	SECTION("Every pair on a small graph") {
+		auto const small = make_graph<int>(60, 2);
+		auto const small_csr = gdwg::csr_graph<int, int>(small, gdwg::adjacency::in_and_out);
+		for (auto s = 0; s < 60; s += 7) {
+			auto const full = gdwg::shortest_paths(small_csr, s);
+			for (auto d = 0; d < 60; ++d) {
+				auto const path = gdwg::bidirectional_shortest_path(small_csr, s, d);
+				REQUIRE(path.has_value() == full.distance_to(d).has_value());
+				if (path) {
+					CHECK(path->weight == *full.distance_to(d));
+				}
+			}
+		}
+	}
+
+	SECTION("Trivial and unreachable queries") {
+		auto h = gdwg::graph<int, int>{1, 2};
+		CHECK(gdwg::bidirectional_shortest_path(h, 1, 1)->nodes == std::vector<int>{1});
+		CHECK_FALSE(gdwg::bidirectional_shortest_path(h, 1, 2).has_value());
+	}
+
+	SECTION("Needs in-edges") {
+		CHECK_THROWS_AS(gdwg::bidirectional_shortest_path(gdwg::csr_graph<cell, int>(g), src, dst),
+		                std::runtime_error);
+	}
+
+	SECTION("A negative edge into a settled node throws") {
+		// The forward side settles a, then scans b -> a before the two sides meet at c
+		auto settled = gdwg::graph<std::string, int>{"s", "a", "b", "c", "t"};
+		settled.insert_edge("s", "a", 1);
+		settled.insert_edge("s", "b", 5);
+		settled.insert_edge("b", "a", -10);
+		settled.insert_edge("b", "c", 100);
+		settled.insert_edge("c", "t", 100);
+		CHECK_THROWS_AS(gdwg::bidirectional_shortest_path(settled, std::string("s"), std::string("t")),
+		                std::runtime_error);
+	}
+}
+
+TEST_CASE("astar") {
+	auto const g = make_grid(30);
+	auto const src = cell{2, 3};
+	auto const dst = cell{27, 25};
+	auto const expected = gdwg::shortest_path(g, src, dst);
+
+	SECTION("Zero heuristic is plain Dijkstra") {
+		auto const path = gdwg::astar(g, src, dst, [](cell const&) { return 0; });
+		REQUIRE(path.has_value());
+		CHECK(path->weight == expected->weight);
+	}
+
+	SECTION("Manhattan distance settles fewer nodes") {
+		auto calls = 0;
+		auto const manhattan = [&](cell const& c) {
+			++calls;
+			return std::abs(c.first - dst.first) + std::abs(c.second - dst.second);
+		};
+		auto const path = gdwg::astar(g, src, dst, manhattan);
+		REQUIRE(path.has_value());
+		CHECK(path->weight == expected->weight);
+		CHECK(path_weight_of(g, path->nodes) == path->weight);
+		CHECK(path->settled < expected->settled);
+		CHECK(calls <= 900);
+	}
+
+	SECTION("Unreachable destination") {
+		auto h = gdwg::graph<int, int>{1, 2};
+		CHECK_FALSE(gdwg::astar(h, 1, 2, [](int) { return 0; }).has_value());
+	}
+}
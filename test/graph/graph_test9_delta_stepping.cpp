@@ -0,0 +1,131 @@
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/delta_stepping.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_paths.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	template<typename E>
+	auto make_graph(int nodes, int degree) -> gdwg::graph<int, E> {
+		auto g = gdwg::graph<int, E>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto d = 0; d < degree; ++d) {
+				auto const dst = (i * 37 + d * d * 11 + 5) % nodes;
+				// A mix of zero, light and heavy edges
+				g.insert_edge(i, dst, static_cast<E>((i * 13 + d * 7) % 97) / static_cast<E>(3));
+			}
+		}
+		return g;
+	}
+
+	template<typename E>
+	auto check_tree(gdwg::csr_graph<int, E> const& csr, gdwg::shortest_paths_result<int, E> const& result)
+	   -> void {
+		for (auto v = gdwg::node_id{0}; v < csr.node_count(); ++v) {
+			auto const u = result.parent[v];
+			if (u == gdwg::no_node) {
+				continue;
+			}
+
+			// The parent edge must be the lightest u -> v edge and account for the distance
+			auto best = std::optional<E>();
+			auto const targets = csr.targets(u);
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				if (targets[e] == v and not best) {
+					best = csr.weights(u)[e];
+				}
+			}
+			REQUIRE(best.has_value());
+			CHECK(*result.distance[u] + *best == *result.distance[v]);
+		}
+	}
+} // namespace
+
+TEST_CASE("delta_stepping") {
+	SECTION("Throws on a missing source, negative weights or negative delta") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		CHECK_THROWS_AS(gdwg::delta_stepping(g, 3), std::runtime_error);
+		CHECK_THROWS_AS(gdwg::delta_stepping(g, 1, {.delta = -1}), std::runtime_error);
+
+		g.insert_edge(1, 2, -3);
+		CHECK_THROWS_AS(gdwg::delta_stepping(g, 1), std::runtime_error);
+	}
+
+	SECTION("Small graph with parallel edges") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 10);
+		g.insert_edge("a", "b", 4);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("a", "c", 6);
+
+		auto const result = gdwg::delta_stepping(g, std::string("a"), {.delta = 2});
+		CHECK(result.distance_to("b") == 4);
+		CHECK(result.distance_to("c") == 5);
+		CHECK_FALSE(result.distance_to("d").has_value());
+		CHECK(result.path_to("c")->nodes == std::vector<std::string>{"a", "b", "c"});
+	}
+
+	auto pool = gdwg::thread_pool(3);
+
+	SECTION("Integer weights match Dijkstra for any delta") {
+		auto const csr = gdwg::csr_graph<int, int>(make_graph<int>(2000, 5));
+		auto const expected = gdwg::shortest_paths(csr, 0);
+
+		for (auto const delta : {0, 1, 4, 16, 1000}) {
+			auto const result = gdwg::delta_stepping(csr, 0, {.pool = &pool, .delta = delta});
+			CHECK(result.distance == expected.distance);
+			check_tree(csr, result);
+		}
+	}
+
+	SECTION("Floating point weights match Dijkstra exactly") {
+		auto const csr = gdwg::csr_graph<int, double>(make_graph<double>(2000, 5));
+		auto const expected = gdwg::shortest_paths(csr, 17);
+
+		for (auto const delta : {0.0, 0.5, 3.0, 40.0}) {
+			auto const sequential = gdwg::delta_stepping(csr, 17, {.delta = delta});
+			auto const parallel = gdwg::delta_stepping(csr, 17, {.pool = &pool, .delta = delta});
+			CHECK(sequential.distance == expected.distance);
+			CHECK(parallel.distance == expected.distance);
+			check_tree(csr, parallel);
+		}
+	}
+
+	SECTION("A delta far below the heaviest weight") {
+		// Around a billion buckets of width 1 between the lightest and heaviest edges
+		auto g = gdwg::graph<int, std::int64_t>{};
+		auto h = gdwg::graph<int, double>{};
+		for (auto i = 0; i < 500; ++i) {
+			g.insert_node(i);
+			h.insert_node(i);
+		}
+		for (auto i = 0; i < 500; ++i) {
+			for (auto d = 1; d <= 4; ++d) {
+				auto const dst = (i * 37 + d * d * 11) % 500;
+				auto const weight = (std::int64_t{i} * 7919 + d * 104729) * 2477 % 1000000000;
+				g.insert_edge(i, dst, weight);
+				h.insert_edge(i, dst, static_cast<double>(weight % 1000000) + 0.25);
+			}
+		}
+
+		auto const csr = gdwg::csr_graph<int, std::int64_t>(g);
+		auto const result = gdwg::delta_stepping(csr, 0, {.pool = &pool, .delta = std::int64_t{1}});
+		CHECK(result.distance == gdwg::shortest_paths(csr, 0).distance);
+		check_tree(csr, result);
+
+		auto const fine = gdwg::csr_graph<int, double>(h);
+		auto const fine_result = gdwg::delta_stepping(fine, 0, {.delta = 1e-3});
+		CHECK(fine_result.distance == gdwg::shortest_paths(fine, 0).distance);
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef GDWG_GRAPH_TEST_HELPERS_HPP
+#define GDWG_GRAPH_TEST_HELPERS_HPP
+
+#include <filesystem>
+#include <string>
+
+namespace gdwg::test {
+	/* The generator the tests draw their graphs from. A seed gives the same sequence on every
+	 * platform, so expected values can be pinned down. */
+	class lcg {
+	public:
+		explicit lcg(unsigned seed) noexcept
+		: state_{seed} {}
+
+		auto operator()() noexcept -> int {
+			state_ = (state_ * 1103515245U + 12345U) & 0x7fffffffU;
+			return static_cast<int>(state_);
+		}
+
+	private:
+		unsigned state_;
+	};
+
+	/* A file in the temporary directory, removed when it goes out of scope */
+	struct temporary_file {
+		explicit temporary_file(std::string const& name)
+		: path{(std::filesystem::temp_directory_path() / ("gdwg_" + name)).string()} {}
+
+		temporary_file(temporary_file const&) = delete;
+		auto operator=(temporary_file const&) -> temporary_file& = delete;
+
+		~temporary_file() {
+			std::filesystem::remove(path);
+		}
+
+		std::string path;
+	};
+
+	/* A directory in the temporary directory, emptied on creation and removed when it goes out
+	 * of scope */
+	struct temporary_directory {
+		explicit temporary_directory(std::string const& name)
+		: path{std::filesystem::temp_directory_path() / ("gdwg_" + name)} {
+			std::filesystem::remove_all(path);
+		}
+
+		temporary_directory(temporary_directory const&) = delete;
+		auto operator=(temporary_directory const&) -> temporary_directory& = delete;
+
+		~temporary_directory() {
+			std::filesystem::remove_all(path);
+		}
+
+		std::filesystem::path path;
+	};
+} // namespace gdwg::test
+
+#endif // GDWG_GRAPH_TEST_HELPERS_HPP